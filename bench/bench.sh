@@ -0,0 +1,189 @@
+#!/bin/bash
+# ********************************************************************************************* #
+# * Benchmark harness for bitanes2                                                            * #
+# * Author: André Bannwart Perina                                                             * #
+# ********************************************************************************************* #
+# * Copyright (c) 2017 André B. Perina                                                        * #
+# *                                                                                           * #
+# * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * #
+# * the GNU General Public License as published by the Free Software Foundation, either       * #
+# * version 3 of the License, or (at your option) any later version.                          * #
+# *                                                                                           * #
+# * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * #
+# * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * #
+# * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * #
+# *                                                                                           * #
+# * You should have received a copy of the GNU General Public License along with bitanes2.    * #
+# * If not, see <http://www.gnu.org/licenses/>.                                               * #
+# ********************************************************************************************* #
+#
+# Runs every selected backend (OPTLEVEL build) and engine (set of command line options) over a set
+# of graphs, with warmups and repetitions. Results (min, p10, median, p90 and max wall time of the
+# whole process) are written as JSON, one result per line, and compared against a stored baseline.
+# Outputs are checked against the .btw_orig reference next to each graph, when it exists.
+#
+# Exit status is 1 if any run exited with an error, any output check failed or any median
+# regressed beyond the threshold.
+
+usage() {
+	cat <<EOF
+Usage: $0 [OPTION]... GRAPH...
+Options:
+    -b BACKENDS   OPTLEVELs to build and run, separated by spaces (default: "2 3")
+    -e ENGINES    sets of extra bitanes2 options, separated by ';' (default: "", a single engine with
+                  no extra options)
+    -w N          number of warmup runs per graph (default: 1)
+    -r N          number of measured runs per graph (default: 5)
+    -o FILE       results file (default: bench/results.json)
+    -B FILE       baseline file to compare against (default: bench/baseline.json)
+    -T PCT        flag a regression if the median is more than PCT% slower than the baseline (default: 10)
+    -s            store the results as the new baseline
+EOF
+	exit 1
+}
+
+BENCHDIR=$(cd "$(dirname "$0")" && pwd)
+ROOTDIR=$(dirname "$BENCHDIR")
+BACKENDS="2 3"
+ENGINES=""
+WARMUPS=1
+REPS=5
+RESULTS="$BENCHDIR/results.json"
+BASELINE="$BENCHDIR/baseline.json"
+THRESHOLD=10
+SAVE=no
+
+while getopts "b:e:w:r:o:B:T:s" opt; do
+	case $opt in
+		b) BACKENDS=$OPTARG ;;
+		e) ENGINES=$OPTARG ;;
+		w) WARMUPS=$OPTARG ;;
+		r) REPS=$OPTARG ;;
+		o) RESULTS=$OPTARG ;;
+		B) BASELINE=$OPTARG ;;
+		T) THRESHOLD=$OPTARG ;;
+		s) SAVE=yes ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || usage
+[ "$REPS" -gt 0 ] || usage
+
+# Each graph is linked into a work folder, so that outputs are not written next to the dataset
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Current time in ms
+now() {
+	echo $(($(date +%s%N) / 1000000))
+}
+
+# Compare two result files numerically (the output is printed with limited precision)
+check() {
+	paste -d ' ' "$1" "$2" | awk '
+		NF != 2 { bad = 1; exit }
+		{ diff = $1 - $2; if(diff < 0) diff = -diff; ref = ($2 < 0)? -$2 : $2; if(diff > 2e-6 + 1e-9 * ref) { bad = 1; exit } }
+		END { exit bad }'
+}
+
+# Build every backend side by side
+for backend in $BACKENDS; do
+	echo "Building OPTLEVEL=$backend..." >&2
+	make -s -C "$ROOTDIR" OPTLEVEL="$backend" OBJDIR="bench/build/O$backend/obj" BINDIR="bench/build/O$backend/bin" "bench/build/O$backend/bin/bitanes2" >&2 || exit 1
+done
+
+IFS=';' read -r -a ENGINELIST <<< "$ENGINES"
+[ ${#ENGINELIST[@]} -gt 0 ] || ENGINELIST=("")
+
+status=0
+{
+	echo "{"
+	echo "\"config\": {\"host\": \"$(uname -n)\", \"date\": \"$(date -u +%Y-%m-%dT%H:%M:%SZ)\", \"warmups\": $WARMUPS, \"repetitions\": $REPS},"
+	echo "\"results\": ["
+} > "$RESULTS"
+first=yes
+
+for backend in $BACKENDS; do
+	binary="$ROOTDIR/bench/build/O$backend/bin/bitanes2"
+
+	for engine in "${ENGINELIST[@]}"; do
+		engineName=${engine:-default}
+
+		for graph in "$@"; do
+			name=$(basename "$graph" .net)
+			ln -sf "$(cd "$(dirname "$graph")" && pwd)/$(basename "$graph")" "$WORKDIR/$name.net"
+			read -r n m < <(head -n 2 "$graph" | tr '\n' ' ')
+
+			# A run that exits with an error fails the result, whatever its output
+			rm -f "$WORKDIR/$name.btw"
+			failed=no
+			for ((i = 0; i < WARMUPS; i++)); do
+				$binary $engine "$WORKDIR/$name.net" 2> /dev/null || failed=yes
+			done
+
+			times=""
+			for ((i = 0; i < REPS; i++)); do
+				start=$(now)
+				$binary $engine "$WORKDIR/$name.net" 2> /dev/null || failed=yes
+				times="$times $(($(now) - start))"
+			done
+
+			# Reference check
+			reference="${graph%.net}.btw_orig"
+			if [ $failed = yes ]; then
+				result="fail"
+				status=1
+			elif [ ! -f "$reference" ]; then
+				result="n/a"
+			elif check "$WORKDIR/$name.btw" "$reference"; then
+				result="ok"
+			else
+				result="fail"
+				status=1
+			fi
+
+			# Percentiles (nearest rank)
+			summary=$(echo $times | tr ' ' '\n' | sort -n | awk '
+				{ t[NR] = $1 }
+				function pct(p) { i = int(p * NR + 0.999999); return t[(i < 1)? 1 : i] }
+				END { printf "\"min_ms\": %d, \"p10_ms\": %d, \"median_ms\": %d, \"p90_ms\": %d, \"max_ms\": %d", t[1], pct(0.1), pct(0.5), pct(0.9), t[NR] }')
+
+			[ $first = yes ] || echo "," >> "$RESULTS"
+			first=no
+			printf '{"backend": "O%s", "engine": "%s", "graph": "%s", "n": %d, "m": %d, %s, "check": "%s"}' "$backend" "$engineName" "$name" "$n" "$m" "$summary" "$result" >> "$RESULTS"
+			echo "O$backend [$engineName] $name: $summary, check: $result" >&2
+		done
+	done
+done
+
+printf '\n]\n}\n' >> "$RESULTS"
+echo "Results written to $RESULTS" >&2
+
+# Compare against baseline: medians are matched by backend, engine and graph
+if [ $SAVE = yes ]; then
+	cp "$RESULTS" "$BASELINE"
+	echo "Baseline stored in $BASELINE" >&2
+elif [ -f "$BASELINE" ]; then
+	awk -v threshold="$THRESHOLD" '
+		function field(line, key,    re) {
+			re = "\"" key "\": \"?[^,\"}]*"
+			if(!match(line, re)) return ""
+			line = substr(line, RSTART, RLENGTH)
+			sub(/^"[^"]*": "?/, "", line)
+			return line
+		}
+		/"backend"/ {
+			key = field($0, "backend") " [" field($0, "engine") "] " field($0, "graph")
+			if(FNR == NR) { base[key] = field($0, "median_ms"); next }
+			if(!(key in base)) next
+			cur = field($0, "median_ms")
+			if((base[key] > 0) && (cur > base[key] * (1 + threshold / 100))) {
+				printf "REGRESSION %s: %d ms -> %d ms (+%.1f%%)\n", key, base[key], cur, 100 * (cur - base[key]) / base[key]
+				bad = 1
+			}
+		}
+		END { exit bad }' "$BASELINE" "$RESULTS" >&2 || status=1
+fi
+
+exit $status
@@ -0,0 +1,133 @@
+#!/bin/bash
+# ********************************************************************************************* #
+# * Accuracy per unit time of pivot-based betweenness estimates of bitanes2                   * #
+# * Author: André Bannwart Perina                                                             * #
+# ********************************************************************************************* #
+# * Copyright (c) 2017 André B. Perina                                                        * #
+# *                                                                                           * #
+# * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * #
+# * the GNU General Public License as published by the Free Software Foundation, either       * #
+# * version 3 of the License, or (at your option) any later version.                          * #
+# *                                                                                           * #
+# * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * #
+# * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * #
+# * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * #
+# *                                                                                           * #
+# * You should have received a copy of the GNU General Public License along with bitanes2.    * #
+# * If not, see <http://www.gnu.org/licenses/>.                                               * #
+# ********************************************************************************************* #
+#
+# Builds a backend (OPTLEVEL), computes the exact betweenness of each graph, then estimates it with every selected
+# number of pivots, pivot strategy and scaling (--pivots, --pivot-strategy and --pivot-scaling), with a few seeds each.
+# For each estimate, the relative error (sum of absolute errors over the sum of exact betweenness) and the compute
+# time (preprocess, forward and backward phases, as given by --stats) are averaged over the seeds and reported, with
+# the exact compute time for reference.
+#
+# Exit status is 1 if any run failed.
+
+usage() {
+	cat <<EOF
+Usage: $0 [OPTION]... GRAPH...
+Options:
+    -b BACKEND    OPTLEVEL to build and run (default: 4)
+    -k COUNTS     numbers of pivots, separated by spaces (default: "16 64 256")
+    -s STRATEGIES pivot strategies, separated by spaces (default: "uniform degree maxmin")
+    -l SCALINGS   pivot scalings, separated by spaces (default: "linear none")
+    -r RUNS       seeds averaged for each estimate (default: 3)
+    -e OPTIONS    extra bitanes2 options, given to every run (default: none)
+EOF
+	exit 1
+}
+
+BENCHDIR=$(cd "$(dirname "$0")" && pwd)
+ROOTDIR=$(dirname "$BENCHDIR")
+BACKEND=4
+COUNTS="16 64 256"
+STRATEGIES="uniform degree maxmin"
+SCALINGS="linear none"
+RUNS=3
+OPTIONS=""
+
+while getopts "b:k:s:l:r:e:" opt; do
+	case $opt in
+		b) BACKEND=$OPTARG ;;
+		k) COUNTS=$OPTARG ;;
+		s) STRATEGIES=$OPTARG ;;
+		l) SCALINGS=$OPTARG ;;
+		r) RUNS=$OPTARG ;;
+		e) OPTIONS=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || usage
+[ "$RUNS" -gt 0 ] 2> /dev/null || usage
+
+# Each graph is linked into a work folder, so that outputs are not written next to the dataset
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+echo "Building OPTLEVEL=$BACKEND..." >&2
+make -s -C "$ROOTDIR" OPTLEVEL="$BACKEND" OBJDIR="bench/build/O$BACKEND/obj" BINDIR="bench/build/O$BACKEND/bin" "bench/build/O$BACKEND/bin/bitanes2" >&2 || exit 1
+binary="$ROOTDIR/bench/build/O$BACKEND/bin/bitanes2"
+
+# Compute time of a run, in ms, from its statistics
+computeTime() {
+	awk '/^Time \((preprocess|forward|backward)\):/ { sum += $3 } END { printf "%.3f\n", sum }' "$1"
+}
+
+# Relative error of the second result file against the first one
+relError() {
+	paste -d ' ' "$1" "$2" | awk '
+		NF != 2 { bad = 1; exit }
+		{
+			diff = $2 - $1; if(diff < 0) diff = -diff
+			errSum += diff; refSum += ($1 < 0)? -$1 : $1
+		}
+		END { if(bad) exit 1; printf "%.3e\n", (refSum > 0)? errSum / refSum : errSum }'
+}
+
+status=0
+
+for graph in "$@"; do
+	name=$(basename "$graph" .net)
+	ln -sf "$(cd "$(dirname "$graph")" && pwd)/$(basename "$graph")" "$WORKDIR/$name.net"
+
+	if ! "$binary" $OPTIONS -s -p 17 "$WORKDIR/$name.net" 2> "$WORKDIR/stats"; then
+		echo "O$BACKEND $name: exact run failed" >&2
+		status=1
+		continue
+	fi
+	mv "$WORKDIR/$name.btw" "$WORKDIR/$name.exact"
+	echo "O$BACKEND $name: exact in $(computeTime "$WORKDIR/stats") ms"
+
+	for strategy in $STRATEGIES; do
+		for scaling in $SCALINGS; do
+			for count in $COUNTS; do
+				errors=""
+				times=""
+				for ((seed = 0; seed < RUNS; seed++)); do
+					if ! "$binary" $OPTIONS -s -p 17 --pivots "$count" --pivot-strategy "$strategy" --pivot-scaling "$scaling" --seed "$seed" "$WORKDIR/$name.net" 2> "$WORKDIR/stats"; then
+						echo "O$BACKEND $name: $strategy $scaling K=$count failed" >&2
+						status=1
+						continue 2
+					fi
+					if ! err=$(relError "$WORKDIR/$name.exact" "$WORKDIR/$name.btw"); then
+						echo "O$BACKEND $name: $strategy $scaling K=$count: results differ in size" >&2
+						status=1
+						continue 2
+					fi
+					errors="$errors $err"
+					times="$times $(computeTime "$WORKDIR/stats")"
+				done
+
+				echo "$errors" "$times" | awk -v runs="$RUNS" -v head="O$BACKEND $name: $strategy $scaling K=$count" '{
+					for(i = 1; i <= runs; i++) { err += $i; time += $(runs + i) }
+					printf "%s: relative error %.3e, %.3f ms\n", head, err / runs, time / runs
+				}'
+			done
+		done
+	done
+done
+
+exit $status
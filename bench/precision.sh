@@ -0,0 +1,120 @@
+#!/bin/bash
+# ********************************************************************************************* #
+# * Precision check of reduced-precision builds of bitanes2                                   * #
+# * Author: André Bannwart Perina                                                             * #
+# ********************************************************************************************* #
+# * Copyright (c) 2017 André B. Perina                                                        * #
+# *                                                                                           * #
+# * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * #
+# * the GNU General Public License as published by the Free Software Foundation, either       * #
+# * version 3 of the License, or (at your option) any later version.                          * #
+# *                                                                                           * #
+# * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * #
+# * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * #
+# * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * #
+# *                                                                                           * #
+# * You should have received a copy of the GNU General Public License along with bitanes2.    * #
+# * If not, see <http://www.gnu.org/licenses/>.                                               * #
+# ********************************************************************************************* #
+#
+# Builds every selected backend (OPTLEVEL) twice, with full and reduced precision (PRECISION=reduced),
+# runs both over a set of graphs and reports the maximum relative error of betweenness of the reduced
+# build against the full one, for each graph and overall. Results are printed with 17 digits, so that
+# the comparison is not limited by the output precision.
+#
+# Exit status is 1 if any run failed or any error is beyond the tolerance.
+
+usage() {
+	cat <<EOF
+Usage: $0 [OPTION]... GRAPH...
+Options:
+    -b BACKENDS   OPTLEVELs to build and run, separated by spaces (default: "3 4")
+    -e OPTIONS    extra bitanes2 options, given to both builds (default: none)
+    -T TOL        fail if a relative error is beyond TOL (default: 1e-5)
+EOF
+	exit 1
+}
+
+BENCHDIR=$(cd "$(dirname "$0")" && pwd)
+ROOTDIR=$(dirname "$BENCHDIR")
+BACKENDS="3 4"
+OPTIONS=""
+TOLERANCE=1e-5
+
+while getopts "b:e:T:" opt; do
+	case $opt in
+		b) BACKENDS=$OPTARG ;;
+		e) OPTIONS=$OPTARG ;;
+		T) TOLERANCE=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+[ $# -gt 0 ] || usage
+
+# Each graph is linked into a work folder, so that outputs are not written next to the dataset
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Maximum relative error of the second result file against the first one (nodes with zero betweenness must stay
+# zero: their absolute error is taken instead), and the node where it happens
+maxError() {
+	paste -d ' ' "$1" "$2" | awk '
+		NF != 2 { bad = 1; exit }
+		{
+			diff = $2 - $1; if(diff < 0) diff = -diff
+			ref = ($1 < 0)? -$1 : $1
+			err = (ref > 0)? diff / ref : diff
+			if(err > max) { max = err; node = NR - 1 }
+		}
+		END { if(bad) exit 1; printf "%.3e %d\n", max, node }'
+}
+
+# Build every backend side by side, in both precisions
+for backend in $BACKENDS; do
+	for precision in full reduced; do
+		echo "Building OPTLEVEL=$backend PRECISION=$precision..." >&2
+		make -s -C "$ROOTDIR" OPTLEVEL="$backend" PRECISION="$precision" OBJDIR="bench/build/O$backend-$precision/obj" BINDIR="bench/build/O$backend-$precision/bin" "bench/build/O$backend-$precision/bin/bitanes2" >&2 || exit 1
+	done
+done
+
+status=0
+
+for backend in $BACKENDS; do
+	worst=0
+	worstGraph=""
+
+	for graph in "$@"; do
+		name=$(basename "$graph" .net)
+		ln -sf "$(cd "$(dirname "$graph")" && pwd)/$(basename "$graph")" "$WORKDIR/$name.net"
+
+		for precision in full reduced; do
+			if ! "$ROOTDIR/bench/build/O$backend-$precision/bin/bitanes2" $OPTIONS -p 17 "$WORKDIR/$name.net" 2> /dev/null; then
+				echo "O$backend $name: $precision build failed" >&2
+				status=1
+				continue 2
+			fi
+			mv "$WORKDIR/$name.btw" "$WORKDIR/$name.$precision"
+		done
+
+		if ! read -r err node < <(maxError "$WORKDIR/$name.full" "$WORKDIR/$name.reduced"); then
+			echo "O$backend $name: results differ in size" >&2
+			status=1
+			continue
+		fi
+
+		echo "O$backend $name: max relative error $err (node $node)"
+		if awk -v a="$err" -v b="$worst" 'BEGIN { exit !(a > b) }'; then
+			worst=$err
+			worstGraph=$name
+		fi
+		if awk -v a="$err" -v b="$TOLERANCE" 'BEGIN { exit !(a > b) }'; then
+			echo "O$backend $name: beyond tolerance $TOLERANCE" >&2
+			status=1
+		fi
+	done
+
+	echo "O$backend: max relative error $worst${worstGraph:+ ($worstGraph)} over $# graph(s)"
+done
+
+exit $status
@@ -0,0 +1,108 @@
+/* ********************************************************************************************* */
+/* * Simple NUMA topology, thread pinning and page placement: libaffinity                      * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libaffinity is free software: you can redistribute it and/or modify it under the terms of * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libaffinity is distributed in the hope that it will be useful, but WITHOUT ANY            * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libaffinity. * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <stddef.h>
+
+/* Thread placement policies */
+/* Threads are not pinned */
+#define AFFINITY_NONE 0
+/* Threads fill all CPUs of a node before moving to the next node */
+#define AFFINITY_COMPACT 1
+/* Threads are spread over nodes in round-robin */
+#define AFFINITY_SCATTER 2
+
+/* Largest number of NUMA nodes handled */
+#define AFFINITY_MAX_NODES 64
+
+/* NUMA topology, as seen by this process (only CPUs it is allowed to run on) */
+typedef struct {
+	int policy;
+	unsigned int noOfNodes;
+	/* Node numbers, as given by the kernel */
+	int nodeIds[AFFINITY_MAX_NODES];
+	/* CPUs of each node, in ascending order */
+	int *cpus[AFFINITY_MAX_NODES];
+	unsigned int noOfCPUs[AFFINITY_MAX_NODES];
+	unsigned int totalCPUs;
+} affinity_t;
+
+/**
+ * @brief Read the NUMA topology from /sys/devices/system/node.
+ * @param affinity Pointer to an affinity_t structure.
+ * @param policy Thread placement policy (AFFINITY_NONE, AFFINITY_COMPACT or AFFINITY_SCATTER).
+ * @return 0 on success, -1 if the CPUs this process may run on could not be found.
+ * @note Without NUMA information (e.g. kernels without NUMA support), all allowed CPUs form a single node.
+ */
+int affinity_init(affinity_t *affinity, int policy);
+
+/**
+ * @brief Free the topology.
+ * @param affinity Pointer to an affinity_t structure.
+ */
+void affinity_destroy(affinity_t *affinity);
+
+/**
+ * @brief Pin the calling thread according to the placement policy.
+ * @param affinity Pointer to an affinity_t structure (may be NULL, then nothing is done).
+ * @param thread Index of the calling thread in its team (0, 1, ...).
+ * @return Index of the node the thread was pinned to (in affinity->nodeIds), or -1 if it was not pinned.
+ */
+int affinity_pin(affinity_t *affinity, unsigned int thread);
+
+/**
+ * @brief Let the calling thread run again on any CPU of the topology (undo affinity_pin).
+ * @param affinity Pointer to an affinity_t structure (may be NULL, then nothing is done).
+ */
+void affinity_unpin(affinity_t *affinity);
+
+/**
+ * @brief Run a function in a new thread pinned to all CPUs of a node, and wait for it.
+ * @param affinity Pointer to an affinity_t structure.
+ * @param node Index of the node (in affinity->nodeIds).
+ * @param func Function to be run.
+ * @param arg Argument of func.
+ * @return 0 on success, -1 if the thread could not be created.
+ * @note Memory first written by func is placed on this node by the kernel (first-touch policy).
+ */
+int affinity_runOnNode(affinity_t *affinity, unsigned int node, void *(*func)(void *), void *arg);
+
+/**
+ * @brief Spread the pages of a memory area over all nodes in round-robin, moving pages already placed.
+ * @param affinity Pointer to an affinity_t structure.
+ * @param addr Start of the area.
+ * @param size Size of the area, in bytes.
+ * @return 0 on success, -1 if the kernel refused (e.g. no NUMA support, or not allowed inside containers).
+ */
+int affinity_interleave(affinity_t *affinity, void *addr, size_t size);
+
+/**
+ * @brief Count the pages of a memory area placed on a node and elsewhere.
+ * @param affinity Pointer to an affinity_t structure.
+ * @param addr Start of the area.
+ * @param size Size of the area, in bytes.
+ * @param node Index of the node (in affinity->nodeIds) regarded as local.
+ * @param local Reference to a variable where the number of local pages is added.
+ * @param remote Reference to a variable where the number of remote pages is added.
+ * @return 0 on success, -1 if placement could not be queried. Pages not yet touched are not counted.
+ */
+int affinity_countPages(affinity_t *affinity, const void *addr, size_t size, unsigned int node, unsigned long long *local, unsigned long long *remote);
+
+#endif
@@ -0,0 +1,258 @@
+/* ********************************************************************************************* */
+/* * Simple implementation for Brandes Betweenness Algorithm: libbrandes                       * */
+/* * Author: André Bannwart Perina                                                             * */
+/* * Algorithm: Brandes, Ulrik. "A faster algorithm for betweenness centrality."               * */
+/* *            Journal of mathematical sociology 25.2 (2001): 163-177.                        * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libbrandes is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libbrandes is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libbrandes.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef BRANDES_H
+#define BRANDES_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "affinity.h"
+#include "graph.h"
+#include "list.h"
+#include "perfcnt.h"
+#include "stats.h"
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+#ifndef BRANDES_HUB_SZ
+/* Nodes with at least this many neighbours have their adjacency list split among threads (level-synchronous engine) */
+#define BRANDES_HUB_SZ 1024
+#endif
+#ifndef BRANDES_CHUNK_SZ
+/* Number of nodes of a level taken at once by a thread (level-synchronous engine) */
+#define BRANDES_CHUNK_SZ 64
+#endif
+#endif
+
+#ifndef BRANDES_BIDIR_MAX
+/* Sources of at most this many pairs (distinct targets) are searched pair by pair with a bidirectional BFS, the others
+   with a single BFS for all their targets (pair computations) */
+#define BRANDES_BIDIR_MAX 256
+#endif
+
+#if defined(BRANDES_USE_LEVEL_ORDER) && !defined(GRAPH_USE_GET_ADJACENTS)
+#error "BRANDES_USE_LEVEL_ORDER needs GRAPH_USE_GET_ADJACENTS"
+#endif
+
+#ifdef BRANDES_USE_REDUCED_PRECISION
+/* Shortest path counts: a double is exact up to 2^53 paths and only overflows beyond 1e308 */
+typedef double brandes_sigma_t;
+/* Dependencies of a single source: only betweenness itself is accumulated in double */
+typedef float brandes_delta_t;
+#else
+/* Shortest path counts (may overflow on graphs with more than INT_MAX shortest paths between two nodes) */
+typedef int brandes_sigma_t;
+/* Dependencies of a single source */
+typedef double brandes_delta_t;
+#endif
+
+/* How threads share the work of a betweenness computation */
+/* Threads process each source together, level by level (level-synchronous engine) */
+#define BRANDES_SCHEDULE_LEVELS 0
+/* Threads process different sources, taken from per-thread deques with work stealing (source scheduler) */
+#define BRANDES_SCHEDULE_SOURCES 1
+
+/* How brandes_selectPivots chooses sampled sources (pivots) */
+/* Uniformly at random, without replacement */
+#define BRANDES_PIVOTS_UNIFORM 0
+/* With a probability proportional to the degree, with replacement */
+#define BRANDES_PIVOTS_DEGREE 1
+/* First one at random, then each time the node farthest from all pivots so far (max-min distance) */
+#define BRANDES_PIVOTS_MAXMIN 2
+
+/* Working buffers of a betweenness computation, which may be reused across computations */
+typedef struct {
+	/* Number of nodes the buffers can hold */
+	unsigned int capacity;
+	/* Variables named according to the algorithm in Brandes Algorithm */
+	brandes_sigma_t *sigma;
+	int *d;
+	brandes_delta_t *delta;
+	list_t **P;
+	list_t *S;
+	list_t *Q;
+	/* Nodes whose dependency is needed when only some targets are computed: the targets (but the source) and the
+	   nodes below them in the DAG of the source */
+	bool *marked;
+#ifdef BRANDES_USE_LEVEL_ORDER
+	/* Reached nodes in BFS order (Q and S as a single array, P and the lists above are not used), offset of each
+	   level in it, and (1 + delta[w]) / sigma[w] of each node w whose dependency is complete */
+	int *order;
+	unsigned int *levelStart;
+	double *coef;
+#endif
+} brandes_work_t;
+
+/* Options of a betweenness computation */
+typedef struct {
+	/* Where the time of the preprocess, forward and backward phases and the BFS counters are accumulated (may be NULL) */
+	stats_t *stats;
+	/* Hardware counters enabled around the forward and backward phases (may be NULL), opened by the calling thread */
+	/* The other computing threads open their own and add their counts to these ones (see perfcnt_add) */
+	perfcnt_t *perfcnt;
+	/* Working buffers (may be NULL, then they are allocated and freed by each computation) */
+	brandes_work_t *work;
+	/* Sources to run from (NULL for all nodes). When set, betweenness is scaled by n / noOfSources, so that it
+	   estimates the exact value (source sampling, Brandes and Pich, 2007) */
+	unsigned int *sources;
+	unsigned int noOfSources;
+	/* Wall-clock time (as given by stats_now) after which no more sources are started (0 for no deadline). The
+	   result is then scaled by n / sources processed; sources should be a random permutation for it to be unbiased */
+	double deadline;
+	/* Array of n doubles to receive the standard error of each sampled estimate (may be NULL; 0 if exact) */
+	double *stdErr;
+	/* Where progress and estimated remaining time are reported, about once a second (may be NULL) */
+	FILE *progress;
+	/* Number of sources actually processed (set by brandes_compute) */
+	unsigned int noOfSourcesDone;
+	/* Arrays of n doubles to receive other centralities, computed in the same traversals (each may be NULL):
+	   closeness (Wasserman and Faust: r / (n - 1) * r / sum of distances, for the r other nodes reachable),
+	   harmonic (sum of inverse distances) and stress (number of shortest paths through each node) */
+	double *closeness;
+	double *harmonic;
+	double *stress;
+	/* Number of threads, sharing the work as given by schedule */
+	unsigned int noOfThreads;
+	/* BRANDES_SCHEDULE_LEVELS (default): threads split every BFS level among them, so memory does not grow with the
+	   number of threads; only when GRAPH_USE_GET_ADJACENTS is set, otherwise sources are scheduled instead.
+	   BRANDES_SCHEDULE_SOURCES: each thread processes whole sources, with its own buffers */
+	int schedule;
+	/* Whether threads of the source scheduler add to the results atomically, instead of keeping their own copies
+	   until the end (less memory, but contention on popular nodes) */
+	bool sharedAccumulators;
+	/* NUMA topology and thread placement policy of the level-synchronous engine (may be NULL, then threads are not
+	   pinned). Thread i is pinned by affinity_pin(affinity, i); the calling thread is thread 0 */
+	affinity_t *affinity;
+	/* Copy of the graph on each node (indexed as in affinity->nodeIds; may be NULL, or have NULL entries, then
+	   threads on that node use graph) */
+	graph_t **replicas;
+	/* Array of n flags, true for the nodes whose centralities are wanted (NULL for all nodes). Betweenness and stress
+	   of the other nodes are left incomplete; closeness and harmonic are computed for all nodes anyway */
+	bool *targets;
+	/* Array of n doubles, weight of the dependencies of each node when it is a source (NULL for 1), as given by
+	   brandes_selectPivots */
+	double *weights;
+	/* Whether the dependency of v on the pair (s, t) is scaled by d(s, v) / d(s, t) (linear scaling, Geisberger,
+	   Sanders and Schultes, 2008): with sampled sources, nodes near a source are no longer overestimated. The two
+	   ends of a pair add up to the exact dependency, so results are exact when all nodes are sources */
+	bool linearScaling;
+} brandes_opts_t;
+
+/**
+ * @brief Initialise options with default values (nothing is sampled).
+ * @param opts Pointer to a brandes_opts_t structure.
+ */
+void brandes_initOpts(brandes_opts_t *opts);
+
+/**
+ * @brief Initialise working buffers (empty).
+ * @param work Pointer to a brandes_work_t structure.
+ */
+void brandes_initWork(brandes_work_t *work);
+
+/**
+ * @brief Make sure that working buffers can hold a graph with n nodes.
+ * @param work Pointer to a brandes_work_t structure.
+ * @param n Number of nodes.
+ * @return 0 on success, -1 if memory could not be allocated (buffers keep their previous capacity).
+ * @note Buffers only grow (with some slack), so that graphs of similar size reuse them without allocating.
+ */
+int brandes_reserveWork(brandes_work_t *work, unsigned int n);
+
+/**
+ * @brief Free working buffers; they can be reserved again afterwards.
+ * @param work Pointer to a brandes_work_t structure.
+ */
+void brandes_freeWork(brandes_work_t *work);
+
+/**
+ * @brief Fill an array with a random permutation of all nodes (its first k elements are a uniform sample of k
+ *        sources without replacement).
+ * @param sources Array of n unsigned ints.
+ * @param n Number of nodes.
+ * @param seed Seed; the same seed always gives the same permutation.
+ */
+void brandes_permuteSources(unsigned int *sources, unsigned int n, unsigned long seed);
+
+/**
+ * @brief Choose sampled sources (pivots) of a betweenness estimate, and the weights that keep it unbiased.
+ * @param graph Pointer to a graph_t structure.
+ * @param sources Array of n unsigned ints, whose first elements (as many as returned) receive the pivots.
+ * @param weights Array of n doubles to receive the weight of each pivot (to be given as opts->weights).
+ * @param k Number of pivots wanted (at most n).
+ * @param strategy BRANDES_PIVOTS_UNIFORM, BRANDES_PIVOTS_DEGREE or BRANDES_PIVOTS_MAXMIN.
+ * @param seed Seed; the same seed always gives the same pivots.
+ * @return Number of distinct pivots, which may be less than k: nodes drawn more than once with
+ *         BRANDES_PIVOTS_DEGREE are listed once, with their weights added; BRANDES_PIVOTS_MAXMIN stops once every
+ *         node is a pivot.
+ * @note Uniform pivots have weight 1. Degree-proportional pivots have weight r / (n * k * p) per draw, p being their
+ *       probability and r the number of pivots returned, so that the estimate (scaled by n / r) stays unbiased
+ *       (Hansen-Hurwitz). Max-min pivots have weight 1: they spread over the graph, but the estimate is
+ *       biased. Max-min takes a BFS per pivot, the others O(n + m).
+ */
+unsigned int brandes_selectPivots(graph_t *graph, unsigned int *sources, double *weights, unsigned int k, int strategy, unsigned long seed);
+
+/**
+ * @brief Estimate the memory taken by brandes_compute besides the graph and the result arrays.
+ * @param n Number of nodes.
+ * @param m Number of edges (each undirected edge counted once).
+ * @param opts Pointer to a brandes_opts_t structure: the number of threads, schedule, shared accumulators and
+ *        centralities requested are taken into account.
+ * @return Estimated peak, in bytes. Working buffers are counted even if opts->work is set.
+ */
+unsigned long long brandes_estimateMemory(unsigned int n, unsigned int m, brandes_opts_t *opts);
+
+/**
+ * @brief Compute the betweenness centrality of all nodes of a graph.
+ * @param graph Pointer to a graph_t structure.
+ * @param cb Array of n doubles to receive the betweenness of each node.
+ * @param opts Pointer to a brandes_opts_t structure.
+ * @return 0 on success, -1 if memory could not be allocated (results are not valid in this case).
+ * @note Betweenness counts every unordered pair of nodes once. When fewer sources than nodes are processed (sampled
+ *       sources or a deadline), every centrality is an estimate extrapolated from the sources processed: sums are
+ *       scaled by n / opts->noOfSourcesDone, and halved for stress and (unless linear scaling is used) betweenness,
+ *       whose pairs are found from both ends. Dependencies of each source are first multiplied by its weight, if any.
+ * @note Sums are done in an order that depends on the build, the processor and, with more than one thread, on
+ *       scheduling: results may differ in the last digits from run to run and from build to build.
+ */
+int brandes_compute(graph_t *graph, double *cb, brandes_opts_t *opts);
+
+/**
+ * @brief Compute the betweenness of all nodes over a list of node pairs only: the betweenness of v is the sum, over
+ *        the pairs (s, t) listed, of the fraction of shortest paths between s and t that go through v (s and t
+ *        excluded). A pair listed twice counts twice; pairs of a node with itself are ignored.
+ * @param graph Pointer to a graph_t structure.
+ * @param pairs Array of 2 * noOfPairs node ids, where pairs[2 * i] and pairs[2 * i + 1] are the ends of pair i.
+ * @param noOfPairs Number of pairs.
+ * @param cb Array of n doubles to receive the betweenness of each node.
+ * @param opts Pointer to a brandes_opts_t structure: only stats, noOfThreads, affinity and replicas are used.
+ * @note Each pair is oriented from the end that is in more pairs, and pairs are grouped by this end. A group with at
+ *       most BRANDES_BIDIR_MAX targets is searched pair by pair with a bidirectional BFS, which expands a whole level
+ *       of the side with the smallest one at a time and stops as soon as both sides meet; the paths through each
+ *       node are then counted on the reached levels only. A larger group runs a single BFS that stops at the level
+ *       of its farthest target, followed by the usual backward phase, each target adding the number of its pairs to
+ *       the dependencies above it. Only the nodes reached are reset afterwards, so that the cost of a query follows
+ *       the part of the graph it reaches rather than its size.
+ * @note Threads take groups in turn, each with its own buffers and betweenness, summed at the end (O(n) memory per
+ *       thread).
+ */
+void brandes_computePairs(graph_t *graph, unsigned int *pairs, unsigned int noOfPairs, double *cb, brandes_opts_t *opts);
+
+#endif
@@ -0,0 +1,124 @@
+/* ********************************************************************************************* */
+/* * Simple content-addressed cache of betweenness results: libcache                          * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libcache is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libcache is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libcache.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/* Magic number of cache files ("BTWC" when read as bytes) */
+#define CACHE_MAGIC "BTWC"
+/* Version of the cache file format */
+#define CACHE_VERSION 2
+/* Default size limit of a cache folder (1 GiB) */
+#define CACHE_DEFAULT_MAX_SZ (1ull << 30)
+
+/* Header of cache files, followed by n doubles per column. Cache files are local, so all fields are in native byte order */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	/* Key of this entry */
+	uint64_t hash[2];
+	/* Number of nodes */
+	uint32_t n;
+	/* Number of columns (e.g. one per centrality) */
+	uint32_t noOfColumns;
+} cache_header_t;
+
+/* A cache folder */
+typedef struct {
+	char *dir;
+	/* Size limit of all entries together, in bytes */
+	unsigned long long maxSize;
+	/* Whether graphs are relabelled to a canonical node order before hashing */
+	bool canonicalize;
+	/* Size of all entries, in bytes (updated by cache_store; approximate if other processes share the folder) */
+	unsigned long long size;
+	/* Permissions of new entries (0644 minus the umask, as mkstemp creates files with 0600) */
+	mode_t mode;
+} cache_t;
+
+/* Key of a graph (and computation parameters) */
+typedef struct {
+	/* 128-bit hash of the normalised edge list and parameters */
+	uint64_t hash[2];
+	unsigned int n;
+	/* Canonical label of each node, or NULL if the graph is hashed with its own labels */
+	unsigned int *labels;
+} cache_key_t;
+
+/**
+ * @brief Initialise a cache. The folder is created if needed.
+ * @param cache Pointer to a cache_t structure.
+ * @param dir Cache folder. The string must remain valid while the cache is used.
+ * @param maxSize Size limit, in bytes. Least recently used entries are evicted when it is exceeded.
+ * @param canonicalize If true, nodes are relabelled to a canonical order before hashing (see cache_computeKey).
+ * @return 0 on success, -1 if the folder could not be created.
+ */
+int cache_init(cache_t *cache, char *dir, unsigned long long maxSize, bool canonicalize);
+
+/**
+ * @brief Compute the key of a graph.
+ * @param cache Pointer to a cache_t structure.
+ * @param key Pointer to a cache_key_t structure to be filled. Developer should free it with cache_freeKey.
+ * @param n Number of nodes.
+ * @param m Number of edges.
+ * @param edges Array with 2 * m node ids (same layout as in @f netio_read). It is not modified.
+ * @param params Text describing the computation parameters (e.g. metrics, sampling), part of the key.
+ * @note The edge list is normalised first: edge ends are ordered, self-loops and repeated edges are dropped and
+ *       edges are sorted, so that files that differ only in edge order or orientation share a key. When
+ *       canonicalisation is enabled, nodes are also relabelled by colour refinement (iterated hashing of the
+ *       neighbour colours, which does not depend on the original labels). If every node ends up with a distinct
+ *       colour, the graph has no symmetry, the relabelling is canonical and isomorphic files (e.g. with nodes
+ *       numbered in a different order) share a key; results are stored in canonical order and mapped back. Otherwise
+ *       the graph is hashed with its own labels, which is still correct but only hits for the same numbering.
+ */
+void cache_computeKey(cache_t *cache, cache_key_t *key, unsigned int n, unsigned int m, unsigned int *edges, const char *params);
+
+/**
+ * @brief Look up a result.
+ * @param cache Pointer to a cache_t structure.
+ * @param key Pointer to a key computed by cache_computeKey.
+ * @param columns Array of noOfColumns pointers, each one to an array of n doubles to receive a column of the
+ *        result, in the original node order.
+ * @param noOfColumns Number of columns.
+ * @return 0 on a hit (the entry is marked as recently used), -1 on a miss.
+ */
+int cache_lookup(cache_t *cache, cache_key_t *key, double **columns, unsigned int noOfColumns);
+
+/**
+ * @brief Store a result, then evict least recently used entries while the size limit is exceeded.
+ * @param cache Pointer to a cache_t structure.
+ * @param key Pointer to a key computed by cache_computeKey.
+ * @param columns Array of noOfColumns pointers, each one to an array of n doubles, in the original node order.
+ * @param noOfColumns Number of columns.
+ * @return 0 on success, -1 if the entry could not be written.
+ * @note Entries are written to a temporary file and renamed, so that concurrent readers and writers (threads or
+ *       processes) never see a partial entry. The same cache_t may be shared by several threads.
+ */
+int cache_store(cache_t *cache, cache_key_t *key, double **columns, unsigned int noOfColumns);
+
+/**
+ * @brief Free a key.
+ * @param key Pointer to a cache_key_t structure.
+ */
+void cache_freeKey(cache_key_t *key);
+
+#endif
@@ -0,0 +1,63 @@
+/* ********************************************************************************************* */
+/* * Ego network betweenness: libego                                                           * */
+/* * Author: André Bannwart Perina                                                             * */
+/* * Algorithm: Everett, Martin, and Stephen P. Borgatti. "Ego network betweenness."           * */
+/* *            Social networks 27.1 (2005): 31-38.                                            * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libego is free software: you can redistribute it and/or modify it under the terms of the  * */
+/* * GNU General Public License as published by the Free Software Foundation, either version 3 * */
+/* * of the License, or (at your option) any later version.                                    * */
+/* *                                                                                           * */
+/* * libego is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;       * */
+/* * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR          * */
+/* * PURPOSE.  See the GNU General Public License for more details.                            * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libego.      * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef EGO_H
+#define EGO_H
+
+#include "graph.h"
+#include "stats.h"
+
+#ifndef EGO_CHUNK_SZ
+/* Number of nodes taken at once by a thread */
+#define EGO_CHUNK_SZ 64
+#endif
+
+#ifndef EGO_BITSET_MAX
+/* Nodes of at most this degree are computed with bit sets (k^2 / 8 bytes for degree k), the others with sorted lists */
+#define EGO_BITSET_MAX 4096
+#endif
+
+/**
+ * @brief Compute the ego betweenness of all nodes: the betweenness of each node within its ego network (the node, its
+ *        neighbours and the edges among them). Every path in an ego network has at most two edges, so the ego
+ *        betweenness of v is the sum, over the pairs of neighbours a and b of v that are not adjacent, of 1 / (1 +
+ *        number of neighbours of v adjacent to both a and b).
+ * @param graph Pointer to a graph_t structure, built by graph_createFromEdges (adjacency lists are sorted).
+ * @param cb Array of n doubles to receive the ego betweenness of each node.
+ * @param noOfThreads Number of threads.
+ * @param stats Where the time of the computation (as the forward phase) and the number of adjacency entries read are
+ *        accumulated (may be NULL).
+ * @return 0 on success, -1 if no memory was left for the buffers of a thread (the result is then incomplete).
+ * @note For each node v of degree k, the neighbours of each neighbour a of v among those of v are found by intersecting
+ *       their sorted adjacency lists (merging them, or binary searching the longer one when it is much longer; with
+ *       GRAPH_USE_ADJ_MATRIX, by looking up each pair), and kept as a row of k bits. For each neighbour i, the union of
+ *       the rows of its own neighbours gives the neighbours j > i that share a neighbour with it: only their rows are
+ *       intersected with the row of i (one AND and one population count per 64 neighbours), every other j not
+ *       adjacent to i adds 1. Sparse ego networks thus cost about their number of edges times k / 64 words, dense
+ *       ones up to k^3 / 64.
+ * @note Nodes of degree above EGO_BITSET_MAX keep the indices of the neighbours of each neighbour as sorted lists
+ *       instead, and count common neighbours by walking the lists of the neighbours of i, so that memory follows the
+ *       number of edges of their ego network (k^2 with GRAPH_USE_ADJ_MATRIX) rather than k^2 / 8 bytes.
+ * @note Buffers of each thread are sized for the nodes it takes, and only grow when a larger one comes.
+ * @note Threads take chunks of EGO_CHUNK_SZ nodes, highest degrees first, so that hubs do not end up last.
+ */
+int ego_compute(graph_t *graph, double *cb, unsigned int noOfThreads, stats_t *stats);
+
+#endif
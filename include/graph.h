@@ -27,6 +27,11 @@ typedef struct {
 	/* Chunk size used for reallocating adjacency lists */
 	int chunkSz;
 #endif
+	/* Contiguous storage for the adjacency matrix, or for all adjacency lists when built by graph_createFromEdges
+	   (NULL otherwise) */
+	int *pool;
+	/* Number of ints in pool */
+	unsigned long poolSz;
 	/* Adjacency matrix or adjacency list */
 	int **adj;
 } graph_t;
@@ -36,9 +41,49 @@ typedef struct {
  * @param graph Pointer to a graph_t pointer.
  * @param n Number of nodes.
  * @param m Number of edges (used only when adjacency list is used).
+ * @note The adjacency matrix, the array of adjacency lists and the pool of graph_createFromEdges are allocated with
+ *       libhugemem, so that large graphs are backed by huge pages.
+ * @note *graph is set to NULL if memory could not be allocated.
  */
 void graph_create(graph_t **graph, unsigned int n, unsigned int m);
 
+/**
+ * @brief Create a graph from a whole edge list (two-pass builder).
+ * @param graph Pointer to a graph_t pointer.
+ * @param n Number of nodes.
+ * @param m Number of edges.
+ * @param edges Array with 2 * m node ids, where edges[2 * i] and edges[2 * i + 1] are the ends of edge i.
+ * @param noOfThreads Number of threads used to build the graph.
+ * @param noOfDuplicates Reference to a int variable where the number of dropped duplicate edges will be
+ *        assigned. May be NULL.
+ * @param noOfLoops Reference to a int variable where the number of dropped self-loops will be assigned.
+ *        May be NULL.
+ * @note Every edge is connected in both directions. Self-loops and repeated edges (in either direction) are
+ *       dropped. When adjacency list is used, a first pass counts the degrees, all lists are allocated at once
+ *       in a single contiguous block with their exact sizes and a second pass fills them. Each adjacency list
+ *       is then sorted in ascending order. All passes are split among noOfThreads threads.
+ * @return 0 on success, -1 if memory could not be allocated (*graph is set to NULL in this case).
+ */
+int graph_createFromEdges(graph_t **graph, unsigned int n, unsigned int m, unsigned int *edges, unsigned int noOfThreads, unsigned int *noOfDuplicates, unsigned int *noOfLoops);
+
+/**
+ * @brief Create a copy of a graph.
+ * @param clone Pointer to a graph_t pointer.
+ * @param graph Pointer to a graph_t structure to be copied.
+ * @note When adjacency list is used, all lists of the copy are allocated at once in a single contiguous block
+ *       (as in @f graph_createFromEdges) with their exact sizes. Memory of the copy is written by the calling
+ *       thread, so on NUMA systems it is placed on the node this thread runs on.
+ */
+void graph_clone(graph_t **clone, graph_t *graph);
+
+/**
+ * @brief Estimate the memory taken by a graph built by graph_createFromEdges.
+ * @param n Number of nodes.
+ * @param m Number of edges (each undirected edge counted once).
+ * @return Estimated size, in bytes (an upper bound when adjacency list is used: repeated edges are not dropped).
+ */
+unsigned long long graph_estimateMemory(unsigned int n, unsigned int m);
+
 /**
  * @brief Connect two nodes.
  * @param graph Pointer to a graph_t structure.
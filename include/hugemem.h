@@ -0,0 +1,81 @@
+/* ********************************************************************************************* */
+/* * Simple huge-page backed allocation: libhugemem                                            * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libhugemem is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libhugemem is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libhugemem.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef HUGEMEM_H
+#define HUGEMEM_H
+
+#include <stddef.h>
+
+/* Allocation policies */
+/* Plain heap allocation */
+#define HUGEMEM_NONE 0
+/* Transparent huge pages, requested with madvise */
+#define HUGEMEM_THP 1
+/* Explicit huge pages (hugetlbfs) while reserved ones are left, transparent huge pages otherwise */
+#define HUGEMEM_AUTO 2
+
+/* Size of a huge page: blocks at least this large are mapped on their own, aligned to it */
+#define HUGEMEM_PAGE_SZ (2ul << 20)
+/* Alignment of smaller blocks (a cache line) */
+#define HUGEMEM_ALIGN 64
+
+/**
+ * @brief Set the allocation policy of following allocations (HUGEMEM_AUTO by default).
+ * @param policy Allocation policy (HUGEMEM_NONE, HUGEMEM_THP or HUGEMEM_AUTO).
+ * @note Blocks already allocated keep their pages, and are freed the same way.
+ */
+void hugemem_setPolicy(int policy);
+
+/**
+ * @brief Allocate a block.
+ * @param size Size of the block, in bytes.
+ * @return Pointer to the block, aligned to HUGEMEM_PAGE_SZ if size is at least HUGEMEM_PAGE_SZ and to
+ *         HUGEMEM_ALIGN otherwise, or NULL if no memory is left.
+ * @note Blocks of at least HUGEMEM_PAGE_SZ bytes are mapped on their own, with huge pages if the policy and the
+ *       system allow it. If not, they fall back to transparent huge pages, then to regular pages. Smaller blocks
+ *       come from the heap. Physical pages are only taken when first written (and then on the NUMA node of the
+ *       thread writing them).
+ */
+void *hugemem_alloc(size_t size);
+
+/**
+ * @brief Allocate a block filled with zeros.
+ * @param nmemb Number of elements.
+ * @param size Size of each element, in bytes.
+ * @return Pointer to the block (aligned as in @f hugemem_alloc), or NULL if no memory is left.
+ * @note Blocks mapped on their own are zeroed by the kernel: their pages are not written here.
+ */
+void *hugemem_calloc(size_t nmemb, size_t size);
+
+/**
+ * @brief Free a block allocated by @f hugemem_alloc or @f hugemem_calloc.
+ * @param ptr Pointer to the block (may be NULL, then nothing is done).
+ */
+void hugemem_free(void *ptr);
+
+/**
+ * @brief Get how much of the memory of blocks mapped on their own is backed by huge pages.
+ * @param total Reference to a variable where the size of all blocks mapped on their own will be assigned.
+ * @param huge Reference to a variable where the size backed by huge pages will be assigned.
+ * @return 0 on success, -1 if transparent huge pages could not be queried (then only explicit ones are counted).
+ * @note Both sizes are in bytes and cover live blocks only. Transparent huge pages are read from
+ *       /proc/self/smaps, which takes some time on processes with many mappings.
+ */
+int hugemem_usage(unsigned long long *total, unsigned long long *huge);
+
+#endif
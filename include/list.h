@@ -21,28 +21,23 @@
 
 #include <stdbool.h>
 
-/* Different lists may hold different types of elements */
-typedef union {
-	int d;
-	double lf;
-	char *s;
-} elem_u;
-
-/* Structure of a list element: the value itself and pointer to next node */
-typedef struct elem_t {
-	elem_u val;
-	struct elem_t *next; 
-} elem_t;
+#ifdef LIST_USE_UNROLLED
+#ifndef LIST_UNROLL_SZ
+/* Number of values held by each node of an unrolled list (an integer node then fills a 64-byte cache line) */
+#define LIST_UNROLL_SZ 12
+#endif
+#endif
 
 /* Structure of a list */
 typedef struct {
 	unsigned int size;
-	/* Type of list: tells which part of the elem_u union to use */
+	/* Type of list: tells which kind of node the list holds */
 	unsigned int type;
 	/* Head and tail (may be deactivated) pointers. Tail pointer is useful in queues */
-	elem_t *head;
+	/* Nodes are specialised per element type (see src/list_tmpl.h), e.g. an integer node stores a plain int */
+	void *head;
 #ifndef LIST_DISABLE_TAIL
-	elem_t *tail;
+	void *tail;
 #endif
 } list_t;
 
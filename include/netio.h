@@ -0,0 +1,81 @@
+/* ********************************************************************************************* */
+/* * Simple library for reading and writing graph files: libnetio                              * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libnetio is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libnetio is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libnetio.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef NETIO_H
+#define NETIO_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Graph file formats */
+/* Text (.net): number of nodes, number of edges, then one "orig dest" pair per edge, all separated by whitespace */
+#define NETIO_FORMAT_TEXT 0
+/* Binary (.bnet): a netio_header_t followed by 2 * m little-endian uint32 node ids (orig, dest of each edge) */
+#define NETIO_FORMAT_BIN 1
+
+/* Magic number of binary files ("BNET" when read as bytes) */
+#define NETIO_MAGIC "BNET"
+/* Version of the binary format */
+#define NETIO_VERSION 1
+
+/* Header of binary files. All fields are little-endian */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	/* Number of nodes */
+	uint32_t n;
+	/* Number of edges */
+	uint32_t m;
+} netio_header_t;
+
+/**
+ * @brief Read a graph file (text or binary, detected by the magic number).
+ * @param file File to be read.
+ * @param n Reference to a variable where the number of nodes will be assigned.
+ * @param m Reference to a variable where the number of edges will be assigned.
+ * @param edges Reference to a pointer where a new array with 2 * m node ids will be assigned, where
+ *        (*edges)[2 * i] and (*edges)[2 * i + 1] are the ends of edge i. Developer should free it after use.
+ * @return 0 on success, -1 if the file is truncated, malformed or has edges connecting non-existent nodes
+ *         (nothing is allocated in this case).
+ */
+int netio_read(FILE *file, unsigned int *n, unsigned int *m, unsigned int **edges);
+
+/**
+ * @brief Read a list of node ids from a text file (whitespace-separated, until the end of the file).
+ * @param file File to be read.
+ * @param n Number of nodes of the graph the ids refer to.
+ * @param ids Reference to a pointer where a new array with the ids, in file order, will be assigned. Developer should
+ *        free it after use.
+ * @param count Reference to a variable where the number of ids will be assigned.
+ * @return 0 on success, -1 if the file is malformed or has ids of non-existent nodes (nothing is allocated in this
+ *         case).
+ */
+int netio_readIds(FILE *file, unsigned int n, unsigned int **ids, unsigned int *count);
+
+/**
+ * @brief Write a graph file.
+ * @param file File to be written.
+ * @param n Number of nodes.
+ * @param m Number of edges.
+ * @param edges Array with 2 * m node ids (same layout as in @f netio_read).
+ * @param format NETIO_FORMAT_TEXT or NETIO_FORMAT_BIN.
+ * @return 0 on success, -1 if writing failed.
+ */
+int netio_write(FILE *file, unsigned int n, unsigned int m, unsigned int *edges, int format);
+
+#endif
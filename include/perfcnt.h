@@ -0,0 +1,106 @@
+/* ********************************************************************************************* */
+/* * Simple library for hardware performance counters: libperfcnt                              * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libperfcnt is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libperfcnt is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libperfcnt.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef PERFCNT_H
+#define PERFCNT_H
+
+#include <stdio.h>
+
+/* Hardware events sampled */
+#define PERFCNT_EVENT_CYCLES 0
+#define PERFCNT_EVENT_INSTRUCTIONS 1
+#define PERFCNT_EVENT_LLC_MISSES 2
+#define PERFCNT_EVENT_BRANCH_MISSES 3
+#define PERFCNT_NO_OF_EVENTS 4
+
+/* Phases in which events are counted */
+#define PERFCNT_PHASE_FORWARD 0
+#define PERFCNT_PHASE_BACKWARD 1
+#define PERFCNT_NO_OF_PHASES 2
+
+/* Counters of a run */
+/* Each phase has its own group of events (Linux perf_event_open), enabled only while the phase runs */
+/* The kernel accumulates the counts, so that entering and leaving a phase costs a single ioctl each */
+/* Events count the thread that opened them only: other threads open their own and add them (see perfcnt_add) */
+typedef struct {
+	/* File descriptor of each event for each phase, -1 if the event is not available */
+	int fd[PERFCNT_NO_OF_PHASES][PERFCNT_NO_OF_EVENTS];
+	/* Counts added from the counters of other threads */
+	unsigned long long added[PERFCNT_NO_OF_PHASES][PERFCNT_NO_OF_EVENTS];
+	/* File descriptor of the group leader of each phase, -1 if no event is available */
+	int leader[PERFCNT_NO_OF_PHASES];
+	/* Number of events available */
+	int noOfAvailable;
+} perfcnt_t;
+
+/**
+ * @brief Open the hardware counters of the calling thread for all phases. All counters start disabled.
+ * @param perfcnt Pointer to a perfcnt_t structure.
+ * @return Number of events available. If 0, all other calls do nothing (e.g. counters are not accessible
+ *         inside a container, or perf_event_paranoid forbids them).
+ */
+int perfcnt_open(perfcnt_t *perfcnt);
+
+/**
+ * @brief Start counting for a phase.
+ * @param perfcnt Pointer to a perfcnt_t structure. May be NULL.
+ * @param phase Phase (PERFCNT_PHASE_FORWARD or PERFCNT_PHASE_BACKWARD).
+ */
+void perfcnt_start(perfcnt_t *perfcnt, int phase);
+
+/**
+ * @brief Stop counting for a phase.
+ * @param perfcnt Pointer to a perfcnt_t structure. May be NULL.
+ * @param phase Phase (PERFCNT_PHASE_FORWARD or PERFCNT_PHASE_BACKWARD).
+ */
+void perfcnt_stop(perfcnt_t *perfcnt, int phase);
+
+/**
+ * @brief Read the accumulated count of an event in a phase.
+ * @param perfcnt Pointer to a perfcnt_t structure.
+ * @param phase Phase (PERFCNT_PHASE_FORWARD or PERFCNT_PHASE_BACKWARD).
+ * @param event Event (PERFCNT_EVENT_*).
+ * @param count Reference to a variable where the count will be assigned. If the counters were multiplexed by the
+ *        kernel, the count is scaled by the fraction of time it actually ran. Counts added by @f perfcnt_add are
+ *        included.
+ * @return 0 on success, -1 if the event is not available.
+ */
+int perfcnt_read(perfcnt_t *perfcnt, int phase, int event, unsigned long long *count);
+
+/**
+ * @brief Add the counts of the counters of another thread to these ones.
+ * @param perfcnt Pointer to a perfcnt_t structure.
+ * @param other Pointer to the perfcnt_t structure of the other thread (still open). Events not available in
+ *        either structure are skipped.
+ */
+void perfcnt_add(perfcnt_t *perfcnt, perfcnt_t *other);
+
+/**
+ * @brief Print accumulated counters and IPC of each phase in human-readable form.
+ * @param file File to be written.
+ * @param perfcnt Pointer to a perfcnt_t structure.
+ */
+void perfcnt_print(FILE *file, perfcnt_t *perfcnt);
+
+/**
+ * @brief Close all counters.
+ * @param perfcnt Pointer to a perfcnt_t structure.
+ */
+void perfcnt_close(perfcnt_t *perfcnt);
+
+#endif
@@ -0,0 +1,51 @@
+/* ********************************************************************************************* */
+/* * Simple resident betweenness query server: libserver                                      * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libserver is free software: you can redistribute it and/or modify it under the terms of   * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libserver is distributed in the hope that it will be useful, but WITHOUT ANY              * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libserver.   * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+/*
+ * Protocol: clients connect to a Unix domain socket and send one request per line. Each request is answered by
+ * a line starting with "OK" or "ERR <message>"; some successful requests are followed by more lines, as told by
+ * the first one. The connection is closed when the client closes its side. Requests:
+ *
+ *   LOAD NAME FILE              load graph FILE (text or binary) as NAME and compute its exact betweenness
+ *                               -> OK NAME N M SECONDS
+ *   SCORE NAME V                betweenness of node V -> OK VALUE
+ *   TOP NAME K                  K nodes with highest betweenness -> OK COUNT, then COUNT lines "V VALUE"
+ *   RECOMPUTE NAME [S [SEED]]   recompute from S sampled sources (0 or missing for exact), estimating the
+ *                               exact betweenness -> OK NAME SECONDS
+ *   UNLOAD NAME                 free graph NAME -> OK
+ *   LIST                        loaded graphs -> OK COUNT, then COUNT lines "NAME N M SOURCES"
+ *   SHUTDOWN                    stop the server -> OK
+ */
+
+/* Maximum length of a request line */
+#define SERVER_MAX_LINE_SZ 4096
+
+/**
+ * @brief Listen on a Unix domain socket and answer requests until a SHUTDOWN request arrives.
+ * @param socketPath Path of the socket. A stale socket at this path is replaced; it is removed on exit.
+ * @param noOfThreads Number of threads used to build graphs and compute their betweenness.
+ * @param precision Precision of the values sent to clients (see writer_format).
+ * @return 0 on a clean shutdown, -1 if the socket could not be set up.
+ * @note Requests are served one at a time, in arrival order.
+ */
+int server_run(char *socketPath, unsigned int noOfThreads, int precision);
+
+#endif
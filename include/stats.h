@@ -0,0 +1,108 @@
+/* ********************************************************************************************* */
+/* * Simple library for run statistics: libstats                                               * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libstats is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libstats is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libstats.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+
+/* Phases of a run */
+#define STATS_PHASE_LOAD 0
+#define STATS_PHASE_PREPROCESS 1
+#define STATS_PHASE_FORWARD 2
+#define STATS_PHASE_BACKWARD 3
+#define STATS_PHASE_OUTPUT 4
+#define STATS_NO_OF_PHASES 5
+
+/* Largest number of threads whose busy and idle times are kept */
+#define STATS_MAX_THREADS 256
+
+/* Statistics of a run */
+typedef struct {
+	/* Number of nodes and edges of the graph */
+	unsigned int n;
+	unsigned int m;
+	/* Wall time spent in each phase, in seconds */
+	double phaseTime[STATS_NO_OF_PHASES];
+	/* Edges traversed by all BFSs (each undirected edge counts once per direction) */
+	unsigned long long edgesTraversed;
+	/* Nodes visited by all BFSs */
+	unsigned long long verticesVisited;
+	/* Largest BFS depth seen */
+	unsigned int maxDepth;
+	/* Peak resident set size, in KiB */
+	long peakRSS;
+	/* Pages of the graph and of the working buffers on the NUMA node of the thread using them, and elsewhere
+	   (summed over threads; both 0 when threads are not pinned) */
+	unsigned long long localPages;
+	unsigned long long remotePages;
+	/* Size of the large arrays (graph, working buffers and accumulators) mapped on their own by libhugemem, and how
+	   much of it was backed by huge pages, in bytes (taken when most of them were allocated) */
+	unsigned long long largeBytes;
+	unsigned long long hugeBytes;
+	/* Time each thread of the source scheduler spent processing sources and waiting for the others, in seconds
+	   (noOfThreads is 0 when the source scheduler was not used) */
+	unsigned int noOfThreads;
+	double busyTime[STATS_MAX_THREADS];
+	double idleTime[STATS_MAX_THREADS];
+	/* Number of times a thread of the source scheduler stole sources from another one */
+	unsigned long long noOfSteals;
+	/* Kernel of the level-ordered backward phase (scalar, avx2 or avx512; NULL when not used) */
+	const char *backwardKernel;
+} stats_t;
+
+/**
+ * @brief Get current wall time.
+ * @return Current time of a monotonic clock, in seconds.
+ */
+double stats_now(void);
+
+/**
+ * @brief Reset all statistics.
+ * @param stats Pointer to a stats_t structure.
+ */
+void stats_reset(stats_t *stats);
+
+/**
+ * @brief Sample the peak resident set size of this process into stats.
+ * @param stats Pointer to a stats_t structure.
+ */
+void stats_sampleRSS(stats_t *stats);
+
+/**
+ * @brief Get the traversed edges per second of the BFS phases (forward and backward).
+ * @param stats Pointer to a stats_t structure.
+ * @return TEPS, or 0 if no time was spent on BFS phases.
+ */
+double stats_getTEPS(stats_t *stats);
+
+/**
+ * @brief Print statistics in human-readable form.
+ * @param file File to be written.
+ * @param stats Pointer to a stats_t structure.
+ */
+void stats_print(FILE *file, stats_t *stats);
+
+/**
+ * @brief Print statistics as a JSON object.
+ * @param file File to be written.
+ * @param stats Pointer to a stats_t structure.
+ */
+void stats_printJSON(FILE *file, stats_t *stats);
+
+#endif
@@ -0,0 +1,87 @@
+/* ********************************************************************************************* */
+/* * Simple library for writing betweenness results: libwriter                                 * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libwriter is free software: you can redistribute it and/or modify it under the terms of   * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libwriter is distributed in the hope that it will be useful, but WITHOUT ANY              * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libwriter.   * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Output formats */
+/* Text: one line per node, columns separated by a space */
+#define WRITER_FORMAT_TEXT 0
+/* Binary: a writer_header_t followed by each column as a raw little-endian double array */
+#define WRITER_FORMAT_BIN 1
+
+/* Precision value for shortest round-trip text output (i.e. the shortest text that reads back to the same double) */
+#define WRITER_PRECISION_SHORTEST -1
+/* Default precision: same output as printf("%lf") */
+#define WRITER_PRECISION_DEFAULT 6
+/* Largest precision accepted */
+#define WRITER_PRECISION_MAX 17
+
+/* Size of a buffer able to hold any formatted value (largest double with WRITER_PRECISION_MAX digits) */
+#define WRITER_MAX_STR_SZ 352
+
+/* Magic number of binary files ("BTWB" when read as bytes) */
+#define WRITER_MAGIC "BTWB"
+/* Version of the binary format */
+#define WRITER_VERSION 1
+
+/* Header of binary files: 24 bytes, so that the double arrays that follow are 8-byte aligned */
+/* All fields are little-endian */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	/* Number of nodes (values per column) */
+	uint64_t n;
+	/* Number of columns */
+	uint32_t noOfColumns;
+	uint32_t reserved;
+} writer_header_t;
+
+/**
+ * @brief Format a double as fixed-point text.
+ * @param str Buffer to receive the text. It should have space for at least WRITER_MAX_STR_SZ chars.
+ * @param val Value to be formatted.
+ * @param precision Number of digits after the decimal point (up to WRITER_PRECISION_MAX), or
+ *        WRITER_PRECISION_SHORTEST.
+ * @return Number of chars written (no terminating null char is written).
+ * @note Fixed-point output is the same as printf("%.*f"). Values are formatted without printf whenever the
+ *       rounding can be decided from the scaled value, printf is used as fallback for very large values and
+ *       values close to a rounding tie.
+ * @note Shortest output has the fewest significant digits that read back to the same double (the closest such
+ *       value, Schubfach algorithm), without printf. It is written in fixed notation for decimal exponents from -4
+ *       to 16, and as %g does otherwise (e.g. 1.5e+17); integral values below 1e15 are written as integers.
+ */
+int writer_format(char *str, double val, int precision);
+
+/**
+ * @brief Write columns of values for n nodes to a file.
+ * @param file File to be written.
+ * @param columns Array of noOfColumns pointers, each one to an array of n doubles.
+ * @param noOfColumns Number of columns.
+ * @param n Number of nodes.
+ * @param format Output format (WRITER_FORMAT_TEXT or WRITER_FORMAT_BIN).
+ * @param precision Number of digits after the decimal point (up to WRITER_PRECISION_MAX), or
+ *        WRITER_PRECISION_SHORTEST. Ignored for binary.
+ * @return 0 on success, -1 if writing failed.
+ */
+int writer_write(FILE *file, double **columns, unsigned int noOfColumns, unsigned int n, int format, int precision);
+
+#endif
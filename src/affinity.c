@@ -0,0 +1,309 @@
+/* ********************************************************************************************* */
+/* * Simple NUMA topology, thread pinning and page placement: libaffinity                      * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libaffinity is free software: you can redistribute it and/or modify it under the terms of * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libaffinity is distributed in the hope that it will be useful, but WITHOUT ANY            * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libaffinity. * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#define _GNU_SOURCE
+
+#include "affinity.h"
+
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Pages queried per move_pages call */
+#define _AFFINITY_BATCH_SZ 1024
+
+/* Arguments of a thread run by affinity_runOnNode */
+typedef struct {
+	affinity_t *affinity;
+	unsigned int node;
+	void *(*func)(void *);
+	void *arg;
+} _affinity_runner_t;
+
+/**
+ * @brief Add the CPUs of a node that this process may run on.
+ * @param list CPU list, as in /sys (e.g. "0-3,8-11").
+ * @param allowed CPUs this process may run on.
+ * @return Number of CPUs added.
+ * @note This is an internal function.
+ */
+static unsigned int _affinity_addNode(affinity_t *affinity, int nodeId, char *list, cpu_set_t *allowed) {
+	unsigned int node = affinity->noOfNodes;
+	unsigned int capacity = 0;
+	char *ptr = list;
+	char *endPtr;
+	long lo, hi, cpu;
+
+	affinity->cpus[node] = NULL;
+	affinity->noOfCPUs[node] = 0;
+
+	while(*ptr && ('\n' != *ptr)) {
+		lo = strtol(ptr, &endPtr, 10);
+		if(endPtr == ptr)
+			break;
+		hi = lo;
+		if('-' == *endPtr) {
+			ptr = endPtr + 1;
+			hi = strtol(ptr, &endPtr, 10);
+		}
+		ptr = (',' == *endPtr)? (endPtr + 1) : endPtr;
+
+		for(cpu = lo; (cpu <= hi) && (cpu < CPU_SETSIZE); cpu++) {
+			if(!CPU_ISSET(cpu, allowed))
+				continue;
+			if(affinity->noOfCPUs[node] == capacity) {
+				capacity = capacity? (2 * capacity) : 16;
+				affinity->cpus[node] = realloc(affinity->cpus[node], capacity * sizeof(int));
+			}
+			affinity->cpus[node][affinity->noOfCPUs[node]++] = cpu;
+		}
+	}
+
+	/* Nodes without allowed CPUs (e.g. memory-only nodes) are of no use for pinning */
+	if(!(affinity->noOfCPUs[node])) {
+		free(affinity->cpus[node]);
+		affinity->cpus[node] = NULL;
+		return 0;
+	}
+
+	affinity->nodeIds[node] = nodeId;
+	affinity->noOfNodes++;
+	affinity->totalCPUs += affinity->noOfCPUs[node];
+
+	return affinity->noOfCPUs[node];
+}
+
+/**
+ * @brief Compare two node entries by node number, for qsort.
+ * @note This is an internal function.
+ */
+static int _affinity_compareInts(const void *a, const void *b) {
+	return *((const int *) a) - *((const int *) b);
+}
+
+/**
+ * @brief Read the NUMA topology from /sys/devices/system/node.
+ */
+int affinity_init(affinity_t *affinity, int policy) {
+	cpu_set_t allowed;
+	DIR *dir;
+	struct dirent *entry;
+	char path[64];
+	char list[4096];
+	char *endPtr;
+	FILE *file;
+	int nodeIds[AFFINITY_MAX_NODES];
+	unsigned int i, noOfNodeIds = 0;
+	long cpu;
+
+	memset(affinity, 0, sizeof(affinity_t));
+	affinity->policy = policy;
+
+	if(sched_getaffinity(0, sizeof(cpu_set_t), &allowed))
+		return -1;
+
+	/* Nodes are listed in ascending order, so that node indexes follow node numbers */
+	dir = opendir("/sys/devices/system/node");
+	if(dir) {
+		while((entry = readdir(dir)) && (noOfNodeIds < AFFINITY_MAX_NODES)) {
+			if(strncmp(entry->d_name, "node", 4))
+				continue;
+			nodeIds[noOfNodeIds] = strtol(&(entry->d_name[4]), &endPtr, 10);
+			if((endPtr != &(entry->d_name[4])) && !(*endPtr))
+				noOfNodeIds++;
+		}
+		closedir(dir);
+	}
+	qsort(nodeIds, noOfNodeIds, sizeof(int), _affinity_compareInts);
+
+	for(i = 0; i < noOfNodeIds; i++) {
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", nodeIds[i]);
+		file = fopen(path, "r");
+		if(!file)
+			continue;
+		if(fgets(list, sizeof(list), file))
+			_affinity_addNode(affinity, nodeIds[i], list, &allowed);
+		fclose(file);
+	}
+
+	/* No NUMA information: a single node with every allowed CPU */
+	if(!(affinity->noOfNodes)) {
+		affinity->nodeIds[0] = 0;
+		affinity->cpus[0] = malloc(CPU_COUNT(&allowed) * sizeof(int));
+		for(cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if(CPU_ISSET(cpu, &allowed))
+				affinity->cpus[0][affinity->noOfCPUs[0]++] = cpu;
+		}
+		affinity->totalCPUs = affinity->noOfCPUs[0];
+		affinity->noOfNodes = 1;
+	}
+
+	return affinity->totalCPUs? 0 : -1;
+}
+
+/**
+ * @brief Free the topology.
+ */
+void affinity_destroy(affinity_t *affinity) {
+	unsigned int i;
+
+	for(i = 0; i < affinity->noOfNodes; i++)
+		free(affinity->cpus[i]);
+
+	memset(affinity, 0, sizeof(affinity_t));
+}
+
+/**
+ * @brief Pin the calling thread according to the placement policy.
+ */
+int affinity_pin(affinity_t *affinity, unsigned int thread) {
+	cpu_set_t set;
+	unsigned int node, cpu;
+
+	if(!affinity || (AFFINITY_NONE == affinity->policy))
+		return -1;
+
+	if(AFFINITY_SCATTER == affinity->policy) {
+		node = thread % affinity->noOfNodes;
+		cpu = (thread / affinity->noOfNodes) % affinity->noOfCPUs[node];
+	}
+	else {
+		cpu = thread % affinity->totalCPUs;
+		for(node = 0; cpu >= affinity->noOfCPUs[node]; node++)
+			cpu -= affinity->noOfCPUs[node];
+	}
+
+	CPU_ZERO(&set);
+	CPU_SET(affinity->cpus[node][cpu], &set);
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set)? -1 : (int) node;
+}
+
+/**
+ * @brief Let the calling thread run again on any CPU of the topology (undo affinity_pin).
+ */
+void affinity_unpin(affinity_t *affinity) {
+	cpu_set_t set;
+	unsigned int i, j;
+
+	if(!affinity || (AFFINITY_NONE == affinity->policy))
+		return;
+
+	CPU_ZERO(&set);
+	for(i = 0; i < affinity->noOfNodes; i++) {
+		for(j = 0; j < affinity->noOfCPUs[i]; j++)
+			CPU_SET(affinity->cpus[i][j], &set);
+	}
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+}
+
+/**
+ * @brief Pin a thread to all CPUs of a node, then run the function of affinity_runOnNode.
+ * @note This is an internal function.
+ */
+static void *_affinity_runner(void *arg) {
+	_affinity_runner_t *runner = arg;
+	cpu_set_t set;
+	unsigned int i;
+
+	CPU_ZERO(&set);
+	for(i = 0; i < runner->affinity->noOfCPUs[runner->node]; i++)
+		CPU_SET(runner->affinity->cpus[runner->node][i], &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+
+	return runner->func(runner->arg);
+}
+
+/**
+ * @brief Run a function in a new thread pinned to all CPUs of a node, and wait for it.
+ */
+int affinity_runOnNode(affinity_t *affinity, unsigned int node, void *(*func)(void *), void *arg) {
+	pthread_t thread;
+	_affinity_runner_t runner = {affinity, node, func, arg};
+
+	if(pthread_create(&thread, NULL, _affinity_runner, &runner))
+		return -1;
+	pthread_join(thread, NULL);
+
+	return 0;
+}
+
+/**
+ * @brief Spread the pages of a memory area over all nodes in round-robin, moving pages already placed.
+ */
+int affinity_interleave(affinity_t *affinity, void *addr, size_t size) {
+	long pageSz = sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t) addr) & ~((uintptr_t) pageSz - 1);
+	unsigned long mask[(AFFINITY_MAX_NODES + 63) / 64 + 1];
+	unsigned int i;
+	int nodeId;
+
+	if(!size)
+		return 0;
+
+	memset(mask, 0, sizeof(mask));
+	for(i = 0; i < affinity->noOfNodes; i++) {
+		nodeId = affinity->nodeIds[i];
+		if(nodeId < AFFINITY_MAX_NODES)
+			mask[nodeId / (8 * sizeof(unsigned long))] |= 1ul << (nodeId % (8 * sizeof(unsigned long)));
+	}
+
+	/* Raw system call: libnuma is not needed for this */
+	return syscall(SYS_mbind, start, ((uintptr_t) addr) + size - start, MPOL_INTERLEAVE, mask, AFFINITY_MAX_NODES + 1, MPOL_MF_MOVE)? -1 : 0;
+}
+
+/**
+ * @brief Count the pages of a memory area placed on a node and elsewhere.
+ */
+int affinity_countPages(affinity_t *affinity, const void *addr, size_t size, unsigned int node, unsigned long long *local, unsigned long long *remote) {
+	long pageSz = sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t) addr) & ~((uintptr_t) pageSz - 1);
+	uintptr_t end = ((uintptr_t) addr) + size;
+	void *pages[_AFFINITY_BATCH_SZ];
+	int status[_AFFINITY_BATCH_SZ];
+	unsigned int i, noOfPages;
+
+	if(!size)
+		return 0;
+
+	while(start < end) {
+		for(noOfPages = 0; (noOfPages < _AFFINITY_BATCH_SZ) && (start < end); noOfPages++, start += pageSz)
+			pages[noOfPages] = (void *) start;
+
+		/* Without target nodes, move_pages only reports where each page is */
+		if(syscall(SYS_move_pages, 0, noOfPages, pages, NULL, status, 0))
+			return -1;
+
+		/* Negative status: page not present (never touched) */
+		for(i = 0; i < noOfPages; i++) {
+			if(status[i] == affinity->nodeIds[node])
+				(*local)++;
+			else if(status[i] >= 0)
+				(*remote)++;
+		}
+	}
+
+	return 0;
+}
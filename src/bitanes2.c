@@ -18,17 +18,121 @@
 /* * If not, see <http://www.gnu.org/licenses/>.                                               * */
 /* ********************************************************************************************* */
 
+#include <dirent.h>
 #include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "affinity.h"
+#include "brandes.h"
+#include "cache.h"
 #include "common/common.h"
+#include "ego.h"
 #include "graph.h"
-#include "list.h"
+#include "hugemem.h"
+#include "netio.h"
+#include "perfcnt.h"
+#include "server.h"
+#include "stats.h"
+#include "writer.h"
 
 #define MAX_STR_SZ 256
 
+/* Memory taken by the process itself (code, libraries, stdio buffers), when planning against --mem-limit */
+#define MEM_BASELINE (4ull << 20)
+
+/* Computation parameters, as part of cache keys (followed by the metrics) */
+#ifdef BRANDES_USE_REDUCED_PRECISION
+#define CACHE_PARAMS "brandes reduced"
+#else
+#define CACHE_PARAMS "brandes exact"
+#endif
+
+/* Metrics that can be written, one column each */
+#define METRIC_BTW 0
+#define METRIC_CLOSENESS 1
+#define METRIC_HARMONIC 2
+#define METRIC_STRESS 3
+#define NO_OF_METRICS 4
+char *metricNames[NO_OF_METRICS] = {"btw", "closeness", "harmonic", "stress"};
+
+/* Placement of the graph over NUMA nodes */
+#define NUMA_GRAPH_NONE 0
+#define NUMA_GRAPH_INTERLEAVE 1
+#define NUMA_GRAPH_REPLICATE 2
+
+/* Metrics requested, in output order */
+typedef struct {
+	int ids[NO_OF_METRICS];
+	unsigned int count;
+	/* Computation parameters for cache keys */
+	char cacheParams[MAX_STR_SZ];
+} metrics_t;
+
+#define USAGE_STR "Usage: %s [OPTION]... INPUTFILE\n"\
+	"  or:  %s [OPTION]... --batch LIST_OR_DIR\n"\
+	"  or:  %s [OPTION]... --serve SOCKET\n"\
+	"Options:\n"\
+	"    -t, --threads N      number of threads used to build and compute the graph, or to process graphs\n"\
+	"                         concurrently in batch mode (default: number of online CPUs)\n"\
+	"        --schedule S     how threads share the computation of a graph: levels (default; each source\n"\
+	"                         is processed by all threads, level by level, only with OPTLEVEL 2 and up) or\n"\
+	"                         sources (each thread processes whole sources, with work stealing)\n"\
+	"        --mem-limit B    fit the run into B bytes (suffixes K, M and G accepted): graph copies, per-thread\n"\
+	"                         state and threads are reduced as needed, and the run is refused before\n"\
+	"                         building the graph if the estimate does not fit\n"\
+	"        --batch L        process every graph listed in file L (one path per line), or every .net/.bnet\n"\
+	"                         file in folder L, writing each result next to its input\n"\
+	"        --prefetch N     in batch mode, number of graphs loaded ahead of computation, and of results\n"\
+	"                         waiting to be written (default 2)\n"\
+	"        --serve S        keep graphs and results in memory and answer requests on Unix socket S\n"\
+	"                         (see bitanes2-client)\n"\
+	"        --cache DIR      look up results in folder DIR before computing, and store new ones there\n"\
+	"        --cache-size B   size limit of the cache, in bytes (suffixes K, M and G accepted, default 1G);\n"\
+	"                         least recently used results are evicted beyond it\n"\
+	"        --canonical      relabel nodes canonically before hashing, so that the same graph with nodes\n"\
+	"                         numbered differently is found in the cache (if it has no symmetries)\n"\
+	"        --metrics M      comma-separated metrics to write, one column each, in the given order: btw\n"\
+	"                         (default), closeness, harmonic and stress, all computed in the same traversals\n"\
+	"        --deadline MS    stop starting new sources MS milliseconds after loading began and write an\n"\
+	"                         estimate from the sources done so far (taken in random order), with the\n"\
+	"                         standard error of betweenness as an extra last column\n"\
+	"        --seed N         seed of the source order used with --deadline, or of the pivots (default 0)\n"\
+	"        --pivots K       estimate betweenness from K sampled sources (pivots) only\n"\
+	"        --pivot-strategy S  how pivots are chosen: uniform (default), degree (proportional to the\n"\
+	"                         degree, with replacement) or maxmin (each one farthest from the previous ones)\n"\
+	"        --pivot-scaling S  linear (default; each pivot adds d(s, v) / d(s, t) of a pair (s, t) to v, so\n"\
+	"                         that nodes near pivots are not overestimated) or none\n"\
+	"        --vertices F     compute and write the metrics of the nodes listed in file F only (0-based ids\n"\
+	"                         separated by whitespace), one line each in the order given\n"\
+	"        --pairs F        compute betweenness over the node pairs listed in file F only (two 0-based\n"\
+	"                         ids each): sum over the pairs of the fraction of their shortest paths through\n"\
+	"                         each node\n"\
+	"        --ego            compute ego betweenness instead (betweenness of each node within the network\n"\
+	"                         of its neighbours), in linear time for bounded degrees\n"\
+	"        --progress       report progress and estimated remaining time to stderr about once a second\n"\
+	"        --affinity P     pin threads to CPUs: none (default), compact (fill a NUMA node before the\n"\
+	"                         next one) or scatter (round-robin over nodes)\n"\
+	"        --numa-graph G   place the graph over NUMA nodes: none (default), interleave (spread its\n"\
+	"                         pages over all nodes) or replicate (one copy per node, read by the threads\n"\
+	"                         pinned there; needs --affinity). Adjacency list builds only\n"\
+	"        --huge-pages P   back the graph, buffers and results with huge pages: auto (default; reserved\n"\
+	"                         hugetlbfs pages, else transparent ones), thp (transparent only) or none\n"\
+	"    -f, --format FMT     output format: text (default, .btw file) or bin (.btwb file: 24-byte header\n"\
+	"                         followed by a little-endian double array)\n"\
+	"    -p, --precision P    digits after the decimal point in text output (0 to 17, default 6), or\n"\
+	"                         shortest for the shortest text that reads back to the same value\n"\
+	"    -s, --stats          print phase times, BFS counters, peak RSS and TEPS to stderr\n"\
+	"        --stats-json F   write the same statistics as JSON to file F\n"\
+	"        --perf-counters  count cycles, instructions, LLC misses and branch misses of the forward and\n"\
+	"                         backward phases with hardware counters and print them (and IPC) to stderr\n"
+
 /**
  * @brief Swap the extension of a file (or add it if the file has none.
  * @param inputFilename The input filename.
@@ -61,10 +165,804 @@ char *swapOrAddExtension(char *inputFilename, char *extension) {
 	return outputFilename;
 }
 
+/**
+ * @brief Parse a size in bytes, with an optional K, M or G suffix (powers of 1024).
+ * @param str The string to be parsed.
+ * @param val Reference to a variable where the size will be assigned.
+ * @return 0 on success, -1 if the string is not a valid size.
+ */
+int parseSize(char *str, unsigned long long *val) {
+	char *endPtr;
+
+	if(!(*str) || ('-' == *str))
+		return -1;
+
+	*val = strtoull(str, &endPtr, 10);
+	switch(*endPtr) {
+		case 'G':
+		case 'g':
+			*val <<= 10;
+			/* fall through */
+		case 'M':
+		case 'm':
+			*val <<= 10;
+			/* fall through */
+		case 'K':
+		case 'k':
+			*val <<= 10;
+			endPtr++;
+			break;
+	}
+
+	return *endPtr? -1 : 0;
+}
+
+/**
+ * @brief Parse a comma-separated list of metrics.
+ * @param str The string to be parsed.
+ * @param metrics Pointer to a metrics_t structure to be filled.
+ * @return 0 on success, -1 if the list is empty or a metric is unknown or repeated.
+ */
+int parseMetrics(char *str, metrics_t *metrics) {
+	int i;
+	unsigned int j;
+	char *name;
+	char *savePtr;
+	char *copy = strdup(str);
+
+	metrics->count = 0;
+	strcpy(metrics->cacheParams, CACHE_PARAMS);
+
+	for(name = strtok_r(copy, ",", &savePtr); name; name = strtok_r(NULL, ",", &savePtr)) {
+		for(i = 0; (i < NO_OF_METRICS) && strcmp(name, metricNames[i]); i++);
+		for(j = 0; (j < metrics->count) && (metrics->ids[j] != i); j++);
+		if((NO_OF_METRICS == i) || (j < metrics->count)) {
+			metrics->count = 0;
+			break;
+		}
+
+		metrics->ids[metrics->count++] = i;
+		strcat(metrics->cacheParams, (1 == metrics->count)? " " : ",");
+		strcat(metrics->cacheParams, name);
+	}
+
+	free(copy);
+
+	return metrics->count? 0 : -1;
+}
+
+/**
+ * @brief Read a list of node ids from a text file.
+ * @param filename Name of the file.
+ * @param n Number of nodes of the graph.
+ * @param ids Reference to a pointer where a new array with the ids will be assigned. Developer should free it after use.
+ * @param count Reference to a variable where the number of ids will be assigned.
+ * @return 0 on success, -1 if the file could not be opened (errno is set), 1 if it is malformed.
+ */
+int readIds(char *filename, unsigned int n, unsigned int **ids, unsigned int *count) {
+	int rv;
+	FILE *file = fopen(filename, "r");
+
+	if(!file)
+		return -1;
+
+	rv = netio_readIds(file, n, ids, count);
+	fclose(file);
+
+	return rv? 1 : 0;
+}
+
+/**
+ * @brief Allocate the columns of all requested metrics in a single block.
+ * @param metrics Pointer to a metrics_t structure.
+ * @param n Number of nodes.
+ * @param columns Array to receive one pointer per requested metric. Developer should free columns[0] (the block)
+ *        with hugemem_free.
+ * @return Array for betweenness: its column if requested, or an extra array at the end of the block (betweenness
+ *         is always computed).
+ */
+double *allocColumns(metrics_t *metrics, unsigned int n, double **columns) {
+	unsigned int i;
+	double *block = hugemem_alloc(((size_t) metrics->count + 1) * n * sizeof(double) + 1);
+	double *cb = &block[(size_t) metrics->count * n];
+
+	for(i = 0; i < metrics->count; i++) {
+		columns[i] = &block[(size_t) i * n];
+		if(METRIC_BTW == metrics->ids[i])
+			cb = columns[i];
+	}
+
+	return cb;
+}
+
+/**
+ * @brief Point computation options to the columns of requested metrics.
+ * @param opts Pointer to a brandes_opts_t structure.
+ * @param metrics Pointer to a metrics_t structure.
+ * @param columns Columns allocated by allocColumns.
+ */
+void setColumns(brandes_opts_t *opts, metrics_t *metrics, double **columns) {
+	unsigned int i;
+
+	opts->closeness = NULL;
+	opts->harmonic = NULL;
+	opts->stress = NULL;
+
+	for(i = 0; i < metrics->count; i++) {
+		if(METRIC_CLOSENESS == metrics->ids[i])
+			opts->closeness = columns[i];
+		else if(METRIC_HARMONIC == metrics->ids[i])
+			opts->harmonic = columns[i];
+		else if(METRIC_STRESS == metrics->ids[i])
+			opts->stress = columns[i];
+	}
+}
+
+/**
+ * @brief Fit a run into a memory limit. Until the estimated peak fits, graph replicas are given up, then threads
+ *        of the source scheduler share their accumulators, then the level-synchronous engine is used instead (its
+ *        memory does not depend on the number of threads) and at last a single thread, or else threads are removed
+ *        one by one.
+ * @param limit Memory limit, in bytes.
+ * @param n Number of nodes.
+ * @param m Number of edges, as read.
+ * @param fixed Memory taken besides the edge list, the graph and the computation (e.g. result columns), in bytes.
+ * @param noOfReplicas Reference to the number of copies of the graph (1 if not replicated); may be set to 1.
+ * @param opts Pointer to a brandes_opts_t structure, whose number of threads, schedule and shared accumulators
+ *        may be changed.
+ * @return Estimated peak of the plan chosen, in bytes, or the smallest one estimated if nothing fits (more than
+ *         limit).
+ */
+unsigned long long planMemory(unsigned long long limit, unsigned int n, unsigned int m, unsigned long long fixed, unsigned int *noOfReplicas, brandes_opts_t *opts) {
+	unsigned long long graphSz = graph_estimateMemory(n, m);
+	unsigned long long loadPeak, peak, best = 0;
+	bool levels;
+
+	while(1) {
+#ifdef GRAPH_USE_GET_ADJACENTS
+		levels = (opts->noOfThreads > 1) && (BRANDES_SCHEDULE_LEVELS == opts->schedule);
+#else
+		levels = false;
+#endif
+
+		/* Loading: edge list, builder degrees and graph (and its copies, made before the edge list is freed) */
+		loadPeak = fixed + (2ull * m * sizeof(unsigned int)) + (n * sizeof(unsigned int)) + (graphSz * ((*noOfReplicas > 1)? (*noOfReplicas + 1) : 1));
+		peak = fixed + (graphSz * *noOfReplicas) + brandes_estimateMemory(n, m, opts);
+		if(loadPeak > peak)
+			peak = loadPeak;
+		if(peak <= limit)
+			return peak;
+		if(!best || (peak < best))
+			best = peak;
+
+		if(*noOfReplicas > 1) {
+			*noOfReplicas = 1;
+		}
+		else if((opts->noOfThreads > 1) && !levels && !(opts->sharedAccumulators)) {
+			opts->sharedAccumulators = true;
+		}
+#ifdef GRAPH_USE_GET_ADJACENTS
+		else if((opts->noOfThreads > 1) && !levels) {
+			opts->schedule = BRANDES_SCHEDULE_LEVELS;
+			opts->sharedAccumulators = false;
+		}
+#endif
+		else if((opts->noOfThreads > 1) && !levels) {
+			if(1 == --(opts->noOfThreads))
+				opts->sharedAccumulators = false;
+		}
+		/* A single thread needs no level arrays, but the sequential algorithm may need more memory for its lists */
+		else if(levels) {
+			opts->noOfThreads = 1;
+		}
+		else {
+			return best;
+		}
+	}
+}
+
+/* A graph to be processed in batch mode */
+typedef struct {
+	char *filename;
+	/* File size, used to process larger graphs first */
+	off_t size;
+} job_t;
+
+/* A graph going through the batch pipeline: loaded, then computed, then written */
+typedef struct {
+	job_t *job;
+	unsigned int n;
+	graph_t *graph;
+	double *cb;
+	/* Columns of requested metrics (columns[0] is the block holding all of them and cb) */
+	double *columns[NO_OF_METRICS];
+	/* Cache key, if a cache is used */
+	cache_key_t key;
+} item_t;
+
+/* Bounded blocking FIFO between two pipeline stages */
+typedef struct {
+	item_t **items;
+	unsigned int capacity;
+	unsigned int head;
+	unsigned int count;
+	/* Set when the producers are done: consumers get NULL once the FIFO is empty */
+	bool closed;
+	pthread_mutex_t mutex;
+	pthread_cond_t notEmpty;
+	pthread_cond_t notFull;
+} pipe_t;
+
+/* State of a batch, shared among pipeline threads */
+typedef struct {
+	job_t *jobs;
+	unsigned int noOfJobs;
+	unsigned int noOfFailures;
+	/* Loaded graphs waiting for a worker, and computed results waiting to be written */
+	pipe_t loaded;
+	pipe_t computed;
+	/* Workers still running (the last one to leave closes computed) */
+	unsigned int noOfActiveWorkers;
+	/* Total time workers spent waiting for a loaded graph, in microseconds */
+	unsigned long long stallTime;
+	/* Result cache (may be NULL) */
+	cache_t *cache;
+	/* Where workers are pinned (may be NULL), and index of the next worker to pin */
+	affinity_t *affinity;
+	unsigned int nextWorkerId;
+	/* Output settings */
+	metrics_t *metrics;
+	int format;
+	int precision;
+} batch_t;
+
+/**
+ * @brief Initialise a pipe holding at most capacity items.
+ */
+void pipeInit(pipe_t *pipe, unsigned int capacity) {
+	pipe->items = malloc(capacity * sizeof(item_t *));
+	pipe->capacity = capacity;
+	pipe->head = 0;
+	pipe->count = 0;
+	pipe->closed = false;
+	pthread_mutex_init(&(pipe->mutex), NULL);
+	pthread_cond_init(&(pipe->notEmpty), NULL);
+	pthread_cond_init(&(pipe->notFull), NULL);
+}
+
+/**
+ * @brief Insert an item in a pipe, waiting while it is full.
+ */
+void pipePush(pipe_t *pipe, item_t *item) {
+	pthread_mutex_lock(&(pipe->mutex));
+	while(pipe->count == pipe->capacity)
+		pthread_cond_wait(&(pipe->notFull), &(pipe->mutex));
+	pipe->items[(pipe->head + pipe->count) % pipe->capacity] = item;
+	(pipe->count)++;
+	pthread_cond_signal(&(pipe->notEmpty));
+	pthread_mutex_unlock(&(pipe->mutex));
+}
+
+/**
+ * @brief Remove an item from a pipe, waiting while it is empty.
+ * @return The item, or NULL if the pipe is empty and closed.
+ */
+item_t *pipePop(pipe_t *pipe) {
+	item_t *item = NULL;
+
+	pthread_mutex_lock(&(pipe->mutex));
+	while(!(pipe->count) && !(pipe->closed))
+		pthread_cond_wait(&(pipe->notEmpty), &(pipe->mutex));
+	if(pipe->count) {
+		item = pipe->items[pipe->head];
+		pipe->head = (pipe->head + 1) % pipe->capacity;
+		(pipe->count)--;
+		pthread_cond_signal(&(pipe->notFull));
+	}
+	pthread_mutex_unlock(&(pipe->mutex));
+
+	return item;
+}
+
+/**
+ * @brief Close a pipe: no more items will be pushed.
+ */
+void pipeClose(pipe_t *pipe) {
+	pthread_mutex_lock(&(pipe->mutex));
+	pipe->closed = true;
+	pthread_cond_broadcast(&(pipe->notEmpty));
+	pthread_mutex_unlock(&(pipe->mutex));
+}
+
+/**
+ * @brief Destroy a pipe (it must be empty).
+ */
+void pipeDestroy(pipe_t *pipe) {
+	pthread_cond_destroy(&(pipe->notFull));
+	pthread_cond_destroy(&(pipe->notEmpty));
+	pthread_mutex_destroy(&(pipe->mutex));
+	free(pipe->items);
+}
+
+/**
+ * @brief Comparison function for qsort (larger files first, then by name so that the order is deterministic).
+ */
+int compareJobs(const void *a, const void *b) {
+	const job_t *x = a;
+	const job_t *y = b;
+
+	if(x->size != y->size)
+		return (x->size < y->size) - (x->size > y->size);
+
+	return strcmp(x->filename, y->filename);
+}
+
+/**
+ * @brief Add a graph file to a batch.
+ */
+void addJob(batch_t *batch, unsigned int *capacity, char *filename) {
+	struct stat st;
+
+	if(batch->noOfJobs == *capacity) {
+		*capacity = *capacity? (2 * *capacity) : 64;
+		batch->jobs = realloc(batch->jobs, *capacity * sizeof(job_t));
+	}
+
+	batch->jobs[batch->noOfJobs].filename = filename;
+	/* Unreadable files are kept, so that they are reported when processed */
+	batch->jobs[batch->noOfJobs].size = stat(filename, &st)? 0 : st.st_size;
+	(batch->noOfJobs)++;
+}
+
+/**
+ * @brief List the graphs of a batch: every line of a list file, or every .net/.bnet file of a folder.
+ * @return 0 on success, -1 if the list file or folder could not be read.
+ */
+int listBatch(batch_t *batch, char *path) {
+	unsigned int capacity = 0;
+	struct stat st;
+	DIR *dir = NULL;
+	struct dirent *entry;
+	FILE *listFile = NULL;
+	char *line = NULL;
+	size_t lineSz = 0;
+	ssize_t len;
+	size_t nameLen;
+	char *filename;
+
+	if(stat(path, &st))
+		return -1;
+
+	if(S_ISDIR(st.st_mode)) {
+		dir = opendir(path);
+		if(!dir)
+			return -1;
+
+		while((entry = readdir(dir))) {
+			nameLen = strlen(entry->d_name);
+			if(!((nameLen > 4) && !strcmp(&(entry->d_name[nameLen - 4]), ".net")) && !((nameLen > 5) && !strcmp(&(entry->d_name[nameLen - 5]), ".bnet")))
+				continue;
+
+			filename = malloc(strlen(path) + nameLen + 2);
+			sprintf(filename, "%s/%s", path, entry->d_name);
+			addJob(batch, &capacity, filename);
+		}
+
+		closedir(dir);
+	}
+	else {
+		listFile = fopen(path, "r");
+		if(!listFile)
+			return -1;
+
+		while((len = getline(&line, &lineSz, listFile)) != -1) {
+			/* Strip trailing whitespace; skip empty lines and comments */
+			while(len && ((' ' == line[len - 1]) || ('\t' == line[len - 1]) || ('\n' == line[len - 1]) || ('\r' == line[len - 1])))
+				line[--len] = '\0';
+			if(!len || ('#' == line[0]))
+				continue;
+
+			filename = malloc(len + 1);
+			strcpy(filename, line);
+			addJob(batch, &capacity, filename);
+		}
+
+		free(line);
+		fclose(listFile);
+	}
+
+	/* Largest graphs first, so that the last graphs to finish are the small ones */
+	qsort(batch->jobs, batch->noOfJobs, sizeof(job_t), compareJobs);
+
+	return 0;
+}
+
+/**
+ * @brief Read and build a graph of a batch, unless its result is in the cache.
+ * @return A new item holding the graph (or the cached result), or NULL on failure (an error message is printed).
+ */
+item_t *loadJob(batch_t *batch, job_t *job) {
+	item_t *item = NULL;
+	FILE *inputFile = NULL;
+	unsigned int n, m;
+	unsigned int *edges = NULL;
+	unsigned int noOfDuplicates, noOfLoops;
+	graph_t *graph = NULL;
+	bool cacheHit = false;
+
+	inputFile = fopen(job->filename, "rb");
+	ASSERT_CALL(inputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), job->filename));
+	ASSERT_CALL(!netio_read(inputFile, &n, &m, &edges), fprintf(stderr, "Error: %s: malformed graph file\n", job->filename));
+
+	item = malloc(sizeof(item_t));
+	item->job = job;
+	item->n = n;
+	item->graph = NULL;
+	item->cb = allocColumns(batch->metrics, n, item->columns);
+	item->key.labels = NULL;
+
+	/* Cache hit: nothing to compute */
+	if(batch->cache) {
+		cache_computeKey(batch->cache, &(item->key), n, m, edges, batch->metrics->cacheParams);
+		cacheHit = !cache_lookup(batch->cache, &(item->key), item->columns, batch->metrics->count);
+		if(cacheHit)
+			cache_freeKey(&(item->key));
+	}
+
+	/* Loading runs alongside computation, hence each graph is built by a single thread */
+	if(!cacheHit) {
+		if(graph_createFromEdges(&graph, n, m, edges, 1, &noOfDuplicates, &noOfLoops)) {
+			/* An item without graph would be taken as a cache hit: drop it */
+			fprintf(stderr, "Error: %s: not enough memory for the graph\n", job->filename);
+			cache_freeKey(&(item->key));
+			hugemem_free(item->columns[0]);
+			free(item);
+			item = NULL;
+		}
+		else {
+			if(noOfDuplicates || noOfLoops)
+				fprintf(stderr, "Warning: %s: dropped %u duplicate edge(s) and %u self-loop(s)\n", job->filename, noOfDuplicates, noOfLoops);
+			item->graph = graph;
+		}
+	}
+
+_err:
+
+	if(edges)
+		free(edges);
+
+	if(inputFile)
+		fclose(inputFile);
+
+	return item;
+}
+
+/**
+ * @brief Write the result of a graph of a batch next to its input.
+ * @return 0 on success, -1 on failure (an error message is printed).
+ */
+int writeJob(batch_t *batch, item_t *item) {
+	int rv = -1;
+	FILE *outputFile = NULL;
+	char *outputFilename = NULL;
+
+	outputFilename = swapOrAddExtension(item->job->filename, (WRITER_FORMAT_BIN == batch->format)? "btwb" : "btw");
+	outputFile = fopen(outputFilename, "w");
+	ASSERT_CALL(outputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+	ASSERT_CALL(!writer_write(outputFile, item->columns, batch->metrics->count, item->n, batch->format, batch->precision), fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+
+	rv = 0;
+
+_err:
+
+	if(outputFile) {
+		if(fclose(outputFile) && !rv) {
+			fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename);
+			rv = -1;
+		}
+	}
+
+	if(outputFilename)
+		free(outputFilename);
+
+	return rv;
+}
+
+/**
+ * @brief Batch loader thread: read and build graphs (largest first), at most batch->loaded.capacity ahead of workers.
+ */
+void *batchLoader(void *arg) {
+	batch_t *batch = arg;
+	unsigned int i;
+	item_t *item;
+
+	for(i = 0; i < batch->noOfJobs; i++) {
+		item = loadJob(batch, &(batch->jobs[i]));
+		if(item)
+			pipePush(&(batch->loaded), item);
+		else
+			__atomic_fetch_add(&(batch->noOfFailures), 1, __ATOMIC_RELAXED);
+	}
+
+	pipeClose(&(batch->loaded));
+
+	return NULL;
+}
+
+/**
+ * @brief Batch worker thread: compute loaded graphs until none is left, handing results to the writer.
+ */
+void *batchWorker(void *arg) {
+	batch_t *batch = arg;
+	item_t *item;
+	brandes_work_t work;
+	brandes_opts_t opts;
+	double start;
+	int rv;
+
+	/* Pinned before its working buffers are first written, so that they are placed on its node */
+	affinity_pin(batch->affinity, __atomic_fetch_add(&(batch->nextWorkerId), 1, __ATOMIC_RELAXED));
+
+	brandes_initWork(&work);
+	brandes_initOpts(&opts);
+	opts.work = &work;
+
+	while(1) {
+		start = stats_now();
+		item = pipePop(&(batch->loaded));
+		__atomic_fetch_add(&(batch->stallTime), (unsigned long long) (1e6 * (stats_now() - start)), __ATOMIC_RELAXED);
+		if(!item)
+			break;
+
+		/* Graphs found in the cache go straight to the writer */
+		if(item->graph) {
+			setColumns(&opts, batch->metrics, item->columns);
+			rv = brandes_compute(item->graph, item->cb, &opts);
+			graph_destroy(&(item->graph));
+
+			/* Nothing valid to write or cache */
+			if(rv) {
+				fprintf(stderr, "Error: %s: not enough memory to compute betweenness\n", item->job->filename);
+				__atomic_fetch_add(&(batch->noOfFailures), 1, __ATOMIC_RELAXED);
+				cache_freeKey(&(item->key));
+				hugemem_free(item->columns[0]);
+				free(item);
+				continue;
+			}
+
+			if(batch->cache) {
+				if(cache_store(batch->cache, &(item->key), item->columns, batch->metrics->count))
+					fprintf(stderr, "Warning: %s: could not store result in cache: %s\n", item->job->filename, strerror(errno));
+				cache_freeKey(&(item->key));
+			}
+		}
+
+		pipePush(&(batch->computed), item);
+	}
+
+	brandes_freeWork(&work);
+
+	/* Last worker out: no more results will come */
+	if(!__atomic_sub_fetch(&(batch->noOfActiveWorkers), 1, __ATOMIC_ACQ_REL))
+		pipeClose(&(batch->computed));
+
+	return NULL;
+}
+
+/**
+ * @brief Batch writer: write results until all workers are done.
+ */
+void batchWriter(batch_t *batch) {
+	item_t *item;
+
+	while((item = pipePop(&(batch->computed)))) {
+		if(writeJob(batch, item))
+			__atomic_fetch_add(&(batch->noOfFailures), 1, __ATOMIC_RELAXED);
+		hugemem_free(item->columns[0]);
+		free(item);
+	}
+}
+
+/**
+ * @brief Process every graph of a batch through a pipeline: one loader thread prefetches and builds graphs,
+ *        noOfThreads workers compute them and the calling thread writes results.
+ * @param prefetch Capacity of each bounded FIFO between stages: at most this many loaded graphs and this many
+ *        pending results are held in memory, besides the ones being computed.
+ * @param cache Result cache (may be NULL).
+ * @param affinity Where workers are pinned (may be NULL).
+ * @param metrics Metrics to be written.
+ * @return 0 if every graph was processed, -1 otherwise.
+ */
+int runBatch(char *path, unsigned int noOfThreads, unsigned int prefetch, cache_t *cache, affinity_t *affinity, metrics_t *metrics, int format, int precision) {
+	unsigned int i = 0;
+	batch_t batch;
+	pthread_t loader;
+	bool loaderCreated = false;
+	pthread_t *threads = NULL;
+	double start = stats_now();
+
+	memset(&batch, 0, sizeof(batch_t));
+	batch.cache = cache;
+	batch.affinity = affinity;
+	batch.metrics = metrics;
+	batch.format = format;
+	batch.precision = precision;
+	pipeInit(&(batch.loaded), prefetch);
+	pipeInit(&(batch.computed), prefetch);
+
+	ASSERT_CALL(!listBatch(&batch, path), fprintf(stderr, "Error: %s: %s\n", strerror(errno), path));
+
+	ASSERT_CALL(!pthread_create(&loader, NULL, batchLoader, &batch), fprintf(stderr, "Error: could not create thread\n"));
+	loaderCreated = true;
+
+	/* No point in having more workers than graphs */
+	if(noOfThreads > batch.noOfJobs)
+		noOfThreads = batch.noOfJobs? batch.noOfJobs : 1;
+	batch.noOfActiveWorkers = noOfThreads;
+	threads = malloc(noOfThreads * sizeof(pthread_t));
+	for(i = 0; i < noOfThreads; i++) {
+		if(pthread_create(&threads[i], NULL, batchWorker, &batch)) {
+			fprintf(stderr, "Error: could not create thread\n");
+			/* Go on with the workers already created */
+			if(!__atomic_sub_fetch(&(batch.noOfActiveWorkers), noOfThreads - i, __ATOMIC_ACQ_REL))
+				pipeClose(&(batch.computed));
+			break;
+		}
+	}
+
+	/* Without workers, loaded graphs can only be discarded */
+	if(!i) {
+		item_t *item;
+
+		while((item = pipePop(&(batch.loaded)))) {
+			graph_destroy(&(item->graph));
+			cache_freeKey(&(item->key));
+			hugemem_free(item->columns[0]);
+			free(item);
+			batch.noOfFailures++;
+		}
+	}
+
+	batchWriter(&batch);
+
+_err:
+
+	if(threads) {
+		while(i-- > 0)
+			pthread_join(threads[i], NULL);
+		free(threads);
+	}
+
+	if(loaderCreated)
+		pthread_join(loader, NULL);
+
+	if(batch.jobs) {
+		fprintf(stderr, "Batch: %u graph(s), %u failed, %.3f s (workers waited %.3f s for input)\n", batch.noOfJobs, batch.noOfFailures, stats_now() - start, batch.stallTime / 1e6);
+		for(i = 0; i < batch.noOfJobs; i++)
+			free(batch.jobs[i].filename);
+		free(batch.jobs);
+	}
+
+	pipeDestroy(&(batch.computed));
+	pipeDestroy(&(batch.loaded));
+
+	return (batch.jobs && !(batch.noOfFailures) && loaderCreated)? 0 : -1;
+}
+
+/* A graph to be copied by cloneGraph */
+typedef struct {
+	graph_t *graph;
+	graph_t *clone;
+} replica_t;
+
+/**
+ * @brief Copy a graph; run by a thread on the node where the copy should be placed (see affinity_runOnNode).
+ */
+void *cloneGraph(void *arg) {
+	replica_t *replica = arg;
+
+	graph_clone(&(replica->clone), replica->graph);
+
+	return NULL;
+}
+
 int main(int argc, char *argv[]) {
 	/* Auxiliary variables */
-	int i;
+	int opt;
 	char *inputFilename;
+	unsigned int noOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int *edges = NULL;
+	/* Nothing is dropped when the graph is not built (cache hit) */
+	unsigned int noOfDuplicates = 0, noOfLoops = 0;
+	int format = WRITER_FORMAT_TEXT;
+	int precision = WRITER_PRECISION_DEFAULT;
+	char *endPtr;
+	bool printStats = false;
+	char *statsFilename = NULL;
+	char *batchPath = NULL;
+	int batchFailed;
+	int exitStatus = EXIT_FAILURE;
+	unsigned int prefetch = 2;
+	char *socketPath = NULL;
+	char *cacheDir = NULL;
+	unsigned long long cacheSize = CACHE_DEFAULT_MAX_SZ;
+	bool canonicalize = false;
+	cache_t cache;
+	cache_t *cachePtr = NULL;
+	cache_key_t key;
+	bool cacheHit = false;
+	unsigned long deadline = 0;
+	unsigned long seed = 0;
+	bool showProgress = false;
+	unsigned int *sources = NULL;
+	unsigned int noOfPivots = 0;
+	int pivotStrategy = BRANDES_PIVOTS_UNIFORM;
+	bool linearScaling = true;
+	double *weights = NULL;
+	double *stdErr = NULL;
+	metrics_t metrics;
+	double *columns[NO_OF_METRICS + 1];
+	unsigned int i, j, noOfColumns;
+	FILE *statsFile = NULL;
+	stats_t stats;
+	double start;
+	bool usePerfCounters = false;
+	perfcnt_t perfcnt;
+	int affinityPolicy = AFFINITY_NONE;
+	int hugePolicy = HUGEMEM_AUTO;
+	int numaGraph = NUMA_GRAPH_NONE;
+	int schedule = BRANDES_SCHEDULE_LEVELS;
+	unsigned long long memLimit = 0;
+	unsigned long long peak;
+	unsigned int noOfReplicas;
+	affinity_t affinity;
+	affinity_t *affinityPtr = NULL;
+	graph_t *replicas[AFFINITY_MAX_NODES];
+#ifndef GRAPH_USE_ADJ_MATRIX
+	replica_t replica;
+#endif
+	char *verticesFilename = NULL;
+	char *pairsFilename = NULL;
+	bool ego = false;
+	unsigned int *vertices = NULL;
+	unsigned int *pairs = NULL;
+	unsigned int noOfVertices = 0, noOfPairs = 0;
+	bool *targets = NULL;
+	double *subset = NULL;
+	double *subsetColumns[NO_OF_METRICS + 1];
+	unsigned long long fixed;
+	int rv;
+	brandes_opts_t opts;
+	struct option longOpts[] = {
+		{"threads", required_argument, NULL, 't'},
+		{"format", required_argument, NULL, 'f'},
+		{"precision", required_argument, NULL, 'p'},
+		{"stats", no_argument, NULL, 's'},
+		{"stats-json", required_argument, NULL, 'S'},
+		{"perf-counters", no_argument, NULL, 'C'},
+		{"batch", required_argument, NULL, 'B'},
+		{"prefetch", required_argument, NULL, 'P'},
+		{"serve", required_argument, NULL, 'R'},
+		{"cache", required_argument, NULL, 'K'},
+		{"cache-size", required_argument, NULL, 'Z'},
+		{"canonical", no_argument, NULL, 'N'},
+		{"metrics", required_argument, NULL, 'M'},
+		{"deadline", required_argument, NULL, 'D'},
+		{"seed", required_argument, NULL, 'e'},
+		{"progress", no_argument, NULL, 'G'},
+		{"affinity", required_argument, NULL, 'A'},
+		{"numa-graph", required_argument, NULL, 'Y'},
+		{"schedule", required_argument, NULL, 'L'},
+		{"mem-limit", required_argument, NULL, 'X'},
+		{"huge-pages", required_argument, NULL, 'H'},
+		{"vertices", required_argument, NULL, 'V'},
+		{"pairs", required_argument, NULL, 'W'},
+		{"ego", no_argument, NULL, 'E'},
+		{"pivots", required_argument, NULL, 'I'},
+		{"pivot-strategy", required_argument, NULL, 'J'},
+		{"pivot-scaling", required_argument, NULL, 'Q'},
+		{NULL, 0, NULL, 0}
+	};
 	char *outputFilename = NULL;
 	FILE *inputFile = NULL;
 	FILE *outputFile = NULL;
@@ -72,153 +970,475 @@ int main(int argc, char *argv[]) {
 	unsigned int n, m;
 	graph_t *graph = NULL;
 	double *cb = NULL;
-	int t, s, v, w;
-	list_t *S = NULL;
-	list_t **P = NULL;
-	int *sigma = NULL;
-	int *d = NULL;
-	double *delta = NULL;
-	list_t *Q = NULL;
-#ifdef GRAPH_USE_GET_ADJACENTS
-	unsigned int noOfAdjacents;
-	int *adjacents;
-#endif
+
+	brandes_initOpts(&opts);
+	key.labels = NULL;
+	parseMetrics(metricNames[METRIC_BTW], &metrics);
 
 	/* Check if command line arguments were passed correctly */
-	ASSERT_CALL(2 == argc, fprintf(stderr, "Usage: %s INPUTFILE\n", argv[0]));
-	inputFilename = argv[1];
-	outputFilename = swapOrAddExtension(inputFilename, "btw");
+	while((opt = getopt_long(argc, argv, "t:f:p:s", longOpts, NULL)) != -1) {
+		switch(opt) {
+			case 't':
+				noOfThreads = strtoul(optarg, NULL, 10);
+				break;
+			case 'f':
+				if(!strcmp(optarg, "text"))
+					format = WRITER_FORMAT_TEXT;
+				else if(!strcmp(optarg, "bin"))
+					format = WRITER_FORMAT_BIN;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown output format: %s\n", optarg));
+				break;
+			case 'p':
+				if(!strcmp(optarg, "shortest")) {
+					precision = WRITER_PRECISION_SHORTEST;
+				}
+				else {
+					precision = strtol(optarg, &endPtr, 10);
+					ASSERT_CALL(!(*endPtr) && (precision >= 0) && (precision <= WRITER_PRECISION_MAX), fprintf(stderr, "Error: invalid precision: %s\n", optarg));
+				}
+				break;
+			case 's':
+				printStats = true;
+				break;
+			case 'S':
+				statsFilename = optarg;
+				break;
+			case 'C':
+				usePerfCounters = true;
+				break;
+			case 'B':
+				batchPath = optarg;
+				break;
+			case 'P':
+				prefetch = strtoul(optarg, NULL, 10);
+				ASSERT_CALL(prefetch > 0, fprintf(stderr, "Error: prefetch depth must be positive\n"));
+				break;
+			case 'R':
+				socketPath = optarg;
+				break;
+			case 'K':
+				cacheDir = optarg;
+				break;
+			case 'Z':
+				ASSERT_CALL(!parseSize(optarg, &cacheSize), fprintf(stderr, "Error: invalid cache size: %s\n", optarg));
+				break;
+			case 'N':
+				canonicalize = true;
+				break;
+			case 'M':
+				ASSERT_CALL(!parseMetrics(optarg, &metrics), fprintf(stderr, "Error: invalid metrics: %s\n", optarg));
+				break;
+			case 'D':
+				deadline = strtoul(optarg, &endPtr, 10);
+				ASSERT_CALL(!(*endPtr) && (deadline > 0), fprintf(stderr, "Error: invalid deadline: %s\n", optarg));
+				break;
+			case 'e':
+				seed = strtoul(optarg, &endPtr, 10);
+				ASSERT_CALL(!(*endPtr), fprintf(stderr, "Error: invalid seed: %s\n", optarg));
+				break;
+			case 'G':
+				showProgress = true;
+				break;
+			case 'A':
+				if(!strcmp(optarg, "none"))
+					affinityPolicy = AFFINITY_NONE;
+				else if(!strcmp(optarg, "compact"))
+					affinityPolicy = AFFINITY_COMPACT;
+				else if(!strcmp(optarg, "scatter"))
+					affinityPolicy = AFFINITY_SCATTER;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown affinity policy: %s\n", optarg));
+				break;
+			case 'Y':
+				if(!strcmp(optarg, "none"))
+					numaGraph = NUMA_GRAPH_NONE;
+				else if(!strcmp(optarg, "interleave"))
+					numaGraph = NUMA_GRAPH_INTERLEAVE;
+				else if(!strcmp(optarg, "replicate"))
+					numaGraph = NUMA_GRAPH_REPLICATE;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown graph placement: %s\n", optarg));
+				break;
+			case 'L':
+				if(!strcmp(optarg, "levels"))
+					schedule = BRANDES_SCHEDULE_LEVELS;
+				else if(!strcmp(optarg, "sources"))
+					schedule = BRANDES_SCHEDULE_SOURCES;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown schedule: %s\n", optarg));
+				break;
+			case 'X':
+				ASSERT_CALL(!parseSize(optarg, &memLimit) && memLimit, fprintf(stderr, "Error: invalid memory limit: %s\n", optarg));
+				break;
+			case 'H':
+				if(!strcmp(optarg, "auto"))
+					hugePolicy = HUGEMEM_AUTO;
+				else if(!strcmp(optarg, "thp"))
+					hugePolicy = HUGEMEM_THP;
+				else if(!strcmp(optarg, "none"))
+					hugePolicy = HUGEMEM_NONE;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown huge page policy: %s\n", optarg));
+				break;
+			case 'V':
+				verticesFilename = optarg;
+				break;
+			case 'W':
+				pairsFilename = optarg;
+				break;
+			case 'E':
+				ego = true;
+				break;
+			case 'I':
+				noOfPivots = strtoul(optarg, &endPtr, 10);
+				ASSERT_CALL(!(*endPtr) && (noOfPivots > 0), fprintf(stderr, "Error: invalid number of pivots: %s\n", optarg));
+				break;
+			case 'J':
+				if(!strcmp(optarg, "uniform"))
+					pivotStrategy = BRANDES_PIVOTS_UNIFORM;
+				else if(!strcmp(optarg, "degree"))
+					pivotStrategy = BRANDES_PIVOTS_DEGREE;
+				else if(!strcmp(optarg, "maxmin"))
+					pivotStrategy = BRANDES_PIVOTS_MAXMIN;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown pivot strategy: %s\n", optarg));
+				break;
+			case 'Q':
+				if(!strcmp(optarg, "linear"))
+					linearScaling = true;
+				else if(!strcmp(optarg, "none"))
+					linearScaling = false;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown pivot scaling: %s\n", optarg));
+				break;
+			default:
+				ASSERT_CALL(false, fprintf(stderr, USAGE_STR, argv[0], argv[0], argv[0]));
+		}
+	}
+	ASSERT_CALL(noOfThreads > 0, fprintf(stderr, "Error: number of threads must be positive\n"));
+	hugemem_setPolicy(hugePolicy);
+
+	/* Batch and server modes do not take an input file and do not sample statistics */
+	if(batchPath || socketPath) {
+		ASSERT_CALL(optind == argc, fprintf(stderr, USAGE_STR, argv[0], argv[0], argv[0]));
+		ASSERT_CALL(!batchPath || !socketPath, fprintf(stderr, "Error: --batch and --serve cannot be used together\n"));
+		ASSERT_CALL(!printStats && !statsFilename && !usePerfCounters, fprintf(stderr, "Error: --stats, --stats-json and --perf-counters are not available in batch and server modes\n"));
+		ASSERT_CALL(!deadline && !showProgress, fprintf(stderr, "Error: --deadline and --progress are not available in batch and server modes\n"));
+		ASSERT_CALL(!socketPath || (AFFINITY_NONE == affinityPolicy), fprintf(stderr, "Error: --affinity is not available in server mode\n"));
+		ASSERT_CALL(NUMA_GRAPH_NONE == numaGraph, fprintf(stderr, "Error: --numa-graph is not available in batch and server modes\n"));
+		ASSERT_CALL(!memLimit, fprintf(stderr, "Error: --mem-limit is not available in batch and server modes\n"));
+		ASSERT_CALL(!verticesFilename && !pairsFilename && !ego && !noOfPivots, fprintf(stderr, "Error: --vertices, --pairs, --ego and --pivots are not available in batch and server modes\n"));
+	}
+
+	/* Partial results are neither sampled nor cached */
+	if(verticesFilename || pairsFilename) {
+		ASSERT_CALL(!deadline, fprintf(stderr, "Error: --deadline is not available with --vertices and --pairs\n"));
+		ASSERT_CALL(!cacheDir, fprintf(stderr, "Error: --cache is not available with --vertices and --pairs\n"));
+	}
+	if(ego) {
+		ASSERT_CALL(!pairsFilename, fprintf(stderr, "Error: --ego and --pairs cannot be used together\n"));
+		ASSERT_CALL(!deadline && !cacheDir && !memLimit, fprintf(stderr, "Error: --deadline, --cache and --mem-limit are not available with --ego\n"));
+		ASSERT_CALL((1 == metrics.count) && (METRIC_BTW == metrics.ids[0]), fprintf(stderr, "Error: --ego only computes btw\n"));
+	}
+	if(noOfPivots) {
+		ASSERT_CALL(!pairsFilename && !ego, fprintf(stderr, "Error: --pivots cannot be used with --pairs and --ego\n"));
+		ASSERT_CALL(!deadline && !cacheDir, fprintf(stderr, "Error: --deadline and --cache are not available with --pivots\n"));
+		ASSERT_CALL((1 == metrics.count) && (METRIC_BTW == metrics.ids[0]), fprintf(stderr, "Error: --pivots only computes btw\n"));
+	}
+	if(pairsFilename) {
+		ASSERT_CALL((1 == metrics.count) && (METRIC_BTW == metrics.ids[0]), fprintf(stderr, "Error: --pairs only computes btw\n"));
+		ASSERT_CALL(!memLimit, fprintf(stderr, "Error: --mem-limit is not available with --pairs\n"));
+	}
+#ifdef GRAPH_USE_ADJ_MATRIX
+	ASSERT_CALL(NUMA_GRAPH_NONE == numaGraph, fprintf(stderr, "Error: --numa-graph is only available when adjacency lists are used\n"));
+#endif
+	ASSERT_CALL((numaGraph != NUMA_GRAPH_REPLICATE) || (affinityPolicy != AFFINITY_NONE), fprintf(stderr, "Error: --numa-graph replicate needs --affinity compact or scatter\n"));
 
-	/* Open input and output files and check their existence */
-	inputFile = fopen(inputFilename, "r");
+	/* Topology may not be available (e.g. restricted /sys): go on without pinning */
+	if((affinityPolicy != AFFINITY_NONE) || (numaGraph != NUMA_GRAPH_NONE)) {
+		if(!affinity_init(&affinity, affinityPolicy)) {
+			affinityPtr = &affinity;
+		}
+		else {
+			fprintf(stderr, "Warning: NUMA topology is not available, ignoring --affinity and --numa-graph\n");
+			numaGraph = NUMA_GRAPH_NONE;
+		}
+	}
+
+	if(cacheDir) {
+		ASSERT_CALL(!socketPath, fprintf(stderr, "Error: --cache is not available in server mode\n"));
+		ASSERT_CALL(!cache_init(&cache, cacheDir, cacheSize, canonicalize), fprintf(stderr, "Error: %s: %s\n", strerror(errno), cacheDir));
+		cachePtr = &cache;
+	}
+
+	/* Server mode: answer requests until shutdown */
+	if(socketPath) {
+		ASSERT_CALL(!server_run(socketPath, noOfThreads, precision), fprintf(stderr, "Error: %s: %s\n", strerror(errno), socketPath));
+		return EXIT_SUCCESS;
+	}
+
+	/* Batch mode: all work is done by the thread pool */
+	if(batchPath) {
+		batchFailed = runBatch(batchPath, noOfThreads, prefetch, cachePtr, affinityPtr, &metrics, format, precision);
+		if(affinityPtr)
+			affinity_destroy(affinityPtr);
+		return batchFailed? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	ASSERT_CALL((optind + 1) == argc, fprintf(stderr, USAGE_STR, argv[0], argv[0], argv[0]));
+	inputFilename = argv[optind];
+	outputFilename = swapOrAddExtension(inputFilename, (WRITER_FORMAT_BIN == format)? "btwb" : "btw");
+	stats_reset(&stats);
+	if(printStats || statsFilename)
+		opts.stats = &stats;
+	if(showProgress)
+		opts.progress = stderr;
+	opts.noOfThreads = noOfThreads;
+	opts.schedule = schedule;
+	opts.affinity = affinityPtr;
+
+	/* Hardware counters may not be available (e.g. inside containers): go on without them */
+	if(usePerfCounters) {
+		if(perfcnt_open(&perfcnt))
+			opts.perfcnt = &perfcnt;
+		else
+			fprintf(stderr, "Warning: hardware performance counters are not available (%s), ignoring --perf-counters\n", strerror(errno));
+	}
+
+	/* Open input file and check its existence */
+	inputFile = fopen(inputFilename, "rb");
 	ASSERT_CALL(inputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), inputFilename));
-	outputFile = fopen(outputFilename, "w");
-	ASSERT_CALL(outputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
 
-	/* Read file header and allocate stuff */
-	fscanf(inputFile, "%d", &n);
-	fscanf(inputFile, "%d", &m);
-	graph_create(&graph, n, m);
-	cb = calloc(n, sizeof(double));
-	sigma = malloc(n * sizeof(int));
-	d = malloc(n * sizeof(int));
-	delta = malloc(n * sizeof(double));
-
-	/* Read edges from file */
-	unsigned int orig, dest;
-	for(i = 0; i < m; i++) {
-		fscanf(inputFile, "%d %d", &orig, &dest);
-		graph_putEdge(graph, orig, dest);
-		graph_putEdge(graph, dest, orig);
-	}
-
-	/* Beginning of Brandes Algorithm */
-
-	P = calloc(n, sizeof(list_t *));
-	for(s = 0; s < n; s++) {
-		S = dlist_create();
-		for(w = 0; w < n; w++)
-			P[w] = dlist_create();
-		for(t = 0; t < n; t++) {
-			sigma[t] = 0;
-			d[t] = -1;
-		}
-		sigma[s] = 1;
-		d[s] = 0;
-		Q = dlist_create();
-
-		dlist_pushBack(Q, s);
-
-		while(!dlist_isEmpty(Q)) {
-			v = dlist_front(Q);
-			dlist_popFront(Q);
-			dlist_pushFront(S, v);
+	start = stats_now();
 
-#ifdef GRAPH_USE_GET_ADJACENTS
-			/* Smarter way of getting node neighbours: get all nodes w which are neighbours of v, no checking necessary */
-			adjacents = graph_getAdjacents(graph, v, &noOfAdjacents);
-			for(i = 0; i < noOfAdjacents; i++) {
-				w = adjacents[i];
-				{
-#else
-			/* Naive way of getting node neighbours: Get all nodes w and check which are neighbours of v */
-			for(w = 0; w < n; w++) {
-				if(graph_getEdge(graph, v, w)) {
-#endif
-					if(d[w] < 0) {
-						dlist_pushBack(Q, w);
-						d[w] = d[v] + 1;
-					}
-
-					if((d[v] + 1) == d[w]) {
-						sigma[w] = sigma[w] + sigma[v];
-						dlist_pushBack(P[w], v);
-					}
-				}
+	/* Read whole graph file (text or binary) and allocate stuff */
+	ASSERT_CALL(!netio_read(inputFile, &n, &m, &edges), fprintf(stderr, "Error: %s: malformed graph file\n", inputFilename));
+	cb = allocColumns(&metrics, n, columns);
+	setColumns(&opts, &metrics, columns);
+	noOfColumns = metrics.count;
+	fixed = MEM_BASELINE + (((unsigned long long) noOfColumns + 1) * n * sizeof(double));
+
+	/* Targeted runs: nodes to be written (and computed, unless pairs are given) and pairs */
+	if(verticesFilename) {
+		rv = readIds(verticesFilename, n, &vertices, &noOfVertices);
+		ASSERT_CALL(rv >= 0, fprintf(stderr, "Error: %s: %s\n", strerror(errno), verticesFilename));
+		ASSERT_CALL(!rv, fprintf(stderr, "Error: %s: malformed vertex list (node ids from 0 to %u expected)\n", verticesFilename, n - 1));
+
+		targets = calloc(n, sizeof(bool));
+		for(i = 0; i < noOfVertices; i++)
+			targets[vertices[i]] = true;
+		if(!pairsFilename && !ego)
+			opts.targets = targets;
+		fixed += (n * sizeof(bool)) + (noOfVertices * (sizeof(unsigned int) + (noOfColumns * sizeof(double))));
+	}
+	if(pairsFilename) {
+		rv = readIds(pairsFilename, n, &pairs, &noOfPairs);
+		ASSERT_CALL(rv >= 0, fprintf(stderr, "Error: %s: %s\n", strerror(errno), pairsFilename));
+		ASSERT_CALL(!rv && !(noOfPairs % 2), fprintf(stderr, "Error: %s: malformed pair list (pairs of node ids from 0 to %u expected)\n", pairsFilename, n - 1));
+		noOfPairs /= 2;
+	}
+
+	/* Anytime mode: sources in random order, so that stopping at any point leaves an unbiased sample */
+	if(deadline) {
+		sources = malloc(n * sizeof(unsigned int));
+		brandes_permuteSources(sources, n, seed);
+		opts.sources = sources;
+		opts.noOfSources = n;
+		opts.deadline = start + (deadline / 1000.0);
+
+		/* Standard error of betweenness, if written */
+		for(i = 0; i < metrics.count; i++) {
+			if(METRIC_BTW == metrics.ids[i]) {
+				stdErr = calloc(n, sizeof(double));
+				opts.stdErr = stdErr;
+				columns[noOfColumns++] = stdErr;
 			}
 		}
+	}
 
-		for(v = 0; v < n; v++)
-			delta[v] = 0;
+	/* Pivots are chosen once the graph is built; their weights and the scaling already change the memory plan */
+	if(noOfPivots) {
+		sources = malloc(n * sizeof(unsigned int));
+		weights = malloc(n * sizeof(double));
+		opts.sources = sources;
+		opts.weights = weights;
+		opts.linearScaling = linearScaling;
+		fixed += n * sizeof(double);
+	}
 
-		while(!dlist_isEmpty(S)) {
-			w = dlist_front(S);
-			dlist_popFront(S);
+	/* A cached result makes building the graph unnecessary */
+	if(cachePtr) {
+		cache_computeKey(cachePtr, &key, n, m, edges, metrics.cacheParams);
+		cacheHit = !cache_lookup(cachePtr, &key, columns, metrics.count);
+	}
 
-			while(!dlist_isEmpty(P[w])) {
-				v = dlist_front(P[w]);
-				dlist_popFront(P[w]);
+	/* Plan against the memory limit before anything large is allocated */
+	if(memLimit && !cacheHit) {
+		noOfReplicas = (NUMA_GRAPH_REPLICATE == numaGraph)? affinity.noOfNodes : 1;
+		peak = planMemory(memLimit, n, m, fixed + (sources? (n * sizeof(unsigned int)) : 0), &noOfReplicas, &opts);
+		ASSERT_CALL(peak <= memLimit, fprintf(stderr, "Error: %s: estimated peak memory is %.1f MiB even with the leanest plan, more than --mem-limit (%.1f MiB); nothing was computed\n", inputFilename, peak / 1048576.0, memLimit / 1048576.0));
 
-				delta[v] = delta[v] + ((sigma[v] / ((double) sigma[w])) * (1 + delta[w]));
-			}
+		if((NUMA_GRAPH_REPLICATE == numaGraph) && (1 == noOfReplicas)) {
+			fprintf(stderr, "Warning: %s: graph is not replicated, to fit --mem-limit\n", inputFilename);
+			numaGraph = NUMA_GRAPH_NONE;
+		}
+		if(opts.sharedAccumulators)
+			fprintf(stderr, "Warning: %s: threads share their accumulators, to fit --mem-limit\n", inputFilename);
+		if(opts.schedule != schedule)
+			fprintf(stderr, "Warning: %s: using the level-synchronous engine (--schedule levels), to fit --mem-limit\n", inputFilename);
+		if(opts.noOfThreads != noOfThreads)
+			fprintf(stderr, "Warning: %s: computing with %u thread(s) instead of %u, to fit --mem-limit\n", inputFilename, opts.noOfThreads, noOfThreads);
+		if(printStats)
+			fprintf(stderr, "Estimated peak memory: %.1f MiB (limit %.1f MiB)\n", peak / 1048576.0, memLimit / 1048576.0);
+	}
+
+	/* Output files are only opened (and truncated) once the run is known to fit */
+	outputFile = fopen(outputFilename, "w");
+	ASSERT_CALL(outputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+	if(statsFilename) {
+		statsFile = fopen(statsFilename, "w");
+		ASSERT_CALL(statsFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), statsFilename));
+	}
+
+	/* A single thread computes here (also when the plan fell back to one), the other engines pin their own threads */
+	if(1 == opts.noOfThreads)
+		affinity_pin(affinityPtr, 0);
+
+	/* Build the whole graph at once */
+	if(!cacheHit) {
+		ASSERT_CALL(!graph_createFromEdges(&graph, n, m, edges, noOfThreads, &noOfDuplicates, &noOfLoops), fprintf(stderr, "Error: %s: not enough memory for the graph\n", inputFilename));
+		if(noOfDuplicates || noOfLoops)
+			fprintf(stderr, "Warning: %s: dropped %u duplicate edge(s) and %u self-loop(s)\n", inputFilename, noOfDuplicates, noOfLoops);
 
-			if(w != s)
-				cb[w] = cb[w] + delta[w];
+#ifndef GRAPH_USE_ADJ_MATRIX
+		/* Kernels without NUMA support (or restricted ones, e.g. inside containers) refuse: not fatal */
+		if(NUMA_GRAPH_INTERLEAVE == numaGraph) {
+			if(affinity_interleave(affinityPtr, graph->adj, n * sizeof(int *)) || affinity_interleave(affinityPtr, graph->pool, graph->poolSz * sizeof(int)))
+				fprintf(stderr, "Warning: could not interleave the graph over NUMA nodes (%s)\n", strerror(errno));
 		}
 
-		dlist_destroy(&Q);
-		Q = NULL;
-		for(w = 0; w < n; w++) {
-			dlist_destroy(&P[w]);
-			P[w] = NULL;
+		/* One copy per node, each one written (hence placed) by a thread on its node; the first one replaces graph */
+		if(NUMA_GRAPH_REPLICATE == numaGraph) {
+			replica.graph = graph;
+			for(i = 0; i < affinity.noOfNodes; i++) {
+				if(affinity_runOnNode(affinityPtr, i, cloneGraph, &replica))
+					cloneGraph(&replica);
+				replicas[i] = replica.clone;
+			}
+			graph_destroy(&graph);
+			graph = replicas[0];
+			opts.replicas = replicas;
 		}
-		dlist_destroy(&S);
-		S = NULL;
+#endif
+	}
+	free(edges);
+	edges = NULL;
+
+	stats.n = n;
+	stats.m = m - noOfDuplicates - noOfLoops;
+	stats.phaseTime[STATS_PHASE_LOAD] = stats_now() - start;
+
+	/* Brandes Algorithm */
+	if(ego) {
+		ASSERT_CALL(!ego_compute(graph, cb, noOfThreads, opts.stats), fprintf(stderr, "Error: %s: not enough memory for ego betweenness\n", inputFilename));
+	}
+	else if(pairs) {
+		brandes_computePairs(graph, pairs, noOfPairs, cb, &opts);
+	}
+	else if(!cacheHit) {
+		if(noOfPivots) {
+			start = stats_now();
+			opts.noOfSources = brandes_selectPivots(graph, sources, weights, noOfPivots, pivotStrategy, seed);
+			stats.phaseTime[STATS_PHASE_PREPROCESS] += stats_now() - start;
+		}
+		ASSERT_CALL(!brandes_compute(graph, cb, &opts), fprintf(stderr, "Error: %s: not enough memory to compute betweenness\n", inputFilename));
+		if(deadline && (opts.noOfSourcesDone < n))
+			fprintf(stderr, "Warning: %s: deadline reached after %u of %u sources, writing estimate\n", inputFilename, opts.noOfSourcesDone, n);
+
+		/* Only exact results are cached */
+		if(cachePtr && (opts.noOfSourcesDone == n) && cache_store(cachePtr, &key, columns, metrics.count))
+			fprintf(stderr, "Warning: %s: could not store result in cache: %s\n", inputFilename, strerror(errno));
 	}
 
 	/* At last, print results */
-	for(v = 0; v < n; v++)
-		fprintf(outputFile, "%lf\n", cb[v] / 2.0);
+	start = stats_now();
+	if(vertices) {
+		/* Only the rows of the nodes listed, gathered in their order */
+		subset = malloc(((size_t) noOfColumns * noOfVertices + 1) * sizeof(double));
+		for(i = 0; i < noOfColumns; i++) {
+			subsetColumns[i] = &subset[(size_t) i * noOfVertices];
+			for(j = 0; j < noOfVertices; j++)
+				subsetColumns[i][j] = columns[i][vertices[j]];
+		}
+		ASSERT_CALL(!writer_write(outputFile, subsetColumns, noOfColumns, noOfVertices, format, precision), fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+	}
+	else {
+		ASSERT_CALL(!writer_write(outputFile, columns, noOfColumns, n, format, precision), fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+	}
+	fflush(outputFile);
+	stats.phaseTime[STATS_PHASE_OUTPUT] = stats_now() - start;
+
+	stats_sampleRSS(&stats);
+	if(printStats)
+		stats_print(stderr, &stats);
+	if(statsFile)
+		stats_printJSON(statsFile, &stats);
+	if(opts.perfcnt)
+		perfcnt_print(stderr, &perfcnt);
+
+	exitStatus = EXIT_SUCCESS;
 
 _err:
 
-	if(delta)
-		free(delta);
+	if(opts.perfcnt)
+		perfcnt_close(&perfcnt);
 
-	if(Q)
-		dlist_destroy(&Q);
+	cache_freeKey(&key);
 
-	if(d)
-		free(d);
+	if(edges)
+		free(edges);
 
-	if(sigma)
-		free(sigma);
+	/* Block holding every column */
+	if(cb)
+		hugemem_free(columns[0]);
 
-	if(P) {
-		for(i = 0; i < n; i++) {
-			if(P[i])
-				dlist_destroy(&P[i]);
-		}
+	if(stdErr)
+		free(stdErr);
 
-		free(P);
-	}
+	if(sources)
+		free(sources);
 
-	if(cb)
-		free(cb);
+	if(weights)
+		free(weights);
+
+	if(subset)
+		free(subset);
+
+	if(targets)
+		free(targets);
+
+	if(vertices)
+		free(vertices);
+
+	if(pairs)
+		free(pairs);
 
 	if(graph)
 		graph_destroy(&graph);
 
+	/* First replica is graph */
+	if(opts.replicas) {
+		for(i = 1; i < affinity.noOfNodes; i++)
+			graph_destroy(&replicas[i]);
+	}
+
+	if(affinityPtr)
+		affinity_destroy(affinityPtr);
+
+	if(statsFile)
+		fclose(statsFile);
+
 	if(outputFile)
 		fclose(outputFile);
 
@@ -228,5 +1448,5 @@ _err:
 	if(outputFilename)
 		free(outputFilename);
 
-	return EXIT_SUCCESS;
+	return exitStatus;
 }
@@ -0,0 +1,2701 @@
+/* ********************************************************************************************* */
+/* * Simple implementation for Brandes Betweenness Algorithm: libbrandes                       * */
+/* * Author: André Bannwart Perina                                                             * */
+/* * Algorithm: Brandes, Ulrik. "A faster algorithm for betweenness centrality."               * */
+/* *            Journal of mathematical sociology 25.2 (2001): 163-177.                        * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libbrandes is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libbrandes is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libbrandes.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "brandes.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hugemem.h"
+#include "list.h"
+
+/* Vectorised backward kernels, chosen at run time (x86 only, GCC or Clang) */
+#if defined(BRANDES_USE_LEVEL_ORDER) && !defined(BRANDES_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _BRANDES_USE_SIMD
+#include <immintrin.h>
+#endif
+
+/* Allocator overhead assumed for each block, when estimating memory */
+#define _BRANDES_MALLOC_OVERHEAD 16
+#ifdef LIST_USE_UNROLLED
+/* Size of a node of an integer list (see list_tmpl.h), when estimating memory */
+#define _BRANDES_LIST_NODE_SZ ((2 * sizeof(unsigned int)) + (LIST_UNROLL_SZ * sizeof(int)) + sizeof(void *) + _BRANDES_MALLOC_OVERHEAD)
+#else
+#define _BRANDES_LIST_NODE_SZ (2 * sizeof(void *) + _BRANDES_MALLOC_OVERHEAD)
+#endif
+
+/**
+ * @brief Initialise options with default values (nothing is sampled).
+ */
+void brandes_initOpts(brandes_opts_t *opts) {
+	opts->stats = NULL;
+	opts->perfcnt = NULL;
+	opts->work = NULL;
+	opts->sources = NULL;
+	opts->noOfSources = 0;
+	opts->deadline = 0;
+	opts->stdErr = NULL;
+	opts->progress = NULL;
+	opts->noOfSourcesDone = 0;
+	opts->closeness = NULL;
+	opts->harmonic = NULL;
+	opts->stress = NULL;
+	opts->noOfThreads = 1;
+	opts->schedule = BRANDES_SCHEDULE_LEVELS;
+	opts->sharedAccumulators = false;
+	opts->affinity = NULL;
+	opts->replicas = NULL;
+	opts->targets = NULL;
+	opts->weights = NULL;
+	opts->linearScaling = false;
+}
+
+/**
+ * @brief Initialise working buffers (empty).
+ */
+void brandes_initWork(brandes_work_t *work) {
+	work->capacity = 0;
+	work->sigma = NULL;
+	work->d = NULL;
+	work->delta = NULL;
+	work->P = NULL;
+	work->S = NULL;
+	work->Q = NULL;
+	work->marked = NULL;
+#ifdef BRANDES_USE_LEVEL_ORDER
+	work->order = NULL;
+	work->levelStart = NULL;
+	work->coef = NULL;
+#endif
+}
+
+/**
+ * @brief Grow a block allocated with libhugemem, keeping its contents.
+ * @param ptr Block to be grown (may be NULL).
+ * @param oldSize Size of the block, in bytes (0 if its contents need not be kept).
+ * @param size New size, in bytes.
+ * @return The new block, or NULL if it could not be allocated (the old block is kept in this case).
+ * @note This is an internal function.
+ */
+static void *_brandes_grow(void *ptr, size_t oldSize, size_t size) {
+	void *newPtr = hugemem_alloc(size);
+
+	if(newPtr && ptr) {
+		memcpy(newPtr, ptr, oldSize);
+		hugemem_free(ptr);
+	}
+
+	return newPtr;
+}
+
+/**
+ * @brief Make sure that working buffers can hold a graph with n nodes.
+ */
+int brandes_reserveWork(brandes_work_t *work, unsigned int n) {
+	unsigned int capacity;
+	void *ptr;
+#ifndef BRANDES_USE_LEVEL_ORDER
+	unsigned int v;
+
+	if(!(work->S)) {
+		work->S = dlist_create();
+		work->Q = dlist_create();
+	}
+#endif
+
+	if(n <= work->capacity)
+		return 0;
+
+	/* Grow by at least 25%, so that a sequence of slightly larger graphs does not reallocate every time */
+	capacity = work->capacity + (work->capacity / 4);
+	if(capacity < n)
+		capacity = n;
+
+	/* Each buffer is replaced only once its new block is allocated: on failure, all of them keep the old capacity */
+	if(!(ptr = _brandes_grow(work->sigma, work->capacity * sizeof(brandes_sigma_t), capacity * sizeof(brandes_sigma_t))))
+		return -1;
+	work->sigma = ptr;
+	if(!(ptr = _brandes_grow(work->d, work->capacity * sizeof(int), capacity * sizeof(int))))
+		return -1;
+	work->d = ptr;
+	if(!(ptr = _brandes_grow(work->delta, work->capacity * sizeof(brandes_delta_t), capacity * sizeof(brandes_delta_t))))
+		return -1;
+	work->delta = ptr;
+	/* Contents of these are only valid during a source: no need to keep them */
+	if(!(ptr = _brandes_grow(work->marked, 0, capacity * sizeof(bool))))
+		return -1;
+	work->marked = ptr;
+#ifdef BRANDES_USE_LEVEL_ORDER
+	if(!(ptr = _brandes_grow(work->order, 0, capacity * sizeof(int))))
+		return -1;
+	work->order = ptr;
+	if(!(ptr = _brandes_grow(work->levelStart, 0, ((size_t) capacity + 1) * sizeof(unsigned int))))
+		return -1;
+	work->levelStart = ptr;
+	if(!(ptr = _brandes_grow(work->coef, 0, capacity * sizeof(double))))
+		return -1;
+	work->coef = ptr;
+#else
+	if(!(ptr = _brandes_grow(work->P, work->capacity * sizeof(list_t *), capacity * sizeof(list_t *))))
+		return -1;
+	work->P = ptr;
+	for(v = work->capacity; v < capacity; v++)
+		work->P[v] = dlist_create();
+#endif
+	work->capacity = capacity;
+
+	return 0;
+}
+
+/**
+ * @brief Free working buffers; they can be reserved again afterwards.
+ */
+void brandes_freeWork(brandes_work_t *work) {
+#ifdef BRANDES_USE_LEVEL_ORDER
+	hugemem_free(work->coef);
+	hugemem_free(work->levelStart);
+	hugemem_free(work->order);
+#else
+	unsigned int v;
+
+	for(v = 0; v < work->capacity; v++)
+		dlist_destroy(&(work->P[v]));
+	if(work->S) {
+		dlist_destroy(&(work->S));
+		dlist_destroy(&(work->Q));
+	}
+#endif
+
+	hugemem_free(work->P);
+	hugemem_free(work->marked);
+	hugemem_free(work->delta);
+	hugemem_free(work->d);
+	hugemem_free(work->sigma);
+
+	brandes_initWork(work);
+}
+
+/**
+ * @brief Next number of a splitmix64 sequence.
+ * @param state State of the sequence, initialised with the seed.
+ * @note This is an internal function.
+ */
+static inline uint64_t _brandes_random(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+	return z ^ (z >> 31);
+}
+
+/**
+ * @brief Fill an array with a random permutation of all nodes.
+ */
+void brandes_permuteSources(unsigned int *sources, unsigned int n, unsigned long seed) {
+	unsigned int i, j, tmp;
+	uint64_t state = seed;
+
+	for(i = 0; i < n; i++)
+		sources[i] = i;
+
+	/* Fisher-Yates shuffle driven by splitmix64 */
+	for(i = n; i > 1; i--) {
+		j = _brandes_random(&state) % i;
+
+		tmp = sources[i - 1];
+		sources[i - 1] = sources[j];
+		sources[j] = tmp;
+	}
+}
+
+/**
+ * @brief Report progress and check the deadline after a source.
+ * @param opts Pointer to a brandes_opts_t structure.
+ * @param done Number of sources processed.
+ * @param total Number of sources to be processed.
+ * @param begin Time when the first source began (only used for progress).
+ * @param lastReport Time of the last progress report, updated when a report is printed (NULL for no report).
+ * @return true if the deadline has passed.
+ * @note This is an internal function.
+ */
+static bool _brandes_checkpoint(brandes_opts_t *opts, unsigned int done, unsigned int total, double begin, double *lastReport) {
+	double now;
+
+	/* Clock is only read when needed */
+	if(!(opts->deadline) && !(opts->progress))
+		return false;
+
+	now = stats_now();
+	if(opts->progress && lastReport && (now - *lastReport >= 1)) {
+		fprintf(opts->progress, "Progress: %u/%u sources (%.1f%%), %.1f s elapsed, ETA %.1f s\n", done, total,
+			(100.0 * done) / total, now - begin, ((now - begin) / done) * (total - done));
+		*lastReport = now;
+	}
+
+	return opts->deadline && (now >= opts->deadline);
+}
+
+/**
+ * @brief Atomically add a value to a double.
+ * @note This is an internal function.
+ */
+static void _brandes_atomicAdd(double *ptr, double val) {
+	double old, new;
+
+	__atomic_load(ptr, &old, __ATOMIC_RELAXED);
+	do {
+		new = old + val;
+	} while(!__atomic_compare_exchange(ptr, &old, &new, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief Add a value to an accumulator, atomically if it is shared among threads.
+ * @note This is an internal function.
+ */
+static inline void _brandes_accumulate(bool atomic, double *ptr, double val) {
+	if(atomic)
+		_brandes_atomicAdd(ptr, val);
+	else
+		*ptr += val;
+}
+
+/**
+ * @brief Count the pages read by a pinned thread that are on its node and elsewhere: the graph it reads and its
+ *        working buffers (or its slice of them).
+ * @param node Index of the node of the thread (in affinity->nodeIds).
+ * @param count Number of elements of sigma, d and delta.
+ * @param local Reference to a variable where the number of local pages is added (atomically).
+ * @param remote Reference to a variable where the number of remote pages is added (atomically).
+ * @note When threads are pinned, each one first writes (and so places on its node) its own slice of the working
+ *       buffers, or its own buffers, and reads the replica of the graph of its node, if any. This tells how well
+ *       that worked.
+ * @note This is an internal function.
+ */
+static void _brandes_countPages(affinity_t *affinity, int node, graph_t *graph, brandes_sigma_t *sigma, int *d, brandes_delta_t *delta, unsigned int count, unsigned long long *local, unsigned long long *remote) {
+	unsigned long long localPages = 0, remotePages = 0;
+
+	affinity_countPages(affinity, graph->adj, graph->n * sizeof(int *), node, &localPages, &remotePages);
+	if(graph->pool)
+		affinity_countPages(affinity, graph->pool, graph->poolSz * sizeof(int), node, &localPages, &remotePages);
+	affinity_countPages(affinity, sigma, count * sizeof(brandes_sigma_t), node, &localPages, &remotePages);
+	affinity_countPages(affinity, d, count * sizeof(int), node, &localPages, &remotePages);
+	affinity_countPages(affinity, delta, count * sizeof(brandes_delta_t), node, &localPages, &remotePages);
+
+	__atomic_fetch_add(local, localPages, __ATOMIC_RELAXED);
+	__atomic_fetch_add(remote, remotePages, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Sample how much of the large arrays (graph, buffers and accumulators) is backed by huge pages, keeping
+ *        the largest sample.
+ * @note This is an internal function.
+ */
+static void _brandes_sampleHugePages(stats_t *stats) {
+	unsigned long long total, huge;
+
+	hugemem_usage(&total, &huge);
+	if(total > stats->largeBytes) {
+		stats->largeBytes = total;
+		stats->hugeBytes = huge;
+	}
+}
+
+#ifdef BRANDES_USE_LEVEL_ORDER
+/* Sum over the successors of a node (see _brandes_sumScalar) */
+typedef double (*_brandes_kernel_t)(const int *adj, unsigned int noOfAdjacents, const int *d, int l, const double *coef, const double *tau, double *tauSum);
+
+/**
+ * @brief Sum coef[w] over the neighbours w of a node that are in level l (its successors), without SIMD.
+ * @param tau Stress counters (may be NULL).
+ * @param tauSum Reference to a double where 1 + tau[w] is added for each successor (only if tau is set).
+ * @return The sum.
+ * @note This is an internal function.
+ */
+static double _brandes_sumScalar(const int *adj, unsigned int noOfAdjacents, const int *d, int l, const double *coef, const double *tau, double *tauSum) {
+	double sum = 0, tSum = 0;
+	unsigned int i;
+	int w;
+
+	for(i = 0; i < noOfAdjacents; i++) {
+		w = adj[i];
+		if(l == d[w]) {
+			sum += coef[w];
+			if(tau)
+				tSum += 1 + tau[w];
+		}
+	}
+
+	if(tau)
+		*tauSum += tSum;
+	return sum;
+}
+
+#ifdef _BRANDES_USE_SIMD
+/**
+ * @brief Sum coef[w] over the neighbours w of a node that are in level l (its successors), with AVX2.
+ * @note Eight neighbours at a time: their levels are gathered and compared, then coef (and tau) are gathered for
+ *       the successors only, four doubles at a time. Groups without successors skip the second gathers.
+ * @note This is an internal function.
+ */
+__attribute__((target("avx2")))
+static double _brandes_sumAVX2(const int *adj, unsigned int noOfAdjacents, const int *d, int l, const double *coef, const double *tau, double *tauSum) {
+	__m256i level = _mm256_set1_epi32(l);
+	__m256d zero = _mm256_setzero_pd();
+	__m256d one = _mm256_set1_pd(1);
+	__m256d sumLo = zero, sumHi = zero, tSumLo = zero, tSumHi = zero;
+	__m256i idx, mask;
+	__m256d maskLo, maskHi;
+	__m128i idxLo, idxHi;
+	double lanes[4];
+	double sum, tSum;
+	unsigned int i;
+
+	for(i = 0; i + 8 <= noOfAdjacents; i += 8) {
+		idx = _mm256_loadu_si256((const __m256i *) &adj[i]);
+		mask = _mm256_cmpeq_epi32(_mm256_i32gather_epi32(d, idx, 4), level);
+		if(_mm256_testz_si256(mask, mask))
+			continue;
+
+		idxLo = _mm256_castsi256_si128(idx);
+		idxHi = _mm256_extracti128_si256(idx, 1);
+		maskLo = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(mask)));
+		maskHi = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(mask, 1)));
+		sumLo = _mm256_add_pd(sumLo, _mm256_mask_i32gather_pd(zero, coef, idxLo, maskLo, 8));
+		sumHi = _mm256_add_pd(sumHi, _mm256_mask_i32gather_pd(zero, coef, idxHi, maskHi, 8));
+		if(tau) {
+			tSumLo = _mm256_add_pd(tSumLo, _mm256_and_pd(maskLo, _mm256_add_pd(one, _mm256_mask_i32gather_pd(zero, tau, idxLo, maskLo, 8))));
+			tSumHi = _mm256_add_pd(tSumHi, _mm256_and_pd(maskHi, _mm256_add_pd(one, _mm256_mask_i32gather_pd(zero, tau, idxHi, maskHi, 8))));
+		}
+	}
+
+	_mm256_storeu_pd(lanes, _mm256_add_pd(sumLo, sumHi));
+	sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	if(tau) {
+		_mm256_storeu_pd(lanes, _mm256_add_pd(tSumLo, tSumHi));
+		tSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		*tauSum += tSum;
+	}
+
+	/* Remaining neighbours */
+	return sum + _brandes_sumScalar(&adj[i], noOfAdjacents - i, d, l, coef, tau, tauSum);
+}
+
+/**
+ * @brief Sum coef[w] over the neighbours w of a node that are in level l (its successors), with AVX-512.
+ * @note Sixteen neighbours at a time, as in _brandes_sumAVX2, which takes the remaining ones.
+ * @note This is an internal function.
+ */
+__attribute__((target("avx512f")))
+static double _brandes_sumAVX512(const int *adj, unsigned int noOfAdjacents, const int *d, int l, const double *coef, const double *tau, double *tauSum) {
+	__m512i level = _mm512_set1_epi32(l);
+	__m512d zero = _mm512_setzero_pd();
+	__m512d one = _mm512_set1_pd(1);
+	__m512d sumLo = zero, sumHi = zero, tSumLo = zero, tSumHi = zero;
+	__m512i idx;
+	__m256i idxLo, idxHi;
+	__mmask16 mask;
+	unsigned int i;
+
+	for(i = 0; i + 16 <= noOfAdjacents; i += 16) {
+		idx = _mm512_loadu_si512(&adj[i]);
+		mask = _mm512_cmpeq_epi32_mask(_mm512_i32gather_epi32(idx, d, 4), level);
+		if(!mask)
+			continue;
+
+		idxLo = _mm512_castsi512_si256(idx);
+		idxHi = _mm512_extracti64x4_epi64(idx, 1);
+		sumLo = _mm512_add_pd(sumLo, _mm512_mask_i32gather_pd(zero, (__mmask8) mask, idxLo, coef, 8));
+		sumHi = _mm512_add_pd(sumHi, _mm512_mask_i32gather_pd(zero, (__mmask8) (mask >> 8), idxHi, coef, 8));
+		if(tau) {
+			tSumLo = _mm512_mask_add_pd(tSumLo, (__mmask8) mask, tSumLo, _mm512_add_pd(one, _mm512_mask_i32gather_pd(zero, (__mmask8) mask, idxLo, tau, 8)));
+			tSumHi = _mm512_mask_add_pd(tSumHi, (__mmask8) (mask >> 8), tSumHi, _mm512_add_pd(one, _mm512_mask_i32gather_pd(zero, (__mmask8) (mask >> 8), idxHi, tau, 8)));
+		}
+	}
+
+	if(tau)
+		*tauSum += _mm512_reduce_add_pd(_mm512_add_pd(tSumLo, tSumHi));
+
+	/* Remaining neighbours: masking the last group costs more than a narrower kernel */
+	return _mm512_reduce_add_pd(_mm512_add_pd(sumLo, sumHi)) + _brandes_sumAVX2(&adj[i], noOfAdjacents - i, d, l, coef, tau, tauSum);
+}
+#endif
+
+/* Kernel used by the backward phase, and its name (set once by _brandes_selectKernel) */
+static _brandes_kernel_t _brandes_sumSuccessors = _brandes_sumScalar;
+static const char *_brandes_kernelName = "scalar";
+static pthread_once_t _brandes_kernelOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Choose the widest backward kernel supported by this processor.
+ * @note Kernels gather d and the quotients of the neighbours, masked by their level, with AVX-512 or AVX2 when the
+ *       processor has them. Since sums are then done in another order, results may differ in the last digits from
+ *       other builds and processors.
+ * @note This is an internal function.
+ */
+static void _brandes_selectKernel(void) {
+#ifdef _BRANDES_USE_SIMD
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f")) {
+		_brandes_sumSuccessors = _brandes_sumAVX512;
+		_brandes_kernelName = "avx512";
+	}
+	else if(__builtin_cpu_supports("avx2")) {
+		_brandes_sumSuccessors = _brandes_sumAVX2;
+		_brandes_kernelName = "avx2";
+	}
+#endif
+}
+#endif
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+/**
+ * @brief Atomically add a value to a path count.
+ * @note This is an internal function.
+ */
+static inline void _brandes_atomicAddSigma(brandes_sigma_t *ptr, brandes_sigma_t val) {
+#ifdef BRANDES_USE_REDUCED_PRECISION
+	_brandes_atomicAdd(ptr, val);
+#else
+	__atomic_fetch_add(ptr, val, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * @brief Atomically add a value to a dependency.
+ * @note This is an internal function.
+ */
+static void _brandes_atomicAddDelta(brandes_delta_t *ptr, brandes_delta_t val) {
+	brandes_delta_t old, new;
+
+	__atomic_load(ptr, &old, __ATOMIC_RELAXED);
+	do {
+		new = old + val;
+	} while(!__atomic_compare_exchange(ptr, &old, &new, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* Counters of a BFS level (level-synchronous engine) */
+typedef struct {
+	/* Number of nodes and of hubs (nodes with at least BRANDES_HUB_SZ neighbours) in this level */
+	unsigned int size;
+	unsigned int noOfHubs;
+	/* Offset of the next chunk of nodes to be taken by a thread, in the forward and backward phases */
+	unsigned int nextForward;
+	unsigned int nextBackward;
+} _brandes_level_t;
+
+/* State shared by all threads of the level-synchronous engine */
+typedef struct {
+	graph_t *graph;
+	double *cb;
+	brandes_opts_t *opts;
+	unsigned int noOfThreads;
+	unsigned int noOfSources;
+	/* Threads wait on ready until the team is complete (some threads may fail to be created) */
+	pthread_mutex_t mutex;
+	pthread_cond_t ready;
+	bool isReady;
+	pthread_barrier_t barrier;
+	/* Current source and number of sources started (set by thread 0 between sources) */
+	int s;
+	unsigned int j;
+	bool stop;
+	/* Variables named according to the algorithm in Brandes Algorithm */
+	brandes_sigma_t *sigma;
+	int *d;
+	brandes_delta_t *delta;
+	/* Accumulators of closeness and stress (see brandes_compute) */
+	double *reached;
+	double *tau;
+#ifdef BRANDES_USE_LEVEL_ORDER
+	/* (1 + delta[w]) / sigma[w] of each node w whose dependency is complete */
+	double *coef;
+#endif
+	/* Reached nodes, level after level (S as an array), and reached hubs, level after level */
+	int *order;
+	int *hubs;
+	/* Counters of each level (n + 1 of them), all zero between sources */
+	_brandes_level_t *levels;
+	/* Time when the first source began, and of the last progress report (thread 0 only) */
+	double begin;
+	double lastReport;
+	/* Totals of all threads */
+	unsigned long long edgesTraversed;
+	unsigned long long verticesVisited;
+	int maxDepth;
+	unsigned long long localPages;
+	unsigned long long remotePages;
+} _brandes_team_t;
+
+/* A thread of the level-synchronous engine */
+typedef struct {
+	_brandes_team_t *team;
+	unsigned int id;
+	pthread_t thread;
+	/* Node this thread is pinned to (-1 if not pinned) and graph it reads (the replica of its node, if any) */
+	int node;
+	graph_t *graph;
+	/* Nodes found by this thread, not yet appended to the next level */
+	int found[BRANDES_CHUNK_SZ];
+	unsigned int noOfFound;
+	unsigned long long edgesTraversed;
+	unsigned long long verticesVisited;
+	/* Hardware counters of this thread (thread 0 uses the ones of brandes_compute, NULL if not counted) */
+	perfcnt_t *perfcnt;
+	perfcnt_t ownPerfcnt;
+} _brandes_thread_t;
+
+/**
+ * @brief Append the nodes found by a thread to the next level.
+ * @param next Counters of the next level.
+ * @param base Offset of the next level in team->order.
+ * @note This is an internal function.
+ */
+static void _brandes_flush(_brandes_thread_t *thread, _brandes_level_t *next, unsigned int base) {
+	unsigned int offset;
+
+	if(!(thread->noOfFound))
+		return;
+
+	offset = __atomic_fetch_add(&(next->size), thread->noOfFound, __ATOMIC_RELAXED);
+	memcpy(&(thread->team->order[base + offset]), thread->found, thread->noOfFound * sizeof(int));
+	thread->noOfFound = 0;
+}
+
+/**
+ * @brief Scan part of the adjacency list of a node of level l, claiming undiscovered neighbours for level l + 1
+ *        and adding its path count to its successors.
+ * @param adj Adjacency list of v, scanned from lo to hi.
+ * @param next Counters of level l + 1.
+ * @param base Offset of level l + 1 in team->order.
+ * @param hubBase Offset of level l + 1 in team->hubs.
+ * @note This is an internal function.
+ */
+static void _brandes_expand(_brandes_thread_t *thread, int v, int *adj, unsigned int lo, unsigned int hi, int l, _brandes_level_t *next, unsigned int base, unsigned int hubBase) {
+	_brandes_team_t *team = thread->team;
+	brandes_opts_t *opts = team->opts;
+	int *d = team->d;
+	brandes_sigma_t *sigma = team->sigma;
+	unsigned int i, noOfAdjacents;
+	int w, dw;
+
+	for(i = lo; i < hi; i++) {
+		w = adj[i];
+		dw = __atomic_load_n(&d[w], __ATOMIC_RELAXED);
+
+		/* Only one thread succeeds in claiming w (a failed claim gives the current distance) */
+		if((dw < 0) && __atomic_compare_exchange_n(&d[w], &dw, l + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			dw = l + 1;
+			thread->verticesVisited++;
+
+			thread->found[thread->noOfFound++] = w;
+			if(BRANDES_CHUNK_SZ == thread->noOfFound)
+				_brandes_flush(thread, next, base);
+
+			graph_getAdjacents(thread->graph, w, &noOfAdjacents);
+			if(noOfAdjacents >= BRANDES_HUB_SZ)
+				team->hubs[hubBase + __atomic_fetch_add(&(next->noOfHubs), 1, __ATOMIC_RELAXED)] = w;
+
+			if(opts->closeness) {
+				opts->closeness[w] += dw;
+				team->reached[w]++;
+			}
+			if(opts->harmonic)
+				opts->harmonic[w] += 1.0 / dw;
+		}
+
+		if((l + 1) == dw)
+			_brandes_atomicAddSigma(&sigma[w], sigma[v]);
+	}
+
+	thread->edgesTraversed += hi - lo;
+}
+
+/**
+ * @brief Gather the dependencies of the successors of a node of level l over part of its adjacency list.
+ * @param adj Adjacency list of v, scanned from lo to hi.
+ * @param tauSum Reference to a double where the stress counter is summed (only if stress is computed).
+ * @return The dependency of v on these successors.
+ * @note This is an internal function.
+ */
+static double _brandes_gather(_brandes_team_t *team, int v, int *adj, unsigned int lo, unsigned int hi, int l, double *tauSum) {
+#ifdef BRANDES_USE_LEVEL_ORDER
+	return team->sigma[v] * _brandes_sumSuccessors(&adj[lo], hi - lo, team->d, l + 1, team->coef, team->tau, tauSum);
+#else
+	int *d = team->d;
+	brandes_sigma_t *sigma = team->sigma;
+	brandes_delta_t *delta = team->delta;
+	double sum = 0;
+	unsigned int i;
+	int w;
+
+	for(i = lo; i < hi; i++) {
+		w = adj[i];
+		if((l + 1) == d[w]) {
+			sum += (sigma[v] / ((double) sigma[w])) * (1 + delta[w]);
+			if(team->tau)
+				*tauSum += 1 + team->tau[w];
+		}
+	}
+
+	return sum;
+#endif
+}
+
+/**
+ * @brief Add the dependency of a node (complete) to its centralities.
+ * @note This is an internal function.
+ */
+static void _brandes_finish(_brandes_team_t *team, int w) {
+	brandes_opts_t *opts = team->opts;
+
+	team->cb[w] += team->delta[w];
+	if(opts->stdErr)
+		opts->stdErr[w] += team->delta[w] * team->delta[w];
+	if(opts->stress)
+		opts->stress[w] += team->sigma[w] * team->tau[w];
+#ifdef BRANDES_USE_LEVEL_ORDER
+	team->coef[w] = (1 + team->delta[w]) / team->sigma[w];
+#endif
+}
+
+/**
+ * @brief Start the next source, or stop the team if all sources are done or the deadline has passed.
+ * @note This is an internal function, called by thread 0 while the other threads wait.
+ */
+static void _brandes_next(_brandes_thread_t *thread) {
+	_brandes_team_t *team = thread->team;
+	brandes_opts_t *opts = team->opts;
+	unsigned int noOfAdjacents;
+	int s;
+
+	/* At least one source is always processed */
+	if((team->j == team->noOfSources) || (team->j && _brandes_checkpoint(opts, team->j, team->noOfSources, team->begin, &(team->lastReport)))) {
+		team->stop = true;
+		return;
+	}
+
+	s = opts->sources? opts->sources[team->j] : team->j;
+	team->s = s;
+	team->j++;
+
+	team->sigma[s] = 1;
+	team->d[s] = 0;
+	team->order[0] = s;
+	team->levels[0].size = 1;
+	graph_getAdjacents(thread->graph, s, &noOfAdjacents);
+	if(noOfAdjacents >= BRANDES_HUB_SZ) {
+		team->hubs[0] = s;
+		team->levels[0].noOfHubs = 1;
+	}
+	thread->verticesVisited++;
+}
+
+/**
+ * @brief Thread of the level-synchronous engine: process sources with the other threads until told to stop.
+ * @note This is an internal function.
+ */
+static void *_brandes_run(void *arg) {
+	_brandes_thread_t *thread = arg;
+	_brandes_team_t *team = thread->team;
+	brandes_opts_t *opts = team->opts;
+	stats_t *stats = opts->stats;
+	unsigned int id = thread->id;
+	unsigned int noOfThreads;
+	_brandes_level_t *levels = team->levels;
+	_brandes_level_t *level;
+	unsigned int lo, hi, hubLo, hubHi, finishLo, finishHi;
+	unsigned int chunk, k, noOfLevels, noOfReached, noOfAdjacents;
+	double start = 0, mid = 0;
+	double sum, tauSum;
+	int l, v;
+	int *adj;
+
+	/* Wait until the team is complete: threads beyond it have nothing to do */
+	pthread_mutex_lock(&(team->mutex));
+	while(!(team->isReady))
+		pthread_cond_wait(&(team->ready), &(team->mutex));
+	pthread_mutex_unlock(&(team->mutex));
+	noOfThreads = team->noOfThreads;
+	if(id >= noOfThreads)
+		return NULL;
+
+	thread->node = affinity_pin(opts->affinity, id);
+	thread->graph = (opts->replicas && (thread->node >= 0) && opts->replicas[thread->node])? opts->replicas[thread->node] : team->graph;
+
+	/* Counters only count the thread that opened them: the others open their own, added up after the run */
+	if(!id)
+		thread->perfcnt = opts->perfcnt;
+	else if(opts->perfcnt && perfcnt_open(&(thread->ownPerfcnt)))
+		thread->perfcnt = &(thread->ownPerfcnt);
+
+	/* Each thread resets its own slice of the buffers once (which places it on its node), then only reached nodes are
+	   reset after each source */
+	lo = (team->graph->n * (unsigned long) id) / noOfThreads;
+	hi = (team->graph->n * (unsigned long) (id + 1)) / noOfThreads;
+	for(k = lo; k < hi; k++) {
+		team->sigma[k] = 0;
+		team->d[k] = -1;
+		team->delta[k] = 0;
+		if(team->tau)
+			team->tau[k] = 0;
+	}
+	pthread_barrier_wait(&(team->barrier));
+
+	while(1) {
+		if(!id) {
+			_brandes_next(thread);
+			if(stats)
+				start = stats_now();
+		}
+		pthread_barrier_wait(&(team->barrier));
+		if(team->stop)
+			break;
+		perfcnt_start(thread->perfcnt, PERFCNT_PHASE_FORWARD);
+
+		/* Forward phase: level l (order[lo..hi)) is expanded into level l + 1, placed right after it */
+		lo = 0;
+		hi = 1;
+		hubLo = 0;
+		hubHi = levels[0].noOfHubs;
+		for(l = 0; lo < hi; l++) {
+			level = &levels[l];
+
+			while((chunk = __atomic_fetch_add(&(level->nextForward), BRANDES_CHUNK_SZ, __ATOMIC_RELAXED)) < hi - lo) {
+				for(k = lo + chunk; (k < lo + chunk + BRANDES_CHUNK_SZ) && (k < hi); k++) {
+					v = team->order[k];
+					adj = graph_getAdjacents(thread->graph, v, &noOfAdjacents);
+					if(noOfAdjacents < BRANDES_HUB_SZ)
+						_brandes_expand(thread, v, adj, 0, noOfAdjacents, l, &levels[l + 1], hi, hubHi);
+				}
+			}
+
+			/* Each thread takes its share of every hub */
+			for(k = hubLo; k < hubHi; k++) {
+				v = team->hubs[k];
+				adj = graph_getAdjacents(thread->graph, v, &noOfAdjacents);
+				_brandes_expand(thread, v, adj, (noOfAdjacents * (unsigned long) id) / noOfThreads, (noOfAdjacents * (unsigned long) (id + 1)) / noOfThreads, l, &levels[l + 1], hi, hubHi);
+			}
+
+			_brandes_flush(thread, &levels[l + 1], hi);
+			pthread_barrier_wait(&(team->barrier));
+
+			lo = hi;
+			hi += levels[l + 1].size;
+			hubLo = hubHi;
+			hubHi += levels[l + 1].noOfHubs;
+		}
+		noOfLevels = l;
+		noOfReached = hi;
+
+		perfcnt_stop(thread->perfcnt, PERFCNT_PHASE_FORWARD);
+		if(!id) {
+			if((int) (noOfLevels - 1) > team->maxDepth)
+				team->maxDepth = noOfLevels - 1;
+			if(stats) {
+				mid = stats_now();
+				stats->phaseTime[STATS_PHASE_FORWARD] += mid - start;
+			}
+		}
+		perfcnt_start(thread->perfcnt, PERFCNT_PHASE_BACKWARD);
+
+		/*
+		 * Backward phase: nodes of level l - 1 gather the dependencies of their successors in level l. Each node is
+		 * gathered by a single thread, in adjacency order, except hubs, whose partial sums are added atomically and
+		 * which are finished after the next barrier
+		 */
+		lo = hi - levels[noOfLevels - 1].size;
+		hubLo = hubHi - levels[noOfLevels - 1].noOfHubs;
+#ifdef BRANDES_USE_LEVEL_ORDER
+		/* Nodes of the deepest level have no successors */
+		for(k = lo + ((hi - lo) * (unsigned long) id) / noOfThreads; k < lo + ((hi - lo) * (unsigned long) (id + 1)) / noOfThreads; k++)
+			team->coef[team->order[k]] = 1.0 / team->sigma[team->order[k]];
+		pthread_barrier_wait(&(team->barrier));
+#endif
+		for(l = noOfLevels - 1; l > 0; l--) {
+			finishLo = hubLo;
+			finishHi = hubHi;
+			hi = lo;
+			lo -= levels[l - 1].size;
+			hubHi = hubLo;
+			hubLo -= levels[l - 1].noOfHubs;
+			level = &levels[l - 1];
+
+#ifdef BRANDES_USE_LEVEL_ORDER
+			/* Quotients of the hubs of level l must be ready before they are gathered */
+			if(finishHi > finishLo) {
+				for(k = finishLo + id; k < finishHi; k += noOfThreads)
+					_brandes_finish(team, team->hubs[k]);
+				pthread_barrier_wait(&(team->barrier));
+			}
+#endif
+
+			/* Level 0 is the source itself, which has no dependency */
+			if(l > 1) {
+				while((chunk = __atomic_fetch_add(&(level->nextBackward), BRANDES_CHUNK_SZ, __ATOMIC_RELAXED)) < hi - lo) {
+					for(k = lo + chunk; (k < lo + chunk + BRANDES_CHUNK_SZ) && (k < hi); k++) {
+						v = team->order[k];
+						adj = graph_getAdjacents(thread->graph, v, &noOfAdjacents);
+						if(noOfAdjacents < BRANDES_HUB_SZ) {
+							tauSum = 0;
+							team->delta[v] = _brandes_gather(team, v, adj, 0, noOfAdjacents, l - 1, &tauSum);
+							if(team->tau)
+								team->tau[v] = tauSum;
+							_brandes_finish(team, v);
+						}
+					}
+				}
+
+				for(k = hubLo; k < hubHi; k++) {
+					v = team->hubs[k];
+					adj = graph_getAdjacents(thread->graph, v, &noOfAdjacents);
+					tauSum = 0;
+					sum = _brandes_gather(team, v, adj, (noOfAdjacents * (unsigned long) id) / noOfThreads, (noOfAdjacents * (unsigned long) (id + 1)) / noOfThreads, l - 1, &tauSum);
+					_brandes_atomicAddDelta(&(team->delta[v]), sum);
+					if(team->tau)
+						_brandes_atomicAdd(&(team->tau[v]), tauSum);
+				}
+			}
+
+#ifndef BRANDES_USE_LEVEL_ORDER
+			/* Hubs of level l are complete since the last barrier */
+			for(k = finishLo + id; k < finishHi; k += noOfThreads)
+				_brandes_finish(team, team->hubs[k]);
+#endif
+
+			pthread_barrier_wait(&(team->barrier));
+		}
+
+		perfcnt_stop(thread->perfcnt, PERFCNT_PHASE_BACKWARD);
+		if(!id) {
+			if(stats)
+				stats->phaseTime[STATS_PHASE_BACKWARD] += stats_now() - mid;
+			memset(levels, 0, (noOfLevels + 1) * sizeof(_brandes_level_t));
+		}
+
+		/* Only reached nodes need to be reset for the next source */
+		for(k = (noOfReached * (unsigned long) id) / noOfThreads; k < (noOfReached * (unsigned long) (id + 1)) / noOfThreads; k++) {
+			v = team->order[k];
+			team->sigma[v] = 0;
+			team->d[v] = -1;
+			team->delta[v] = 0;
+			if(team->tau)
+				team->tau[v] = 0;
+		}
+		pthread_barrier_wait(&(team->barrier));
+	}
+
+	__atomic_fetch_add(&(team->edgesTraversed), thread->edgesTraversed, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&(team->verticesVisited), thread->verticesVisited, __ATOMIC_RELAXED);
+
+	if(stats && (thread->node >= 0)) {
+		lo = (team->graph->n * (unsigned long) id) / noOfThreads;
+		hi = (team->graph->n * (unsigned long) (id + 1)) / noOfThreads;
+		_brandes_countPages(opts->affinity, thread->node, thread->graph, &(team->sigma[lo]), &(team->d[lo]), &(team->delta[lo]), hi - lo, &(team->localPages), &(team->remotePages));
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Process sources with the level-synchronous engine.
+ * @param work Working buffers, reserved for n nodes.
+ * @param reached Closeness accumulator (may be NULL).
+ * @param tau Stress accumulator (may be NULL).
+ * @param noOfSourcesDone Reference to a variable where the number of sources processed will be assigned.
+ * @return 0 on success, -1 if memory could not be allocated (nothing is processed in this case).
+ * @note Sources are processed one after the other, each one by all threads: the forward phase expands each BFS level
+ *       in parallel (distances are claimed and path counts added atomically) and the backward phase processes each
+ *       level in parallel, from the deepest one, each node gathering the dependencies of its successors. Adjacency
+ *       lists of nodes with at least BRANDES_HUB_SZ neighbours are split among all threads. Extra memory is O(n) in
+ *       total.
+ * @note This is an internal function.
+ */
+static int _brandes_computeLevels(graph_t *graph, double *cb, brandes_opts_t *opts, brandes_work_t *work, double *reached, double *tau, unsigned int noOfSources, unsigned int *noOfSourcesDone, unsigned long long *edgesTraversed, unsigned long long *verticesVisited, int *maxDepth) {
+	unsigned int n = graph->n;
+	unsigned int i, noOfCreated;
+	_brandes_team_t team;
+	_brandes_thread_t *threads = calloc(opts->noOfThreads, sizeof(_brandes_thread_t));
+
+	memset(&team, 0, sizeof(_brandes_team_t));
+	team.graph = graph;
+	team.cb = cb;
+	team.opts = opts;
+	team.noOfSources = noOfSources;
+	team.sigma = work->sigma;
+	team.d = work->d;
+	team.delta = work->delta;
+	team.reached = reached;
+	team.tau = tau;
+#ifdef BRANDES_USE_LEVEL_ORDER
+	team.coef = work->coef;
+#endif
+	team.order = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+	team.hubs = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+	team.levels = hugemem_calloc((size_t) n + 1, sizeof(_brandes_level_t));
+	if(!threads || !(team.order) || !(team.hubs) || !(team.levels)) {
+		hugemem_free(team.levels);
+		hugemem_free(team.hubs);
+		hugemem_free(team.order);
+		free(threads);
+		return -1;
+	}
+	if(opts->progress)
+		team.begin = team.lastReport = stats_now();
+	pthread_mutex_init(&(team.mutex), NULL);
+	pthread_cond_init(&(team.ready), NULL);
+
+	/* Go on with the threads that could be created */
+	for(i = 0; i < opts->noOfThreads; i++) {
+		threads[i].team = &team;
+		threads[i].id = i;
+	}
+	for(noOfCreated = 1; noOfCreated < opts->noOfThreads; noOfCreated++) {
+		if(pthread_create(&(threads[noOfCreated].thread), NULL, _brandes_run, &threads[noOfCreated]))
+			break;
+	}
+
+	team.noOfThreads = noOfCreated;
+	pthread_barrier_init(&(team.barrier), NULL, noOfCreated);
+	pthread_mutex_lock(&(team.mutex));
+	team.isReady = true;
+	pthread_cond_broadcast(&(team.ready));
+	pthread_mutex_unlock(&(team.mutex));
+
+	_brandes_run(&threads[0]);
+	for(i = 1; i < noOfCreated; i++) {
+		pthread_join(threads[i].thread, NULL);
+		if(threads[i].perfcnt) {
+			perfcnt_add(opts->perfcnt, threads[i].perfcnt);
+			perfcnt_close(threads[i].perfcnt);
+		}
+	}
+	affinity_unpin(opts->affinity);
+
+	pthread_barrier_destroy(&(team.barrier));
+	pthread_cond_destroy(&(team.ready));
+	pthread_mutex_destroy(&(team.mutex));
+
+	*edgesTraversed += team.edgesTraversed;
+	*verticesVisited += team.verticesVisited;
+	if(team.maxDepth > *maxDepth)
+		*maxDepth = team.maxDepth;
+	if(opts->stats) {
+		opts->stats->localPages += team.localPages;
+		opts->stats->remotePages += team.remotePages;
+		_brandes_sampleHugePages(opts->stats);
+	}
+
+	hugemem_free(team.levels);
+	hugemem_free(team.hubs);
+	hugemem_free(team.order);
+	free(threads);
+
+	*noOfSourcesDone = team.j;
+	return 0;
+}
+#endif
+
+/* Accumulators of a thread processing whole sources (see _brandes_source) */
+typedef struct {
+	/* Arrays of n doubles (each one may be NULL if not computed, see brandes_compute) */
+	double *cb;
+	double *stdErr;
+	double *closeness;
+	double *harmonic;
+	double *stress;
+	double *reached;
+	double *tau;
+	/* Whether the arrays above (except tau) are shared among threads, hence updated atomically */
+	bool atomic;
+	/* Weight of each source and linear scaling of dependencies (see brandes_opts_t) */
+	double *weights;
+	bool linear;
+	unsigned long long edgesTraversed;
+	unsigned long long verticesVisited;
+	int maxDepth;
+} _brandes_acc_t;
+
+#ifdef BRANDES_USE_LEVEL_ORDER
+/**
+ * @brief Process a single source, adding its dependencies (and other centralities) to the accumulators.
+ * @param work Working buffers, reserved for n nodes.
+ * @param targets Nodes whose dependencies are wanted (NULL for all nodes, see brandes_opts_t).
+ * @param stats Where the time of the forward and backward phases is accumulated (may be NULL).
+ * @param perfcnt Hardware counters enabled around the forward and backward phases (may be NULL).
+ * @note The backward phase goes level by level, from the deepest one: each node sums (1 + delta[w]) / sigma[w] over
+ *       its successors w, computed once per w, and multiplies the sum by its own sigma. The sum is vectorised (see
+ *       _brandes_selectKernel), so no division is left in the loop over edges.
+ * @note With targets, the backward phase skips the nodes that are neither a target nor below one in the DAG of the
+ *       source (their dependencies never add to the one of a target), and stops at the shallowest target.
+ * @note With weights or linear scaling, dependencies are weighted and scaled as they are added to betweenness (stress
+ *       is left as is). With linear scaling, delta[v] sums sigma[v] / sigma[w] * d[v] / d[w] * (1 + delta[w]) over
+ *       the successors w of v, so that both ends of a pair add up to it once.
+ * @note With BRANDES_USE_REDUCED_PRECISION, delta is kept in single precision and sigma in double precision, so that
+ *       it does not overflow. Accumulators stay in double precision; the relative error of betweenness stays below
+ *       1e-6 on the bundled graphs (see bench/precision.sh).
+ * @note This is an internal function.
+ */
+static void _brandes_source(graph_t *graph, int s, brandes_work_t *work, _brandes_acc_t *acc, const bool *targets, stats_t *stats, perfcnt_t *perfcnt) {
+	double start = 0, mid = 0;
+	double *closeness = acc->closeness;
+	double *harmonic = acc->harmonic;
+	double *stress = acc->stress;
+	double *reached = acc->reached;
+	double *tau = acc->tau;
+	double tauSum;
+	double weight = acc->weights? acc->weights[s] : 1;
+	/* Variables named according to the algorithm in Brandes Algorithm */
+	unsigned int n = graph->n;
+	int t, v, w;
+	brandes_sigma_t *sigma = work->sigma;
+	int *d = work->d;
+	brandes_delta_t *delta = work->delta;
+	/* Q is order[head..tail), S is order[0..tail) read backwards, level l is order[levelStart[l]..levelStart[l + 1]) */
+	int *order = work->order;
+	unsigned int *levelStart = work->levelStart;
+	double *coef = work->coef;
+	bool *marked = work->marked;
+	unsigned int head, tail, k;
+	int l, depth, lowest;
+	int i;
+	unsigned int noOfAdjacents;
+	int *adjacents;
+
+	if(stats)
+		start = stats_now();
+	perfcnt_start(perfcnt, PERFCNT_PHASE_FORWARD);
+
+	for(t = 0; t < n; t++) {
+		sigma[t] = 0;
+		d[t] = -1;
+	}
+	sigma[s] = 1;
+	d[s] = 0;
+
+	/* Targets are marked, then every node below a marked one: the shallowest marked node is the first one dequeued */
+	if(targets) {
+		for(t = 0; t < n; t++)
+			marked[t] = targets[t];
+		marked[s] = false;
+	}
+	lowest = -1;
+
+	/* Nodes leave the queue level after level: a new level begins at the first node one step farther */
+	order[0] = s;
+	head = 0;
+	tail = 1;
+	depth = 0;
+	levelStart[0] = 0;
+
+	while(head < tail) {
+		v = order[head];
+		if(d[v] > depth) {
+			depth = d[v];
+			levelStart[depth] = head;
+		}
+		head++;
+		acc->verticesVisited++;
+		if(targets && (lowest < 0) && marked[v])
+			lowest = d[v];
+
+		if(v != s) {
+			if(closeness) {
+				_brandes_accumulate(acc->atomic, &closeness[v], d[v]);
+				_brandes_accumulate(acc->atomic, &reached[v], 1);
+			}
+			if(harmonic)
+				_brandes_accumulate(acc->atomic, &harmonic[v], 1.0 / d[v]);
+		}
+
+		/* Predecessors are not recorded: the backward phase finds successors by their level instead */
+		adjacents = graph_getAdjacents(graph, v, &noOfAdjacents);
+		acc->edgesTraversed += noOfAdjacents;
+		for(i = 0; i < noOfAdjacents; i++) {
+			w = adjacents[i];
+			if(d[w] < 0) {
+				order[tail++] = w;
+				d[w] = d[v] + 1;
+			}
+
+			if((d[v] + 1) == d[w]) {
+				sigma[w] = sigma[w] + sigma[v];
+				if(targets)
+					marked[w] = marked[w] || marked[v];
+			}
+		}
+	}
+	levelStart[depth + 1] = tail;
+
+	if(depth > acc->maxDepth)
+		acc->maxDepth = depth;
+	/* Levels above the shallowest target are not needed (none at all if no target was reached) */
+	if(!targets)
+		lowest = 0;
+	else if(lowest < 0)
+		lowest = depth + 1;
+
+	perfcnt_stop(perfcnt, PERFCNT_PHASE_FORWARD);
+	if(stats) {
+		mid = stats_now();
+		stats->phaseTime[STATS_PHASE_FORWARD] += mid - start;
+	}
+	perfcnt_start(perfcnt, PERFCNT_PHASE_BACKWARD);
+
+	/*
+	 * delta[v] is the sum of sigma[v] / sigma[w] * (1 + delta[w]) over the successors w of v, i.e. sigma[v] times the
+	 * sum of coef[w] = (1 + delta[w]) / sigma[w], each one computed once, when w is complete. Every node of a level is
+	 * complete once the next level is: the deepest level has no successors. Successors of a marked node are marked too.
+	 * With linear scaling, each term is also multiplied by d[v] / d[w]: coef[w] is divided by d[w], and the sum
+	 * multiplied by d[v] = l (the source, at level 0, has no dependency)
+	 */
+	for(l = depth; l >= lowest; l--) {
+		for(k = levelStart[l]; k < levelStart[l + 1]; k++) {
+			v = order[k];
+			if(targets && !marked[v])
+				continue;
+			tauSum = 0;
+			if(l < depth) {
+				adjacents = graph_getAdjacents(graph, v, &noOfAdjacents);
+				delta[v] = sigma[v] * _brandes_sumSuccessors(adjacents, noOfAdjacents, d, l + 1, coef, tau, &tauSum);
+			}
+			else {
+				delta[v] = 0;
+			}
+			if(acc->linear) {
+				delta[v] *= l;
+				coef[v] = l? ((1 + delta[v]) / (sigma[v] * (double) l)) : 0;
+			}
+			else {
+				coef[v] = (1 + delta[v]) / sigma[v];
+			}
+			if(stress)
+				tau[v] = tauSum;
+
+			if(v != s) {
+				_brandes_accumulate(acc->atomic, &(acc->cb[v]), weight * delta[v]);
+				if(acc->stdErr)
+					_brandes_accumulate(acc->atomic, &(acc->stdErr[v]), (weight * delta[v]) * (weight * delta[v]));
+				if(stress)
+					_brandes_accumulate(acc->atomic, &stress[v], sigma[v] * tau[v]);
+			}
+		}
+	}
+
+	perfcnt_stop(perfcnt, PERFCNT_PHASE_BACKWARD);
+	if(stats)
+		stats->phaseTime[STATS_PHASE_BACKWARD] += stats_now() - mid;
+}
+#else
+/**
+ * @brief Process a single source, adding its dependencies (and other centralities) to the accumulators.
+ * @param work Working buffers, reserved for n nodes.
+ * @param targets Nodes whose dependencies are wanted (NULL for all nodes, see brandes_opts_t).
+ * @param stats Where the time of the forward and backward phases is accumulated (may be NULL).
+ * @param perfcnt Hardware counters enabled around the forward and backward phases (may be NULL).
+ * @note Targets, weights, linear scaling and reduced precision are handled as in the BRANDES_USE_LEVEL_ORDER version.
+ * @note This is an internal function.
+ */
+static void _brandes_source(graph_t *graph, int s, brandes_work_t *work, _brandes_acc_t *acc, const bool *targets, stats_t *stats, perfcnt_t *perfcnt) {
+	double start = 0, mid = 0;
+	double *closeness = acc->closeness;
+	double *harmonic = acc->harmonic;
+	double *stress = acc->stress;
+	double *reached = acc->reached;
+	double *tau = acc->tau;
+	double weight = acc->weights? acc->weights[s] : 1;
+	/* Variables named according to the algorithm in Brandes Algorithm */
+	unsigned int n = graph->n;
+	int t, v, w;
+	list_t *S = work->S;
+	list_t **P = work->P;
+	brandes_sigma_t *sigma = work->sigma;
+	int *d = work->d;
+	brandes_delta_t *delta = work->delta;
+	list_t *Q = work->Q;
+	bool *marked = work->marked;
+#ifdef GRAPH_USE_GET_ADJACENTS
+	int i;
+	unsigned int noOfAdjacents;
+	int *adjacents;
+#endif
+
+	if(stats)
+		start = stats_now();
+	perfcnt_start(perfcnt, PERFCNT_PHASE_FORWARD);
+
+	for(t = 0; t < n; t++) {
+		sigma[t] = 0;
+		d[t] = -1;
+	}
+	sigma[s] = 1;
+	d[s] = 0;
+
+	/* Targets are marked, then every node below a marked one */
+	if(targets) {
+		for(t = 0; t < n; t++)
+			marked[t] = targets[t];
+		marked[s] = false;
+	}
+
+	dlist_pushBack(Q, s);
+
+	while(!dlist_isEmpty(Q)) {
+		v = dlist_front(Q);
+		dlist_popFront(Q);
+		dlist_pushFront(S, v);
+		acc->verticesVisited++;
+
+		if(v != s) {
+			if(closeness) {
+				_brandes_accumulate(acc->atomic, &closeness[v], d[v]);
+				_brandes_accumulate(acc->atomic, &reached[v], 1);
+			}
+			if(harmonic)
+				_brandes_accumulate(acc->atomic, &harmonic[v], 1.0 / d[v]);
+		}
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+		/* Smarter way of getting node neighbours: get all nodes w which are neighbours of v, no checking necessary */
+		adjacents = graph_getAdjacents(graph, v, &noOfAdjacents);
+		acc->edgesTraversed += noOfAdjacents;
+		for(i = 0; i < noOfAdjacents; i++) {
+			w = adjacents[i];
+			{
+#else
+		/* Naive way of getting node neighbours: Get all nodes w and check which are neighbours of v */
+		for(w = 0; w < n; w++) {
+			if(graph_getEdge(graph, v, w)) {
+				acc->edgesTraversed++;
+#endif
+				if(d[w] < 0) {
+					dlist_pushBack(Q, w);
+					d[w] = d[v] + 1;
+				}
+
+				if((d[v] + 1) == d[w]) {
+					sigma[w] = sigma[w] + sigma[v];
+					dlist_pushBack(P[w], v);
+					if(targets)
+						marked[w] = marked[w] || marked[v];
+				}
+			}
+		}
+	}
+
+	/* Last node to leave the queue is the farthest one */
+	if(d[dlist_front(S)] > acc->maxDepth)
+		acc->maxDepth = d[dlist_front(S)];
+
+	perfcnt_stop(perfcnt, PERFCNT_PHASE_FORWARD);
+	if(stats) {
+		mid = stats_now();
+		stats->phaseTime[STATS_PHASE_FORWARD] += mid - start;
+	}
+	perfcnt_start(perfcnt, PERFCNT_PHASE_BACKWARD);
+
+	for(v = 0; v < n; v++)
+		delta[v] = 0;
+	if(stress) {
+		for(v = 0; v < n; v++)
+			tau[v] = 0;
+	}
+
+	while(!dlist_isEmpty(S)) {
+		w = dlist_front(S);
+		dlist_popFront(S);
+
+		/* Dependencies of nodes that are not marked are not needed: their predecessors are only dropped */
+		if(targets && !marked[w]) {
+			while(!dlist_isEmpty(P[w]))
+				dlist_popFront(P[w]);
+			continue;
+		}
+
+		while(!dlist_isEmpty(P[w])) {
+			v = dlist_front(P[w]);
+			dlist_popFront(P[w]);
+
+			/* Linear scaling: the shortest paths from s to w only add d[v] / d[w] of a path to v */
+			if(acc->linear)
+				delta[v] = delta[v] + ((sigma[v] / ((double) sigma[w])) * (d[v] / (double) d[w]) * (1 + delta[w]));
+			else
+				delta[v] = delta[v] + ((sigma[v] / ((double) sigma[w])) * (1 + delta[w]));
+			if(stress)
+				tau[v] += 1 + tau[w];
+		}
+
+		if(w != s) {
+			_brandes_accumulate(acc->atomic, &(acc->cb[w]), weight * delta[w]);
+			if(acc->stdErr)
+				_brandes_accumulate(acc->atomic, &(acc->stdErr[w]), (weight * delta[w]) * (weight * delta[w]));
+			if(stress)
+				_brandes_accumulate(acc->atomic, &stress[w], sigma[w] * tau[w]);
+		}
+	}
+
+	/* Q, S and every P[w] are empty again, ready for the next source */
+
+	perfcnt_stop(perfcnt, PERFCNT_PHASE_BACKWARD);
+	if(stats)
+		stats->phaseTime[STATS_PHASE_BACKWARD] += stats_now() - mid;
+}
+#endif
+
+/* Estimated cost of a source, for sorting */
+typedef struct {
+	unsigned long long cost;
+	unsigned int s;
+} _brandes_cost_t;
+
+/* Sources of a thread of the source scheduler (a range of _brandes_pool_t.order): its owner takes them from the
+   front, other threads steal from the back */
+typedef struct {
+	pthread_mutex_t mutex;
+	unsigned int lo;
+	unsigned int hi;
+} _brandes_deque_t;
+
+/* State shared by all threads of the source scheduler */
+typedef struct {
+	graph_t *graph;
+	brandes_opts_t *opts;
+	unsigned int noOfThreads;
+	unsigned int noOfSources;
+	/* Sources, dealt to the deques */
+	unsigned int *order;
+	_brandes_deque_t *deques;
+	/* Number of sources processed, and whether the deadline has passed */
+	unsigned int noOfSourcesDone;
+	bool stop;
+	/* Time when the threads began */
+	double begin;
+	unsigned long long noOfSteals;
+} _brandes_pool_t;
+
+/* A thread of the source scheduler */
+typedef struct {
+	_brandes_pool_t *pool;
+	unsigned int id;
+	pthread_t thread;
+	/* Working buffers and accumulators (thread 0 uses the ones of brandes_compute, the others their own) */
+	brandes_work_t *work;
+	brandes_work_t ownWork;
+	_brandes_acc_t acc;
+	/* Time of the forward and backward phases of this thread, and time spent processing sources */
+	stats_t stats;
+	double busyTime;
+	/* Node this thread is pinned to (-1 if not pinned) and graph it reads (the replica of its node, if any) */
+	int node;
+	graph_t *graph;
+	/* Hardware counters of this thread (thread 0 uses the ones of brandes_compute, NULL if not counted) */
+	perfcnt_t *perfcnt;
+	perfcnt_t ownPerfcnt;
+	/* Whether its buffers or accumulators could not be allocated (then it processes no source) */
+	bool failed;
+} _brandes_worker_t;
+
+/**
+ * @brief Compare two estimated costs, for qsort: highest costs first, then lowest nodes first.
+ * @note This is an internal function.
+ */
+static int _brandes_compareCosts(const void *a, const void *b) {
+	const _brandes_cost_t *ca = a;
+	const _brandes_cost_t *cb = b;
+
+	if(ca->cost != cb->cost)
+		return (ca->cost < cb->cost)? 1 : -1;
+
+	return (ca->s > cb->s) - (ca->s < cb->s);
+}
+
+/**
+ * @brief Estimate the cost of each node as a source: the size of its connected component (every node of it is
+ *        traversed), then its degree.
+ * @param cost Array of n unsigned long longs to receive the cost of each node.
+ * @return 0 on success, -1 if memory could not be allocated.
+ * @note This is an internal function.
+ */
+static int _brandes_estimateCosts(graph_t *graph, unsigned long long *cost) {
+	unsigned int n = graph->n;
+	int *component = malloc(((size_t) n + 1) * sizeof(int));
+	int *queue = malloc(((size_t) n + 1) * sizeof(int));
+	unsigned int *degree = calloc((size_t) n + 1, sizeof(unsigned int));
+	unsigned int head, tail, size;
+	int s, v, w;
+#ifdef GRAPH_USE_GET_ADJACENTS
+	unsigned int i, noOfAdjacents;
+	int *adjacents;
+#endif
+
+	if(!component || !queue || !degree) {
+		free(degree);
+		free(queue);
+		free(component);
+		return -1;
+	}
+
+	for(v = 0; v < n; v++)
+		component[v] = -1;
+
+	/* Breadth-first search from each node not yet in a component */
+	for(s = 0; s < n; s++) {
+		if(component[s] >= 0)
+			continue;
+
+		component[s] = s;
+		queue[0] = s;
+		for(head = 0, tail = 1; head < tail; head++) {
+			v = queue[head];
+#ifdef GRAPH_USE_GET_ADJACENTS
+			adjacents = graph_getAdjacents(graph, v, &noOfAdjacents);
+			degree[v] = noOfAdjacents;
+			for(i = 0; i < noOfAdjacents; i++) {
+				w = adjacents[i];
+				{
+#else
+			for(w = 0; w < n; w++) {
+				if(graph_getEdge(graph, v, w)) {
+					degree[v]++;
+#endif
+					if(component[w] < 0) {
+						component[w] = s;
+						queue[tail++] = w;
+					}
+				}
+			}
+		}
+
+		/* Nodes of this component are queue[0..tail) */
+		size = tail;
+		for(head = 0; head < size; head++)
+			cost[queue[head]] = (((unsigned long long) size) << 32) | degree[queue[head]];
+	}
+
+	free(degree);
+	free(queue);
+	free(component);
+
+	return 0;
+}
+
+/**
+ * @brief Take sources for a thread of the source scheduler: a chunk from the front of its own deque, or else the
+ *        back half of the deque of another thread.
+ * @param lo Reference to a variable where the start of the range taken (in pool->order) will be assigned.
+ * @param hi Reference to a variable where the end of the range taken will be assigned.
+ * @return true if sources were taken, false if all deques are empty.
+ * @note This is an internal function.
+ */
+static bool _brandes_take(_brandes_pool_t *pool, unsigned int id, unsigned int *lo, unsigned int *hi) {
+	_brandes_deque_t *own = &(pool->deques[id]);
+	_brandes_deque_t *victim;
+	unsigned int i, chunk, mid;
+	bool stolen;
+
+	while(1) {
+		/* Chunks shrink with the deque: large ones early (less locking), single sources at the tail (balance) */
+		pthread_mutex_lock(&(own->mutex));
+		if(own->lo < own->hi) {
+			chunk = ((own->hi - own->lo) / (2 * pool->noOfThreads)) + 1;
+			*lo = own->lo;
+			*hi = own->lo += chunk;
+			pthread_mutex_unlock(&(own->mutex));
+			return true;
+		}
+		pthread_mutex_unlock(&(own->mutex));
+
+		/* Own deque is empty: steal from the next threads, in turn */
+		stolen = false;
+		for(i = 1; (i < pool->noOfThreads) && !stolen; i++) {
+			victim = &(pool->deques[(id + i) % pool->noOfThreads]);
+			pthread_mutex_lock(&(victim->mutex));
+			if(victim->lo < victim->hi) {
+				mid = victim->hi - ((victim->hi - victim->lo + 1) / 2);
+				*lo = mid;
+				*hi = victim->hi;
+				victim->hi = mid;
+				stolen = true;
+			}
+			pthread_mutex_unlock(&(victim->mutex));
+		}
+		if(!stolen)
+			return false;
+
+		__atomic_fetch_add(&(pool->noOfSteals), 1, __ATOMIC_RELAXED);
+		pthread_mutex_lock(&(own->mutex));
+		own->lo = *lo;
+		own->hi = *hi;
+		pthread_mutex_unlock(&(own->mutex));
+	}
+}
+
+/**
+ * @brief Thread of the source scheduler: process sources until all deques are empty or the deadline has passed.
+ * @note This is an internal function.
+ */
+static void *_brandes_work(void *arg) {
+	_brandes_worker_t *worker = arg;
+	_brandes_pool_t *pool = worker->pool;
+	brandes_opts_t *opts = pool->opts;
+	unsigned int n = pool->graph->n;
+	unsigned int lo, hi, k, done;
+	double start, lastReport = pool->begin;
+	bool stop = false;
+
+	worker->node = affinity_pin(opts->affinity, worker->id);
+	worker->graph = (opts->replicas && (worker->node >= 0) && opts->replicas[worker->node])? opts->replicas[worker->node] : pool->graph;
+
+	/* Counters only count the thread that opened them: the others open their own, added up after the run */
+	if(!(worker->id))
+		worker->perfcnt = opts->perfcnt;
+	else if(opts->perfcnt && perfcnt_open(&(worker->ownPerfcnt)))
+		worker->perfcnt = &(worker->ownPerfcnt);
+
+	/* Buffers are allocated (and first written) by the thread using them, which places them on its node */
+	if(!(worker->work)) {
+		brandes_initWork(&(worker->ownWork));
+		worker->work = &(worker->ownWork);
+		if(brandes_reserveWork(&(worker->ownWork), n))
+			worker->failed = true;
+		if(opts->stress && !(worker->acc.tau = hugemem_calloc((size_t) n + 1, sizeof(double))))
+			worker->failed = true;
+	}
+	if(!(worker->acc.cb)) {
+		if(!(worker->acc.cb = hugemem_calloc((size_t) n + 1, sizeof(double))))
+			worker->failed = true;
+		if(opts->stdErr && !(worker->acc.stdErr = hugemem_calloc((size_t) n + 1, sizeof(double))))
+			worker->failed = true;
+		if(opts->closeness) {
+			if(!(worker->acc.closeness = hugemem_calloc((size_t) n + 1, sizeof(double))) || !(worker->acc.reached = hugemem_calloc((size_t) n + 1, sizeof(double))))
+				worker->failed = true;
+		}
+		if(opts->harmonic && !(worker->acc.harmonic = hugemem_calloc((size_t) n + 1, sizeof(double))))
+			worker->failed = true;
+		if(opts->stress && !(worker->acc.stress = hugemem_calloc((size_t) n + 1, sizeof(double))))
+			worker->failed = true;
+	}
+
+	/* Without its memory, a thread leaves its sources to the others, which steal them (they are freed by the caller) */
+	if(worker->failed)
+		return NULL;
+
+	while(!stop && _brandes_take(pool, worker->id, &lo, &hi)) {
+		for(k = lo; (k < hi) && !stop; k++) {
+			start = stats_now();
+			_brandes_source(worker->graph, pool->order[k], worker->work, &(worker->acc), opts->targets, opts->stats? &(worker->stats) : NULL, worker->perfcnt);
+			worker->busyTime += stats_now() - start;
+
+			/* Only thread 0 reports progress */
+			done = __atomic_add_fetch(&(pool->noOfSourcesDone), 1, __ATOMIC_RELAXED);
+			stop = _brandes_checkpoint(opts, done, pool->noOfSources, pool->begin, worker->id? NULL : &lastReport) || __atomic_load_n(&(pool->stop), __ATOMIC_RELAXED);
+		}
+	}
+	if(stop)
+		__atomic_store_n(&(pool->stop), true, __ATOMIC_RELAXED);
+
+	if(opts->stats && (worker->node >= 0))
+		_brandes_countPages(opts->affinity, worker->node, worker->graph, worker->work->sigma, worker->work->d, worker->work->delta, n, &(opts->stats->localPages), &(opts->stats->remotePages));
+
+	return NULL;
+}
+
+/**
+ * @brief Process sources with the source scheduler.
+ * @param acc Accumulators of brandes_compute, used by thread 0 (the calling thread).
+ * @param work Working buffers of brandes_compute, reserved for n nodes, used by thread 0.
+ * @param noOfSourcesDone Reference to a variable where the number of sources processed will be assigned.
+ * @return 0 on success, -1 if memory could not be allocated (nothing is processed in this case).
+ * @note Sources are sorted by estimated cost (size of their connected component, then degree), most expensive first,
+ *       and dealt in turn to per-thread deques. Each thread takes chunks from the front of its own deque, which
+ *       shrink as it empties, and steals the back half of the deque of another thread when its own is empty. With a
+ *       deadline, sources keep their order, so that the ones processed are still a uniform sample. Each thread has
+ *       its own buffers and accumulators (O(n) memory per thread), which are summed at the end. Busy and idle time of
+ *       each thread and the number of steals go to opts->stats.
+ * @note This is an internal function.
+ */
+static int _brandes_computeSources(graph_t *graph, _brandes_acc_t *acc, brandes_opts_t *opts, brandes_work_t *work, unsigned int noOfSources, unsigned int *noOfSourcesDone) {
+	unsigned int n = graph->n;
+	stats_t *stats = opts->stats;
+	_brandes_pool_t pool;
+	_brandes_worker_t *workers = calloc(opts->noOfThreads, sizeof(_brandes_worker_t));
+	_brandes_cost_t *costs = NULL;
+	unsigned long long *nodeCosts = NULL;
+	unsigned int *next = calloc(opts->noOfThreads, sizeof(unsigned int));
+	unsigned int i, j, t, noOfCreated;
+	double wall, forward = 0, backward = 0;
+	int v;
+
+	memset(&pool, 0, sizeof(_brandes_pool_t));
+	pool.graph = graph;
+	pool.opts = opts;
+	pool.noOfThreads = opts->noOfThreads;
+	pool.noOfSources = noOfSources;
+	pool.order = malloc(((size_t) noOfSources + 1) * sizeof(unsigned int));
+	pool.deques = calloc(opts->noOfThreads, sizeof(_brandes_deque_t));
+	if(!workers || !next || !(pool.order) || !(pool.deques)) {
+		free(pool.deques);
+		free(pool.order);
+		free(next);
+		free(workers);
+		return -1;
+	}
+
+	/*
+	 * Most expensive sources first, so that cheap ones fill the tail. With a deadline, sources keep their (random)
+	 * order instead, so that the sources processed when it passes are still a uniform sample. Without memory to
+	 * estimate costs, sources keep their order as well
+	 */
+	if(!(opts->deadline)) {
+		nodeCosts = malloc(((size_t) n + 1) * sizeof(unsigned long long));
+		costs = malloc(((size_t) noOfSources + 1) * sizeof(_brandes_cost_t));
+		if(nodeCosts && costs && !_brandes_estimateCosts(graph, nodeCosts)) {
+			for(j = 0; j < noOfSources; j++) {
+				costs[j].s = opts->sources? opts->sources[j] : j;
+				costs[j].cost = nodeCosts[costs[j].s];
+			}
+			qsort(costs, noOfSources, sizeof(_brandes_cost_t), _brandes_compareCosts);
+		}
+		else {
+			free(costs);
+			costs = NULL;
+		}
+	}
+
+	/* Sources are dealt to the deques in turn, so that each deque gets its share of expensive ones */
+	for(j = 0; j < noOfSources; j++)
+		next[j % pool.noOfThreads]++;
+	for(t = 0, i = 0; t < pool.noOfThreads; t++) {
+		pthread_mutex_init(&(pool.deques[t].mutex), NULL);
+		pool.deques[t].lo = pool.deques[t].hi = i;
+		i += next[t];
+	}
+	for(j = 0; j < noOfSources; j++) {
+		t = j % pool.noOfThreads;
+		pool.order[pool.deques[t].hi++] = costs? costs[j].s : (opts->sources? opts->sources[j] : j);
+	}
+
+	pool.begin = stats_now();
+	for(i = 0; i < pool.noOfThreads; i++) {
+		workers[i].pool = &pool;
+		workers[i].id = i;
+	}
+	workers[0].work = work;
+	workers[0].acc = *acc;
+	for(i = 1; i < pool.noOfThreads; i++) {
+		workers[i].acc.weights = acc->weights;
+		workers[i].acc.linear = acc->linear;
+	}
+
+	/* Shared accumulators: every thread adds to the ones of thread 0, atomically, and only has its own tau */
+	if(opts->sharedAccumulators) {
+		workers[0].acc.atomic = true;
+		for(i = 1; i < pool.noOfThreads; i++) {
+			workers[i].acc = workers[0].acc;
+			workers[i].acc.tau = NULL;
+		}
+	}
+
+	/* Go on with the threads that could be created (their sources are stolen by the others) */
+	for(noOfCreated = 1; noOfCreated < pool.noOfThreads; noOfCreated++) {
+		if(pthread_create(&(workers[noOfCreated].thread), NULL, _brandes_work, &workers[noOfCreated]))
+			break;
+	}
+	_brandes_work(&workers[0]);
+	for(i = 1; i < noOfCreated; i++) {
+		pthread_join(workers[i].thread, NULL);
+		if(workers[i].perfcnt) {
+			perfcnt_add(opts->perfcnt, workers[i].perfcnt);
+			perfcnt_close(workers[i].perfcnt);
+		}
+	}
+	affinity_unpin(opts->affinity);
+	wall = stats_now() - pool.begin;
+	if(stats)
+		_brandes_sampleHugePages(stats);
+
+	/* Sums of the other threads are added to the ones of thread 0, in thread order */
+	acc->edgesTraversed = workers[0].acc.edgesTraversed;
+	acc->verticesVisited = workers[0].acc.verticesVisited;
+	acc->maxDepth = workers[0].acc.maxDepth;
+	for(i = 1; i < noOfCreated; i++) {
+		for(v = 0; (v < n) && !(opts->sharedAccumulators) && !(workers[i].failed); v++) {
+			acc->cb[v] += workers[i].acc.cb[v];
+			if(acc->stdErr)
+				acc->stdErr[v] += workers[i].acc.stdErr[v];
+			if(acc->closeness) {
+				acc->closeness[v] += workers[i].acc.closeness[v];
+				acc->reached[v] += workers[i].acc.reached[v];
+			}
+			if(acc->harmonic)
+				acc->harmonic[v] += workers[i].acc.harmonic[v];
+			if(acc->stress)
+				acc->stress[v] += workers[i].acc.stress[v];
+		}
+		acc->edgesTraversed += workers[i].acc.edgesTraversed;
+		acc->verticesVisited += workers[i].acc.verticesVisited;
+		if(workers[i].acc.maxDepth > acc->maxDepth)
+			acc->maxDepth = workers[i].acc.maxDepth;
+
+		if(!(opts->sharedAccumulators)) {
+			hugemem_free(workers[i].acc.cb);
+			hugemem_free(workers[i].acc.stdErr);
+			hugemem_free(workers[i].acc.closeness);
+			hugemem_free(workers[i].acc.reached);
+			hugemem_free(workers[i].acc.harmonic);
+			hugemem_free(workers[i].acc.stress);
+		}
+		hugemem_free(workers[i].acc.tau);
+		brandes_freeWork(&(workers[i].ownWork));
+	}
+
+	/* Phases overlap among threads: wall time is split between them in proportion to the time spent in each */
+	if(stats) {
+		for(i = 0; i < noOfCreated; i++) {
+			forward += workers[i].stats.phaseTime[STATS_PHASE_FORWARD];
+			backward += workers[i].stats.phaseTime[STATS_PHASE_BACKWARD];
+		}
+		if(forward + backward > 0) {
+			stats->phaseTime[STATS_PHASE_FORWARD] += wall * (forward / (forward + backward));
+			stats->phaseTime[STATS_PHASE_BACKWARD] += wall * (backward / (forward + backward));
+		}
+
+		for(i = 0; (i < noOfCreated) && (i < STATS_MAX_THREADS); i++) {
+			stats->busyTime[i] += workers[i].busyTime;
+			stats->idleTime[i] += wall - workers[i].busyTime;
+		}
+		if(i > stats->noOfThreads)
+			stats->noOfThreads = i;
+		stats->noOfSteals += pool.noOfSteals;
+	}
+
+	for(t = 0; t < pool.noOfThreads; t++)
+		pthread_mutex_destroy(&(pool.deques[t].mutex));
+	free(pool.deques);
+	free(pool.order);
+	free(costs);
+	free(nodeCosts);
+	free(next);
+	free(workers);
+
+	*noOfSourcesDone = pool.noOfSourcesDone;
+	return 0;
+}
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+/**
+ * @brief Whether a computation runs on the level-synchronous engine.
+ * @note This is an internal function.
+ */
+static inline bool _brandes_useLevels(brandes_opts_t *opts) {
+	/* Targets, weights and linear scaling are only handled by _brandes_source */
+	return (opts->noOfThreads > 1) && (BRANDES_SCHEDULE_LEVELS == opts->schedule) && !(opts->targets) && !(opts->weights) && !(opts->linearScaling);
+}
+#endif
+
+#ifndef BRANDES_USE_LEVEL_ORDER
+/**
+ * @brief Estimate the memory taken by values held in integer lists.
+ * @param noOfValues Largest number of values held at once.
+ * @param noOfLists Number of lists holding them.
+ * @note This is an internal function.
+ */
+static unsigned long long _brandes_estimateListValues(unsigned long long noOfValues, unsigned long long noOfLists) {
+#ifdef LIST_USE_UNROLLED
+	/* Every list may have a partially filled node */
+	return ((noOfValues / LIST_UNROLL_SZ) + noOfLists) * _BRANDES_LIST_NODE_SZ;
+#else
+	return noOfValues * _BRANDES_LIST_NODE_SZ;
+#endif
+}
+#endif
+
+/**
+ * @brief Estimate the memory taken by brandes_compute besides the graph and the result arrays.
+ */
+unsigned long long brandes_estimateMemory(unsigned int n, unsigned int m, brandes_opts_t *opts) {
+	unsigned long long nodes = n;
+	unsigned long long work, accumulators, total;
+	unsigned int noOfThreads = opts->noOfThreads? opts->noOfThreads : 1;
+	unsigned int noOfArrays = 1;
+
+#ifdef BRANDES_USE_LEVEL_ORDER
+	/* Working buffers: sigma, d, delta, marked, order, levelStart and coef (no lists) */
+	work = nodes * (sizeof(brandes_sigma_t) + (2 * sizeof(int)) + sizeof(unsigned int) + sizeof(brandes_delta_t) + sizeof(bool) + sizeof(double));
+#else
+	/* Working buffers: sigma, d, delta, marked and the lists, P (one per node) then S and Q */
+	work = nodes * (sizeof(brandes_sigma_t) + sizeof(int) + sizeof(brandes_delta_t) + sizeof(bool) + sizeof(list_t *) + sizeof(list_t) + _BRANDES_MALLOC_OVERHEAD);
+	work += 2 * (sizeof(list_t) + _BRANDES_MALLOC_OVERHEAD);
+#endif
+
+	/* Closeness keeps a count of reaching sources, stress a path counter tau */
+	total = 0;
+	if(opts->closeness)
+		total += nodes * sizeof(double);
+	if(opts->stress)
+		total += nodes * sizeof(double);
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+	/* Level-synchronous engine: lists stay empty, levels are kept in arrays shared by all threads */
+	if(_brandes_useLevels(opts))
+		return total + work + (nodes + 1) * ((2 * sizeof(int)) + sizeof(_brandes_level_t));
+#endif
+
+#ifndef BRANDES_USE_LEVEL_ORDER
+	/* Each edge adds at most one value to a single P list in each source; S and Q hold at most n values each */
+	work += _brandes_estimateListValues(m, nodes) + (2 * _brandes_estimateListValues(nodes, 1));
+#endif
+	if(1 == noOfThreads)
+		return total + work;
+
+	/* Source scheduler: source order, costs and their estimation (connected components) */
+	total += nodes * (sizeof(unsigned int) + sizeof(_brandes_cost_t) + sizeof(unsigned long long) + (2 * sizeof(int)) + sizeof(unsigned int));
+
+	/* Each thread has its own working buffers (and tau), the other threads may have their own accumulators too */
+	total += noOfThreads * work;
+	if(opts->stress)
+		total += (noOfThreads - 1) * nodes * sizeof(double);
+	if(!(opts->sharedAccumulators)) {
+		noOfArrays += (opts->stdErr? 1 : 0) + (opts->closeness? 2 : 0) + (opts->harmonic? 1 : 0) + (opts->stress? 1 : 0);
+		accumulators = noOfArrays * nodes * sizeof(double);
+		total += (noOfThreads - 1) * accumulators;
+	}
+
+	return total;
+}
+
+/**
+ * @brief Compute the betweenness centrality of all nodes of a graph.
+ */
+int brandes_compute(graph_t *graph, double *cb, brandes_opts_t *opts) {
+	/* Auxiliary variables */
+	stats_t *stats = opts->stats;
+	brandes_work_t localWork;
+	brandes_work_t *work = opts->work;
+	_brandes_acc_t acc;
+	double start = 0;
+	double begin = 0, lastReport = 0;
+	double *stdErr = opts->stdErr;
+	double mean, variance;
+	double *closeness = opts->closeness;
+	double *harmonic = opts->harmonic;
+	double *stress = opts->stress;
+	double *reached = NULL;
+	double *tau = NULL;
+	double reachable;
+	/* Variables named according to the algorithm in Brandes Algorithm */
+	unsigned int n = graph->n;
+	unsigned int j;
+	unsigned int noOfSources = opts->sources? opts->noOfSources : n;
+	double scale;
+	int v;
+	int rv = -1;
+
+	if(stats)
+		start = stats_now();
+	if(opts->progress)
+		begin = lastReport = stats_now();
+#ifdef BRANDES_USE_LEVEL_ORDER
+	pthread_once(&_brandes_kernelOnce, _brandes_selectKernel);
+	if(stats)
+		stats->backwardKernel = _brandes_kernelName;
+#endif
+
+	for(v = 0; v < n; v++)
+		cb[v] = 0;
+	/* Sum of squared dependencies first, turned into standard errors at the end */
+	if(stdErr) {
+		for(v = 0; v < n; v++)
+			stdErr[v] = 0;
+	}
+
+	/*
+	 * Graph is undirected, so the distance from s to v is also the distance from v to s: closeness and harmonic
+	 * of v are accumulated over sources as v is reached, which keeps them valid when sources are sampled. Closeness
+	 * holds the sum of distances until the end, and reached counts the sources that reached v
+	 */
+	if(closeness) {
+		if(!(reached = hugemem_alloc(((size_t) n + 1) * sizeof(double))))
+			goto _err;
+		for(v = 0; v < n; v++)
+			closeness[v] = reached[v] = 0;
+	}
+	if(harmonic) {
+		for(v = 0; v < n; v++)
+			harmonic[v] = 0;
+	}
+	/* Stress: tau[v] counts shortest paths from v to the nodes below it in the DAG of s */
+	if(stress) {
+		if(!(tau = hugemem_alloc(((size_t) n + 1) * sizeof(double))))
+			goto _err;
+		for(v = 0; v < n; v++)
+			stress[v] = 0;
+	}
+
+	/* Buffers and lists are allocated once and reused by every source (and by other graphs, if opts->work is set) */
+	if(!work) {
+		brandes_initWork(&localWork);
+		work = &localWork;
+	}
+	if(brandes_reserveWork(work, n))
+		goto _err;
+
+	if(stats)
+		stats->phaseTime[STATS_PHASE_PREPROCESS] += stats_now() - start;
+
+	/* Beginning of Brandes Algorithm */
+
+	acc.cb = cb;
+	acc.stdErr = stdErr;
+	acc.closeness = closeness;
+	acc.harmonic = harmonic;
+	acc.stress = stress;
+	acc.reached = reached;
+	acc.tau = tau;
+	acc.atomic = false;
+	acc.weights = opts->weights;
+	acc.linear = opts->linearScaling;
+	acc.edgesTraversed = 0;
+	acc.verticesVisited = 0;
+	acc.maxDepth = 0;
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+	if(_brandes_useLevels(opts)) {
+		if(_brandes_computeLevels(graph, cb, opts, work, reached, tau, noOfSources, &j, &(acc.edgesTraversed), &(acc.verticesVisited), &(acc.maxDepth)))
+			goto _err;
+	}
+	else
+#endif
+	if(opts->noOfThreads > 1) {
+		if(_brandes_computeSources(graph, &acc, opts, work, noOfSources, &j))
+			goto _err;
+	}
+	else {
+		for(j = 0; j < noOfSources; j++) {
+			_brandes_source(graph, opts->sources? opts->sources[j] : j, work, &acc, opts->targets, stats, opts->perfcnt);
+
+			/* At least one source is always processed */
+			if(_brandes_checkpoint(opts, j + 1, noOfSources, begin, &lastReport)) {
+				j++;
+				break;
+			}
+		}
+	}
+	noOfSources = j;
+	opts->noOfSourcesDone = noOfSources;
+	if(stats)
+		_brandes_sampleHugePages(stats);
+
+	/*
+	 * Each source s gives a dependency delta_s(v), and the estimate is the mean dependency times n / 2 (n with linear
+	 * scaling). The standard error of this mean, sampling without replacement, is sqrt(variance / k * (1 - k / n))
+	 * for k sources, which is 0 when all nodes are sources
+	 */
+	if(stdErr) {
+		for(v = 0; v < n; v++) {
+			mean = cb[v] / noOfSources;
+			variance = (noOfSources > 1)? ((stdErr[v] - noOfSources * mean * mean) / (noOfSources - 1)) : 0;
+			stdErr[v] = (variance > 0)? ((opts->linearScaling? n : (n / 2.0)) * sqrt((variance / noOfSources) * (1 - noOfSources / (double) n))) : 0;
+		}
+	}
+
+	/*
+	 * Every pair was accounted twice, once from each end; sampled sources are extrapolated to all nodes. With linear
+	 * scaling, both ends of a pair share it instead (d(s, v) / d(s, t) + d(t, v) / d(s, t) = 1)
+	 */
+	scale = (noOfSources && (noOfSources < n))? (n / (2.0 * noOfSources)) : 0.5;
+	for(v = 0; v < n; v++)
+		cb[v] *= opts->linearScaling? (2 * scale) : scale;
+	if(stress) {
+		for(v = 0; v < n; v++)
+			stress[v] *= scale;
+	}
+
+	/* Closeness and harmonic are sums over sources, not pairs: they are only extrapolated */
+	scale *= 2;
+	if(harmonic) {
+		for(v = 0; v < n; v++)
+			harmonic[v] *= scale;
+	}
+	if(closeness) {
+		for(v = 0; v < n; v++) {
+			reachable = reached[v] * scale;
+			closeness[v] = (closeness[v] > 0)? ((reachable / (n - 1)) * (reachable / (closeness[v] * scale))) : 0;
+		}
+	}
+
+	if(stats) {
+		stats->edgesTraversed += acc.edgesTraversed;
+		stats->verticesVisited += acc.verticesVisited;
+		if((unsigned int) acc.maxDepth > stats->maxDepth)
+			stats->maxDepth = acc.maxDepth;
+	}
+
+	rv = 0;
+
+_err:
+
+	hugemem_free(tau);
+	hugemem_free(reached);
+
+	if(work == &localWork)
+		brandes_freeWork(work);
+
+	return rv;
+}
+
+/* Pair of a pair computation, oriented: dependencies of the shortest paths from s to t are accumulated */
+typedef struct {
+	unsigned int s;
+	unsigned int t;
+} _brandes_pair_t;
+
+/* State shared by all threads of a pair computation */
+typedef struct {
+	graph_t *graph;
+	brandes_opts_t *opts;
+	/* Pairs sorted by source then target, and offset of each group of pairs with the same source (noOfGroups + 1) */
+	_brandes_pair_t *pairs;
+	unsigned int *groups;
+	unsigned int noOfGroups;
+	/* Next group to be taken */
+	unsigned int next;
+} _brandes_pairPool_t;
+
+/*
+ * A thread of a pair computation. A bidirectional search has two sides, 0 from the source and 1 from the target, each
+ * with its own distances, path counts, number of shortest paths from each node to the other end (rho) and reached
+ * nodes in BFS order, level l being order[levelStart[l]..levelStart[l + 1]). A single search uses side 0 only, rho
+ * holding (mult[w] + delta[w]) / sigma[w] as coef does in _brandes_source
+ */
+typedef struct {
+	_brandes_pairPool_t *pool;
+	unsigned int id;
+	pthread_t thread;
+	graph_t *graph;
+	/* Betweenness (thread 0 uses the one of brandes_computePairs, the others their own) */
+	double *cb;
+	int *d[2];
+	double *sigma[2];
+	double *rho[2];
+	int *order[2];
+	unsigned int *levelStart[2];
+	/* Number of times each node is a target of the current source */
+	unsigned int *mult;
+	/* Neighbours of a node, when they are not stored as lists */
+	int *adjacents;
+	/* Time of the searches (forward) and of the accumulation of dependencies (backward) of this thread */
+	stats_t stats;
+	unsigned long long edgesTraversed;
+	unsigned long long verticesVisited;
+	int maxDepth;
+} _brandes_pairWorker_t;
+
+/**
+ * @brief Compare two pairs, for qsort: by source, then by target.
+ * @note This is an internal function.
+ */
+static int _brandes_comparePairs(const void *a, const void *b) {
+	const _brandes_pair_t *pa = a;
+	const _brandes_pair_t *pb = b;
+
+	if(pa->s != pb->s)
+		return (pa->s < pb->s)? -1 : 1;
+	if(pa->t != pb->t)
+		return (pa->t < pb->t)? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Get the neighbours of a node.
+ * @param buffer Array of n ints, filled when neighbours are not stored as lists.
+ * @note This is an internal function.
+ */
+static inline int *_brandes_neighbours(graph_t *graph, int v, int *buffer, unsigned int *noOfAdjacents) {
+#ifdef GRAPH_USE_GET_ADJACENTS
+	return graph_getAdjacents(graph, v, noOfAdjacents);
+#else
+	unsigned int w;
+
+	*noOfAdjacents = 0;
+	for(w = 0; w < graph->n; w++) {
+		if(graph_getEdge(graph, v, w))
+			buffer[(*noOfAdjacents)++] = w;
+	}
+
+	return buffer;
+#endif
+}
+
+/**
+ * @brief Start a side of a search at a node.
+ * @note This is an internal function.
+ */
+static void _brandes_startSide(_brandes_pairWorker_t *worker, int side, int s) {
+	worker->d[side][s] = 0;
+	worker->sigma[side][s] = 1;
+	worker->order[side][0] = s;
+	worker->levelStart[side][0] = 0;
+	worker->levelStart[side][1] = 1;
+}
+
+/**
+ * @brief Expand the deepest level l of a side of a search, counting shortest paths to the nodes of level l + 1.
+ * @return Number of nodes of level l + 1.
+ * @note This is an internal function.
+ */
+static unsigned int _brandes_expandSide(_brandes_pairWorker_t *worker, int side, int l) {
+	int *d = worker->d[side];
+	double *sigma = worker->sigma[side];
+	int *order = worker->order[side];
+	unsigned int *levelStart = worker->levelStart[side];
+	unsigned int k, tail = levelStart[l + 1];
+	unsigned int i, noOfAdjacents;
+	int *adjacents;
+	int v, w;
+
+	for(k = levelStart[l]; k < levelStart[l + 1]; k++) {
+		v = order[k];
+		adjacents = _brandes_neighbours(worker->graph, v, worker->adjacents, &noOfAdjacents);
+		worker->edgesTraversed += noOfAdjacents;
+		for(i = 0; i < noOfAdjacents; i++) {
+			w = adjacents[i];
+			if(d[w] < 0) {
+				order[tail++] = w;
+				d[w] = l + 1;
+				sigma[w] = 0;
+			}
+
+			if((l + 1) == d[w])
+				sigma[w] += sigma[v];
+		}
+	}
+	levelStart[l + 2] = tail;
+	worker->verticesVisited += tail - levelStart[l + 1];
+
+	return tail - levelStart[l + 1];
+}
+
+/**
+ * @brief Count, for each node of levels 1 to l - 1 of a side, the shortest paths from it to the other end, from the
+ *        ones of level l (already set).
+ * @note This is an internal function.
+ */
+static void _brandes_countToEnd(_brandes_pairWorker_t *worker, int side, int l) {
+	int *d = worker->d[side];
+	double *rho = worker->rho[side];
+	int *order = worker->order[side];
+	unsigned int *levelStart = worker->levelStart[side];
+	unsigned int i, k, noOfAdjacents;
+	int *adjacents;
+	double sum;
+
+	for(l--; l > 0; l--) {
+		for(k = levelStart[l]; k < levelStart[l + 1]; k++) {
+			adjacents = _brandes_neighbours(worker->graph, order[k], worker->adjacents, &noOfAdjacents);
+			sum = 0;
+			for(i = 0; i < noOfAdjacents; i++) {
+				if((l + 1) == d[adjacents[i]])
+					sum += rho[adjacents[i]];
+			}
+			rho[order[k]] = sum;
+		}
+	}
+}
+
+/**
+ * @brief Accumulate the dependencies of a single pair with a bidirectional BFS.
+ * @param mult Number of times the pair is listed.
+ * @note This is an internal function.
+ */
+static void _brandes_pairBidirectional(_brandes_pairWorker_t *worker, int s, int t, unsigned int mult) {
+	double start = 0, mid = 0;
+	double *cb = worker->cb;
+	int depth[2] = {0, 0};
+	double paths = 0;
+	unsigned int k, size[2];
+	int x, y, side, l, v;
+
+	if(worker->pool->opts->stats)
+		start = stats_now();
+
+	_brandes_startSide(worker, 0, s);
+	_brandes_startSide(worker, 1, t);
+	worker->verticesVisited += 2;
+
+	/*
+	 * Each step expands a whole level of the side with the smallest one. The first nodes reached by both sides are all
+	 * on the new level of the side just expanded and on the deepest level of the other side (otherwise they would have
+	 * met before): every shortest path goes through exactly one of them, which counts sigma[0] * sigma[1] paths
+	 */
+	x = 0;
+	while(!paths) {
+		size[0] = worker->levelStart[0][depth[0] + 1] - worker->levelStart[0][depth[0]];
+		size[1] = worker->levelStart[1][depth[1] + 1] - worker->levelStart[1][depth[1]];
+		x = (size[0] <= size[1])? 0 : 1;
+		y = 1 - x;
+
+		/* A side that runs out of nodes has reached its whole component, without the other end */
+		if(!_brandes_expandSide(worker, x, depth[x]))
+			break;
+		depth[x]++;
+
+		for(k = worker->levelStart[x][depth[x]]; k < worker->levelStart[x][depth[x] + 1]; k++) {
+			v = worker->order[x][k];
+			if(worker->d[y][v] >= 0)
+				paths += worker->sigma[x][v] * worker->sigma[y][v];
+		}
+	}
+
+	if(worker->pool->opts->stats) {
+		mid = stats_now();
+		worker->stats.phaseTime[STATS_PHASE_FORWARD] += mid - start;
+	}
+
+	/* Nodes of the deepest level of each side lead to the other end only if they are meeting nodes */
+	if(paths) {
+		if((depth[0] + depth[1]) > worker->maxDepth)
+			worker->maxDepth = depth[0] + depth[1];
+
+		for(side = 0; side < 2; side++) {
+			for(k = worker->levelStart[side][depth[side]]; k < worker->levelStart[side][depth[side] + 1]; k++) {
+				v = worker->order[side][k];
+				worker->rho[side][v] = (worker->d[1 - side][v] >= 0)? worker->sigma[1 - side][v] : 0;
+			}
+			_brandes_countToEnd(worker, side, depth[side]);
+		}
+
+		/* A node on a shortest path gets the fraction of paths through it; meeting nodes are counted on side x only */
+		for(side = 0; side < 2; side++) {
+			for(l = 1; l <= ((side == x)? depth[side] : (depth[side] - 1)); l++) {
+				for(k = worker->levelStart[side][l]; k < worker->levelStart[side][l + 1]; k++) {
+					v = worker->order[side][k];
+					if(worker->rho[side][v] && (v != s) && (v != t))
+						cb[v] += mult * ((worker->sigma[side][v] * worker->rho[side][v]) / paths);
+				}
+			}
+		}
+	}
+
+	/* Only the nodes reached are reset */
+	for(side = 0; side < 2; side++) {
+		for(k = 0; k < worker->levelStart[side][depth[side] + 1]; k++)
+			worker->d[side][worker->order[side][k]] = -1;
+	}
+
+	if(worker->pool->opts->stats)
+		worker->stats.phaseTime[STATS_PHASE_BACKWARD] += stats_now() - mid;
+}
+
+/**
+ * @brief Accumulate the dependencies of a group of pairs with the same source with a single BFS, which stops at the
+ *        level of the farthest target.
+ * @param pairs Pairs of the group, sorted by target.
+ * @note This is an internal function.
+ */
+static void _brandes_pairSingle(_brandes_pairWorker_t *worker, _brandes_pair_t *pairs, unsigned int noOfPairs) {
+	double start = 0, mid = 0;
+	double *cb = worker->cb;
+	int *d = worker->d[0];
+	double *sigma = worker->sigma[0];
+	double *coef = worker->rho[0];
+	int *order = worker->order[0];
+	unsigned int *levelStart = worker->levelStart[0];
+	unsigned int *mult = worker->mult;
+	unsigned int remaining = 0;
+	unsigned int i, k, noOfAdjacents;
+	int *adjacents;
+	int depth = 0;
+	int l, v;
+	double sum, delta;
+
+	if(worker->pool->opts->stats)
+		start = stats_now();
+
+	for(i = 0; i < noOfPairs; i++) {
+		if(!(mult[pairs[i].t]++))
+			remaining++;
+	}
+
+	_brandes_startSide(worker, 0, pairs[0].s);
+	worker->verticesVisited++;
+
+	/* Shortest path counts of the nodes of a level are complete once the level above is expanded */
+	while(remaining && _brandes_expandSide(worker, 0, depth)) {
+		depth++;
+		for(k = levelStart[depth]; k < levelStart[depth + 1]; k++) {
+			if(mult[order[k]])
+				remaining--;
+		}
+	}
+
+	if(depth > worker->maxDepth)
+		worker->maxDepth = depth;
+
+	if(worker->pool->opts->stats) {
+		mid = stats_now();
+		worker->stats.phaseTime[STATS_PHASE_FORWARD] += mid - start;
+	}
+
+	/*
+	 * Same as _brandes_source, each target w adding mult[w] to the dependencies above it instead of 1. Nodes of the
+	 * deepest level have no successors in the search; nodes below no target have a null coefficient
+	 */
+	for(l = depth; l > 0; l--) {
+		for(k = levelStart[l]; k < levelStart[l + 1]; k++) {
+			v = order[k];
+			sum = 0;
+			if(l < depth) {
+				adjacents = _brandes_neighbours(worker->graph, v, worker->adjacents, &noOfAdjacents);
+				for(i = 0; i < noOfAdjacents; i++) {
+					if((l + 1) == d[adjacents[i]])
+						sum += coef[adjacents[i]];
+				}
+			}
+			delta = sigma[v] * sum;
+			coef[v] = (mult[v] + delta) / sigma[v];
+			cb[v] += delta;
+		}
+	}
+
+	for(k = 0; k < levelStart[depth + 1]; k++)
+		d[order[k]] = -1;
+	for(i = 0; i < noOfPairs; i++)
+		mult[pairs[i].t] = 0;
+
+	if(worker->pool->opts->stats)
+		worker->stats.phaseTime[STATS_PHASE_BACKWARD] += stats_now() - mid;
+}
+
+/**
+ * @brief Thread of a pair computation: process groups of pairs until there are none left.
+ * @note This is an internal function.
+ */
+static void *_brandes_pairWork(void *arg) {
+	_brandes_pairWorker_t *worker = arg;
+	_brandes_pairPool_t *pool = worker->pool;
+	brandes_opts_t *opts = pool->opts;
+	unsigned int n = pool->graph->n;
+	_brandes_pair_t *pairs;
+	unsigned int g, i, j, noOfPairs, noOfTargets;
+	int side, node, v;
+
+	node = affinity_pin(opts->affinity, worker->id);
+	worker->graph = (opts->replicas && (node >= 0) && opts->replicas[node])? opts->replicas[node] : pool->graph;
+
+	/* Buffers are allocated (and first written) by the thread using them, which places them on its node */
+	for(side = 0; side < 2; side++) {
+		worker->d[side] = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+		worker->sigma[side] = hugemem_alloc(((size_t) n + 1) * sizeof(double));
+		worker->rho[side] = hugemem_alloc(((size_t) n + 1) * sizeof(double));
+		worker->order[side] = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+		worker->levelStart[side] = hugemem_alloc(((size_t) n + 2) * sizeof(unsigned int));
+		for(v = 0; v < n; v++)
+			worker->d[side][v] = -1;
+	}
+	worker->mult = hugemem_calloc((size_t) n + 1, sizeof(unsigned int));
+#ifdef GRAPH_USE_GET_ADJACENTS
+	worker->adjacents = NULL;
+#else
+	worker->adjacents = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+#endif
+	if(!(worker->cb))
+		worker->cb = hugemem_calloc((size_t) n + 1, sizeof(double));
+
+	/* Few targets are searched pair by pair (repeated pairs once), many with a single search from the source */
+	while((g = __atomic_fetch_add(&(pool->next), 1, __ATOMIC_RELAXED)) < pool->noOfGroups) {
+		pairs = &(pool->pairs[pool->groups[g]]);
+		noOfPairs = pool->groups[g + 1] - pool->groups[g];
+
+		noOfTargets = 1;
+		for(i = 1; i < noOfPairs; i++) {
+			if(pairs[i].t != pairs[i - 1].t)
+				noOfTargets++;
+		}
+
+		if(noOfTargets > BRANDES_BIDIR_MAX) {
+			_brandes_pairSingle(worker, pairs, noOfPairs);
+		}
+		else {
+			for(i = 0; i < noOfPairs; i = j) {
+				for(j = i + 1; (j < noOfPairs) && (pairs[j].t == pairs[i].t); j++);
+				_brandes_pairBidirectional(worker, pairs[i].s, pairs[i].t, j - i);
+			}
+		}
+	}
+
+	for(side = 0; side < 2; side++) {
+		hugemem_free(worker->levelStart[side]);
+		hugemem_free(worker->order[side]);
+		hugemem_free(worker->rho[side]);
+		hugemem_free(worker->sigma[side]);
+		hugemem_free(worker->d[side]);
+	}
+	hugemem_free(worker->mult);
+	hugemem_free(worker->adjacents);
+
+	return NULL;
+}
+
+/**
+ * @brief Compute the betweenness of all nodes over a list of node pairs.
+ */
+void brandes_computePairs(graph_t *graph, unsigned int *pairs, unsigned int noOfPairs, double *cb, brandes_opts_t *opts) {
+	stats_t *stats = opts->stats;
+	_brandes_pairPool_t pool;
+	_brandes_pairWorker_t *workers;
+	unsigned int *count;
+	unsigned int n = graph->n;
+	unsigned int noOfThreads = opts->noOfThreads? opts->noOfThreads : 1;
+	unsigned int i, k, a, b, noOfCreated;
+	double start = 0, wall, forward = 0, backward = 0;
+	int v;
+
+	if(stats)
+		start = stats_now();
+
+	for(v = 0; v < n; v++)
+		cb[v] = 0;
+
+	/*
+	 * Each pair is searched from the end that is in more pairs, so that pairs sharing an end are grouped as much as
+	 * possible; pairs of a node with itself have no path through other nodes
+	 */
+	count = calloc((size_t) n + 1, sizeof(unsigned int));
+	for(i = 0; i < noOfPairs; i++) {
+		if(pairs[2 * i] != pairs[2 * i + 1]) {
+			count[pairs[2 * i]]++;
+			count[pairs[2 * i + 1]]++;
+		}
+	}
+
+	pool.pairs = malloc(((size_t) noOfPairs + 1) * sizeof(_brandes_pair_t));
+	for(i = 0, k = 0; i < noOfPairs; i++) {
+		a = pairs[2 * i];
+		b = pairs[2 * i + 1];
+		if(a == b)
+			continue;
+		if((count[a] > count[b]) || ((count[a] == count[b]) && (a < b))) {
+			pool.pairs[k].s = a;
+			pool.pairs[k].t = b;
+		}
+		else {
+			pool.pairs[k].s = b;
+			pool.pairs[k].t = a;
+		}
+		k++;
+	}
+	qsort(pool.pairs, k, sizeof(_brandes_pair_t), _brandes_comparePairs);
+	free(count);
+
+	pool.groups = malloc(((size_t) k + 1) * sizeof(unsigned int));
+	pool.noOfGroups = 0;
+	for(i = 0; i < k; i++) {
+		if(!i || (pool.pairs[i].s != pool.pairs[i - 1].s))
+			pool.groups[pool.noOfGroups++] = i;
+	}
+	pool.groups[pool.noOfGroups] = k;
+	pool.graph = graph;
+	pool.opts = opts;
+	pool.next = 0;
+
+	if(noOfThreads > pool.noOfGroups)
+		noOfThreads = pool.noOfGroups? pool.noOfGroups : 1;
+	workers = calloc(noOfThreads, sizeof(_brandes_pairWorker_t));
+	for(i = 0; i < noOfThreads; i++) {
+		workers[i].pool = &pool;
+		workers[i].id = i;
+		stats_reset(&(workers[i].stats));
+	}
+	workers[0].cb = cb;
+
+	if(stats)
+		stats->phaseTime[STATS_PHASE_PREPROCESS] += stats_now() - start;
+	start = stats_now();
+
+	/* Go on with the threads that could be created (their groups are taken by the others) */
+	for(noOfCreated = 1; noOfCreated < noOfThreads; noOfCreated++) {
+		if(pthread_create(&(workers[noOfCreated].thread), NULL, _brandes_pairWork, &workers[noOfCreated]))
+			break;
+	}
+	_brandes_pairWork(&workers[0]);
+	for(i = 1; i < noOfCreated; i++)
+		pthread_join(workers[i].thread, NULL);
+	affinity_unpin(opts->affinity);
+	wall = stats_now() - start;
+
+	/* Sums of the other threads are added to the ones of thread 0, in thread order */
+	for(i = 1; i < noOfCreated; i++) {
+		for(v = 0; v < n; v++)
+			cb[v] += workers[i].cb[v];
+		hugemem_free(workers[i].cb);
+	}
+
+	/* Phases overlap among threads: wall time is split between them in proportion to the time spent in each */
+	if(stats) {
+		for(i = 0; i < noOfCreated; i++) {
+			forward += workers[i].stats.phaseTime[STATS_PHASE_FORWARD];
+			backward += workers[i].stats.phaseTime[STATS_PHASE_BACKWARD];
+			stats->edgesTraversed += workers[i].edgesTraversed;
+			stats->verticesVisited += workers[i].verticesVisited;
+			if((unsigned int) workers[i].maxDepth > stats->maxDepth)
+				stats->maxDepth = workers[i].maxDepth;
+		}
+		if(forward + backward > 0) {
+			stats->phaseTime[STATS_PHASE_FORWARD] += wall * (forward / (forward + backward));
+			stats->phaseTime[STATS_PHASE_BACKWARD] += wall * (backward / (forward + backward));
+		}
+	}
+
+	free(workers);
+	free(pool.groups);
+	free(pool.pairs);
+}
+
+/**
+ * @brief Choose sampled sources (pivots) of a betweenness estimate, and the weights that keep it unbiased.
+ */
+unsigned int brandes_selectPivots(graph_t *graph, unsigned int *sources, double *weights, unsigned int k, int strategy, unsigned long seed) {
+	unsigned int n = graph->n;
+	unsigned int i, lo, hi, mid, noOfPivots = 0;
+	unsigned int noOfAdjacents;
+	unsigned long long total;
+	unsigned long long *cumulative;
+	uint64_t state = seed;
+	uint64_t r;
+	int *buffer = NULL;
+	int *adjacents;
+	int *dist, *order;
+	unsigned int head, tail;
+	int v, w, farthest;
+
+	if(k > n)
+		k = n;
+	if(!k)
+		return 0;
+	for(v = 0; v < n; v++)
+		weights[v] = 1;
+#ifndef GRAPH_USE_GET_ADJACENTS
+	buffer = malloc(((size_t) n + 1) * sizeof(int));
+#endif
+
+	if(BRANDES_PIVOTS_DEGREE == strategy) {
+		/* Draws pick a position among the 2m edge ends, found by binary search on the cumulative degrees */
+		cumulative = malloc(((size_t) n + 1) * sizeof(unsigned long long));
+		for(v = 0, total = 0; v < n; v++) {
+			_brandes_neighbours(graph, v, buffer, &noOfAdjacents);
+			total += noOfAdjacents;
+			cumulative[v] = total;
+		}
+
+		if(total) {
+			/* Weights count the draws of each node first */
+			for(v = 0; v < n; v++)
+				weights[v] = 0;
+			for(i = 0; i < k; i++) {
+				r = _brandes_random(&state) % total;
+				for(lo = 0, hi = n - 1; lo < hi;) {
+					mid = lo + ((hi - lo) / 2);
+					if(cumulative[mid] > r)
+						hi = mid;
+					else
+						lo = mid + 1;
+				}
+				weights[lo] += 1;
+			}
+
+			for(v = 0; v < n; v++) {
+				if(weights[v] > 0)
+					sources[noOfPivots++] = v;
+			}
+			/* Node v was drawn with probability deg(v) / 2m */
+			for(i = 0; i < noOfPivots; i++) {
+				v = sources[i];
+				weights[v] *= (noOfPivots * (double) total) / (n * (double) k * (cumulative[v] - (v? cumulative[v - 1] : 0)));
+			}
+			/* Nodes that were never drawn keep weight 1, if ever used */
+			for(v = 0; v < n; v++) {
+				if(weights[v] <= 0)
+					weights[v] = 1;
+			}
+		}
+		free(cumulative);
+
+		/* Without edges, every node has probability 0: pivots are uniform instead */
+		if(!total)
+			strategy = BRANDES_PIVOTS_UNIFORM;
+	}
+
+	if(BRANDES_PIVOTS_MAXMIN == strategy) {
+		/* dist[v] is the distance from v to the closest pivot so far, -1 if no pivot reaches it (infinite) */
+		dist = malloc(((size_t) n + 1) * sizeof(int));
+		order = malloc(((size_t) n + 1) * sizeof(int));
+		for(v = 0; v < n; v++)
+			dist[v] = -1;
+		farthest = _brandes_random(&state) % n;
+
+		while(noOfPivots < k) {
+			sources[noOfPivots++] = farthest;
+
+			/* BFS from the new pivot, through the nodes it gets closer to only: the others keep their distance */
+			dist[farthest] = 0;
+			order[0] = farthest;
+			for(head = 0, tail = 1; head < tail; head++) {
+				v = order[head];
+				adjacents = _brandes_neighbours(graph, v, buffer, &noOfAdjacents);
+				for(i = 0; i < noOfAdjacents; i++) {
+					w = adjacents[i];
+					if((dist[w] < 0) || (dist[w] > dist[v] + 1)) {
+						dist[w] = dist[v] + 1;
+						order[tail++] = w;
+					}
+				}
+			}
+
+			/* Next pivot: an unreached node, else the farthest one from all pivots; none left if all are pivots */
+			for(v = 0, farthest = -1; v < n; v++) {
+				if(dist[v] < 0) {
+					farthest = v;
+					break;
+				}
+				if(dist[v] && ((farthest < 0) || (dist[v] > dist[farthest])))
+					farthest = v;
+			}
+			if(farthest < 0)
+				break;
+		}
+
+		free(dist);
+		free(order);
+	}
+	else if(BRANDES_PIVOTS_UNIFORM == strategy) {
+		/* First k nodes of a random permutation: the rest of the array is only a scratch area */
+		brandes_permuteSources(sources, n, seed);
+		noOfPivots = k;
+	}
+
+	free(buffer);
+
+	return noOfPivots;
+}
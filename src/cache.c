@@ -0,0 +1,540 @@
+/* ********************************************************************************************* */
+/* * Simple content-addressed cache of betweenness results: libcache                          * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libcache is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libcache is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libcache.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Extension of cache entries */
+#define ENTRY_EXT ".btwc"
+/* Length of an entry name: 32 hex digits plus extension */
+#define ENTRY_NAME_LEN (32 + sizeof(ENTRY_EXT) - 1)
+
+/* An entry found while evicting */
+typedef struct {
+	char name[ENTRY_NAME_LEN + 1];
+	off_t size;
+	struct timespec mtime;
+} _cache_entry_t;
+
+/* A node and its colour, for colour refinement */
+typedef struct {
+	uint64_t color;
+	unsigned int v;
+} _cache_color_t;
+
+/**
+ * @brief 64-bit finaliser of MurmurHash3 (a bijection with good avalanche).
+ * @note This is an internal function.
+ */
+static inline uint64_t _cache_fmix(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDull;
+	x ^= x >> 33;
+	x *= 0xC4CEB9FE1A85EC53ull;
+	x ^= x >> 33;
+
+	return x;
+}
+
+/**
+ * @brief Feed a word to a 128-bit hash (two independent 64-bit lanes).
+ * @note This is an internal function.
+ */
+static inline void _cache_update(uint64_t *hash, uint64_t word) {
+	hash[0] = _cache_fmix(hash[0] ^ word) + 0x9E3779B97F4A7C15ull;
+	hash[1] = _cache_fmix(hash[1] + ((word << 29) | (word >> 35))) ^ 0xD6E8FEB86659FD93ull;
+}
+
+/**
+ * @brief Comparison function for qsort (uint64_t).
+ * @note This is an internal function.
+ */
+static int _cache_compareU64(const void *a, const void *b) {
+	uint64_t x = *((const uint64_t *) a);
+	uint64_t y = *((const uint64_t *) b);
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Comparison function for qsort (colours, then node id so that the order is total).
+ * @note This is an internal function.
+ */
+static int _cache_compareColors(const void *a, const void *b) {
+	const _cache_color_t *x = a;
+	const _cache_color_t *y = b;
+
+	if(x->color != y->color)
+		return (x->color > y->color) - (x->color < y->color);
+
+	return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief Sort packed edges ((orig << 32) | dest, with orig < dest) and drop repeated ones.
+ * @note This is an internal function.
+ * @return Number of distinct edges.
+ */
+static unsigned int _cache_sortUnique(uint64_t *packed, unsigned int m) {
+	unsigned int i, j;
+
+	if(!m)
+		return 0;
+
+	qsort(packed, m, sizeof(uint64_t), _cache_compareU64);
+	for(i = 1, j = 1; i < m; i++) {
+		if(packed[i] != packed[j - 1])
+			packed[j++] = packed[i];
+	}
+
+	return j;
+}
+
+/**
+ * @brief Pack an edge with ordered ends.
+ * @note This is an internal function.
+ */
+static inline uint64_t _cache_pack(unsigned int orig, unsigned int dest) {
+	return (orig < dest)? ((((uint64_t) orig) << 32) | dest) : ((((uint64_t) dest) << 32) | orig);
+}
+
+/**
+ * @brief Compute canonical labels by colour refinement.
+ * @note This is an internal function.
+ * @return Array with the canonical label of each node, or NULL if refinement does not tell all nodes apart.
+ */
+static unsigned int *_cache_canonicalLabels(unsigned int n, unsigned int m, uint64_t *packed) {
+	unsigned int i, v, k;
+	unsigned int noOfClasses, prevNoOfClasses = 0;
+	unsigned int *offsets = NULL;
+	unsigned int *adj = NULL;
+	uint64_t *color = NULL;
+	uint64_t *neighbours = NULL;
+	uint64_t hash;
+	_cache_color_t *order = NULL;
+	unsigned int *labels = NULL;
+
+	if(n < 2)
+		return NULL;
+
+	/* Adjacency in compressed form */
+	offsets = calloc(n + 1, sizeof(unsigned int));
+	adj = malloc((2 * (size_t) m + 1) * sizeof(unsigned int));
+	for(i = 0; i < m; i++) {
+		(offsets[(packed[i] >> 32) + 1])++;
+		(offsets[(packed[i] & 0xFFFFFFFFu) + 1])++;
+	}
+	for(v = 0; v < n; v++)
+		offsets[v + 1] += offsets[v];
+	for(i = 0; i < m; i++) {
+		adj[offsets[packed[i] >> 32]++] = packed[i] & 0xFFFFFFFFu;
+		adj[offsets[packed[i] & 0xFFFFFFFFu]++] = packed[i] >> 32;
+	}
+	for(v = n; v > 0; v--)
+		offsets[v] = offsets[v - 1];
+	offsets[0] = 0;
+
+	/* Initial colour is the degree */
+	color = malloc(n * sizeof(uint64_t));
+	neighbours = malloc((2 * (size_t) m + 1) * sizeof(uint64_t));
+	order = malloc(n * sizeof(_cache_color_t));
+	for(v = 0; v < n; v++)
+		color[v] = offsets[v + 1] - offsets[v];
+
+	while(1) {
+		/* New colour: hash of the colour and of the sorted colours of the neighbours */
+		for(v = 0; v < n; v++) {
+			for(k = offsets[v]; k < offsets[v + 1]; k++)
+				neighbours[k] = color[adj[k]];
+			qsort(&neighbours[offsets[v]], offsets[v + 1] - offsets[v], sizeof(uint64_t), _cache_compareU64);
+
+			hash = _cache_fmix(color[v] + 0x9E3779B97F4A7C15ull);
+			for(k = offsets[v]; k < offsets[v + 1]; k++)
+				hash = _cache_fmix(hash ^ neighbours[k]) + 0xD6E8FEB86659FD93ull;
+
+			order[v].color = hash;
+			order[v].v = v;
+		}
+
+		/* Colours become ranks, which depend only on the hashes, not on the original labels */
+		qsort(order, n, sizeof(_cache_color_t), _cache_compareColors);
+		noOfClasses = 0;
+		for(i = 0; i < n; i++) {
+			if(!i || (order[i].color != order[i - 1].color))
+				noOfClasses++;
+			color[order[i].v] = noOfClasses - 1;
+		}
+
+		/* Discrete partition: ranks are canonical labels */
+		if(noOfClasses == n) {
+			labels = malloc(n * sizeof(unsigned int));
+			for(v = 0; v < n; v++)
+				labels[v] = color[v];
+			break;
+		}
+
+		/* Stable partition with ties: some nodes cannot be told apart */
+		if(noOfClasses == prevNoOfClasses)
+			break;
+		prevNoOfClasses = noOfClasses;
+	}
+
+	free(order);
+	free(neighbours);
+	free(color);
+	free(adj);
+	free(offsets);
+
+	return labels;
+}
+
+/**
+ * @brief Build the path of the entry of a key.
+ * @note This is an internal function.
+ * @return The path, developer should free it after use.
+ */
+static char *_cache_path(cache_t *cache, cache_key_t *key) {
+	char *path = malloc(strlen(cache->dir) + ENTRY_NAME_LEN + 2);
+
+	sprintf(path, "%s/%016llx%016llx" ENTRY_EXT, cache->dir, (unsigned long long) key->hash[0], (unsigned long long) key->hash[1]);
+
+	return path;
+}
+
+/**
+ * @brief Comparison function for qsort (least recently used first).
+ * @note This is an internal function.
+ */
+static int _cache_compareEntries(const void *a, const void *b) {
+	const _cache_entry_t *x = a;
+	const _cache_entry_t *y = b;
+
+	if(x->mtime.tv_sec != y->mtime.tv_sec)
+		return (x->mtime.tv_sec > y->mtime.tv_sec) - (x->mtime.tv_sec < y->mtime.tv_sec);
+	if(x->mtime.tv_nsec != y->mtime.tv_nsec)
+		return (x->mtime.tv_nsec > y->mtime.tv_nsec) - (x->mtime.tv_nsec < y->mtime.tv_nsec);
+
+	return strcmp(x->name, y->name);
+}
+
+/**
+ * @brief Sum the size of all entries and evict least recently used ones while the size limit is exceeded.
+ * @note This is an internal function.
+ */
+static void _cache_scan(cache_t *cache) {
+	DIR *dir;
+	struct dirent *dirEntry;
+	struct stat st;
+	_cache_entry_t *entries = NULL;
+	unsigned int noOfEntries = 0;
+	unsigned int capacity = 0;
+	unsigned int i;
+	unsigned long long total = 0;
+	size_t nameLen;
+	char *path = malloc(strlen(cache->dir) + ENTRY_NAME_LEN + 2);
+
+	dir = opendir(cache->dir);
+	if(!dir) {
+		free(path);
+		return;
+	}
+
+	/* Entries of other threads or processes may come and go while scanning: sizes are a best effort */
+
+	while((dirEntry = readdir(dir))) {
+		nameLen = strlen(dirEntry->d_name);
+		if((nameLen != ENTRY_NAME_LEN) || strcmp(&(dirEntry->d_name[nameLen - sizeof(ENTRY_EXT) + 1]), ENTRY_EXT))
+			continue;
+
+		sprintf(path, "%s/%s", cache->dir, dirEntry->d_name);
+		if(stat(path, &st))
+			continue;
+
+		if(noOfEntries == capacity) {
+			capacity = capacity? (2 * capacity) : 64;
+			entries = realloc(entries, capacity * sizeof(_cache_entry_t));
+		}
+		strcpy(entries[noOfEntries].name, dirEntry->d_name);
+		entries[noOfEntries].size = st.st_size;
+		entries[noOfEntries].mtime = st.st_mtim;
+		noOfEntries++;
+		total += st.st_size;
+	}
+	closedir(dir);
+
+	if(total > cache->maxSize) {
+		qsort(entries, noOfEntries, sizeof(_cache_entry_t), _cache_compareEntries);
+		for(i = 0; (i < noOfEntries) && (total > cache->maxSize); i++) {
+			sprintf(path, "%s/%s", cache->dir, entries[i].name);
+			if(!unlink(path))
+				total -= entries[i].size;
+		}
+	}
+
+	__atomic_store_n(&(cache->size), total, __ATOMIC_RELAXED);
+
+	free(entries);
+	free(path);
+}
+
+/**
+ * @brief Initialise a cache. The folder is created if needed.
+ */
+int cache_init(cache_t *cache, char *dir, unsigned long long maxSize, bool canonicalize) {
+	char *path = strdup(dir);
+	char *p;
+	int rv = 0;
+	mode_t mask = umask(0);
+
+	umask(mask);
+
+	cache->dir = dir;
+	cache->maxSize = maxSize;
+	cache->canonicalize = canonicalize;
+	cache->size = 0;
+	cache->mode = 0644 & ~mask;
+
+	/* Same as mkdir -p */
+	for(p = path + 1; ; p++) {
+		if(('/' == *p) || !(*p)) {
+			char c = *p;
+
+			*p = '\0';
+			if(mkdir(path, 0755) && (errno != EEXIST)) {
+				rv = -1;
+				break;
+			}
+			*p = c;
+
+			if(!c)
+				break;
+		}
+	}
+
+	free(path);
+
+	if(!rv)
+		_cache_scan(cache);
+
+	return rv;
+}
+
+/**
+ * @brief Compute the key of a graph.
+ */
+void cache_computeKey(cache_t *cache, cache_key_t *key, unsigned int n, unsigned int m, unsigned int *edges, const char *params) {
+	unsigned int i, noOfEdges = 0;
+	uint64_t *packed = malloc(((size_t) m + 1) * sizeof(uint64_t));
+	uint64_t word = 0;
+
+	key->n = n;
+	key->labels = NULL;
+
+	/* Normalise: ordered ends, no self-loops, sorted, no repeated edges */
+	for(i = 0; i < m; i++) {
+		if(edges[2 * i] != edges[2 * i + 1])
+			packed[noOfEdges++] = _cache_pack(edges[2 * i], edges[2 * i + 1]);
+	}
+	noOfEdges = _cache_sortUnique(packed, noOfEdges);
+
+	/* Relabel to canonical order when possible */
+	if(cache->canonicalize) {
+		key->labels = _cache_canonicalLabels(n, noOfEdges, packed);
+		if(key->labels) {
+			for(i = 0; i < noOfEdges; i++)
+				packed[i] = _cache_pack(key->labels[packed[i] >> 32], key->labels[packed[i] & 0xFFFFFFFFu]);
+			qsort(packed, noOfEdges, sizeof(uint64_t), _cache_compareU64);
+		}
+	}
+
+	key->hash[0] = 0x243F6A8885A308D3ull;
+	key->hash[1] = 0x13198A2E03707344ull;
+	_cache_update(key->hash, CACHE_VERSION);
+	_cache_update(key->hash, n);
+	_cache_update(key->hash, noOfEdges);
+	_cache_update(key->hash, key->labels? 1 : 0);
+	for(i = 0; i < noOfEdges; i++)
+		_cache_update(key->hash, packed[i]);
+
+	/* Parameters, 8 chars per word, including the terminating null char */
+	for(i = 0; ; i++) {
+		word = (word << 8) | (unsigned char) params[i];
+		if(!params[i] || ((i % 8) == 7)) {
+			_cache_update(key->hash, word);
+			word = 0;
+		}
+		if(!params[i])
+			break;
+	}
+
+	free(packed);
+}
+
+/**
+ * @brief Look up a result.
+ */
+int cache_lookup(cache_t *cache, cache_key_t *key, double **columns, unsigned int noOfColumns) {
+	int rv = -1;
+	unsigned int i, v;
+	char *path = _cache_path(cache, key);
+	FILE *file = fopen(path, "rb");
+	cache_header_t header;
+	double *stored = NULL;
+
+	if(!file)
+		goto _end;
+
+	if((fread(&header, sizeof(cache_header_t), 1, file) != 1) || memcmp(header.magic, CACHE_MAGIC, 4) || (header.version != CACHE_VERSION))
+		goto _end;
+	if((header.hash[0] != key->hash[0]) || (header.hash[1] != key->hash[1]) || (header.n != key->n) || (header.noOfColumns != noOfColumns))
+		goto _end;
+
+	if(key->labels)
+		stored = malloc(((size_t) key->n + 1) * sizeof(double));
+	for(i = 0; i < noOfColumns; i++) {
+		if(key->labels) {
+			if(fread(stored, sizeof(double), key->n, file) != key->n)
+				goto _end;
+			for(v = 0; v < key->n; v++)
+				columns[i][v] = stored[key->labels[v]];
+		}
+		else {
+			if(fread(columns[i], sizeof(double), key->n, file) != key->n)
+				goto _end;
+		}
+	}
+
+	/* Mark as recently used */
+	utimensat(AT_FDCWD, path, NULL, 0);
+	rv = 0;
+
+_end:
+
+	if(stored)
+		free(stored);
+
+	if(file)
+		fclose(file);
+
+	free(path);
+
+	return rv;
+}
+
+/**
+ * @brief Store a result, then evict least recently used entries while the size limit is exceeded.
+ */
+int cache_store(cache_t *cache, cache_key_t *key, double **columns, unsigned int noOfColumns) {
+	int rv = -1;
+	int fd;
+	unsigned int i, v;
+	unsigned long long size = sizeof(cache_header_t) + (size_t) noOfColumns * key->n * sizeof(double);
+	unsigned long long oldSize = 0;
+	struct stat st;
+	double *column;
+	char *path = _cache_path(cache, key);
+	char *tmpPath = malloc(strlen(cache->dir) + 16);
+	FILE *file = NULL;
+	cache_header_t header;
+	double *stored = NULL;
+
+	sprintf(tmpPath, "%s/.tmp.XXXXXX", cache->dir);
+	fd = mkstemp(tmpPath);
+	if(-1 == fd)
+		goto _end;
+	file = (-1 == fchmod(fd, cache->mode))? NULL : fdopen(fd, "wb");
+	if(!file) {
+		close(fd);
+		unlink(tmpPath);
+		goto _end;
+	}
+
+	memset(&header, 0, sizeof(cache_header_t));
+	memcpy(header.magic, CACHE_MAGIC, 4);
+	header.version = CACHE_VERSION;
+	header.hash[0] = key->hash[0];
+	header.hash[1] = key->hash[1];
+	header.n = key->n;
+	header.noOfColumns = noOfColumns;
+
+	if(fwrite(&header, sizeof(cache_header_t), 1, file) != 1) {
+		fclose(file);
+		unlink(tmpPath);
+		goto _end;
+	}
+
+	if(key->labels)
+		stored = malloc(((size_t) key->n + 1) * sizeof(double));
+	for(i = 0; i < noOfColumns; i++) {
+		column = columns[i];
+
+		/* Canonical order */
+		if(key->labels) {
+			for(v = 0; v < key->n; v++)
+				stored[key->labels[v]] = column[v];
+			column = stored;
+		}
+
+		if(fwrite(column, sizeof(double), key->n, file) != key->n) {
+			fclose(file);
+			unlink(tmpPath);
+			goto _end;
+		}
+	}
+	/* An existing entry for this key is replaced, so only the size difference is accounted */
+	if(!stat(path, &st))
+		oldSize = st.st_size;
+	if(fclose(file) || rename(tmpPath, path)) {
+		unlink(tmpPath);
+		goto _end;
+	}
+
+	/* Folder is scanned only when the limit seems to be exceeded */
+	if(size < oldSize)
+		__atomic_sub_fetch(&(cache->size), oldSize - size, __ATOMIC_RELAXED);
+	else if(__atomic_add_fetch(&(cache->size), size - oldSize, __ATOMIC_RELAXED) > cache->maxSize)
+		_cache_scan(cache);
+	rv = 0;
+
+_end:
+
+	if(stored)
+		free(stored);
+
+	free(tmpPath);
+	free(path);
+
+	return rv;
+}
+
+/**
+ * @brief Free a key.
+ */
+void cache_freeKey(cache_key_t *key) {
+	if(key->labels)
+		free(key->labels);
+	key->labels = NULL;
+}
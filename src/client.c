@@ -0,0 +1,103 @@
+/* ********************************************************************************************* */
+/* * Client for the bitanes2 query server: bitanes2-client                                     * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with bitanes2.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "common/common.h"
+#include "server.h"
+
+#define USAGE_STR "Usage: %s SOCKET REQUEST [ARG]...\n"\
+	"Send a request to a bitanes2 server (bitanes2 --serve SOCKET) and print the answer. Requests:\n"\
+	"    LOAD NAME FILE              load graph FILE as NAME and compute its betweenness\n"\
+	"    SCORE NAME V                betweenness of node V\n"\
+	"    TOP NAME K                  K nodes with highest betweenness\n"\
+	"    RECOMPUTE NAME [S [SEED]]   recompute from S sampled sources (0 or missing for exact)\n"\
+	"    UNLOAD NAME                 free graph NAME\n"\
+	"    LIST                        loaded graphs\n"\
+	"    SHUTDOWN                    stop the server\n"\
+	"Exit status is 1 if the server answered with an error.\n"
+
+int main(int argc, char *argv[]) {
+	/* Auxiliary variables */
+	int i;
+	int fd = -1;
+	struct sockaddr_un addr;
+	char request[SERVER_MAX_LINE_SZ];
+	size_t len = 0;
+	char buffer[4096];
+	ssize_t readSz;
+	bool first = true;
+	bool failed = false;
+
+	ASSERT_CALL(argc >= 3, fprintf(stderr, USAGE_STR, argv[0]));
+
+	/* Request is the remaining arguments, separated by spaces */
+	for(i = 2; i < argc; i++) {
+		ASSERT_CALL(len + strlen(argv[i]) + 2 <= SERVER_MAX_LINE_SZ, fprintf(stderr, "Error: request too long\n"));
+		len += sprintf(&request[len], (i > 2)? " %s" : "%s", argv[i]);
+	}
+	request[len++] = '\n';
+
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	ASSERT_CALL(strlen(argv[1]) < sizeof(addr.sun_path), fprintf(stderr, "Error: socket path too long: %s\n", argv[1]));
+	strcpy(addr.sun_path, argv[1]);
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	ASSERT_CALL(fd != -1, fprintf(stderr, "Error: %s\n", strerror(errno)));
+	ASSERT_CALL(!connect(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un)), fprintf(stderr, "Error: %s: %s\n", strerror(errno), argv[1]));
+
+	/* Send the request and close our side, so that the server ends the connection after answering */
+	ASSERT_CALL(write(fd, request, len) == (ssize_t) len, fprintf(stderr, "Error: %s\n", strerror(errno)));
+	shutdown(fd, SHUT_WR);
+
+	while((readSz = read(fd, buffer, sizeof(buffer))) > 0) {
+		if(first)
+			failed = (readSz >= 3) && !strncmp(buffer, "ERR", 3);
+		first = false;
+		fwrite(buffer, 1, readSz, stdout);
+	}
+
+	close(fd);
+
+	/* The server closes without answering when it could not handle the request */
+	if(readSz < 0) {
+		fprintf(stderr, "Error: %s\n", strerror(errno));
+		failed = true;
+	}
+	else if(first) {
+		fprintf(stderr, "Error: connection closed without an answer\n");
+		failed = true;
+	}
+
+	return failed? EXIT_FAILURE : EXIT_SUCCESS;
+
+_err:
+
+	if(fd != -1)
+		close(fd);
+
+	return EXIT_FAILURE;
+}
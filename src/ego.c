@@ -0,0 +1,464 @@
+/* ********************************************************************************************* */
+/* * Ego network betweenness: libego                                                           * */
+/* * Author: André Bannwart Perina                                                             * */
+/* * Algorithm: Everett, Martin, and Stephen P. Borgatti. "Ego network betweenness."           * */
+/* *            Social networks 27.1 (2005): 31-38.                                            * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libego is free software: you can redistribute it and/or modify it under the terms of the  * */
+/* * GNU General Public License as published by the Free Software Foundation, either version 3 * */
+/* * of the License, or (at your option) any later version.                                    * */
+/* *                                                                                           * */
+/* * libego is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;       * */
+/* * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR          * */
+/* * PURPOSE.  See the GNU General Public License for more details.                            * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libego.      * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "ego.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "hugemem.h"
+
+/* A neighbour list this many times longer than the ego network is binary searched instead of merged */
+#define _EGO_SEARCH_RATIO 8
+
+/* State shared by all threads */
+typedef struct {
+	graph_t *graph;
+	double *cb;
+	/* Nodes, highest degrees first, and next one to be taken */
+	unsigned int *order;
+	unsigned int next;
+	/* Set when a thread could not allocate its buffers: every thread then stops */
+	bool failed;
+} _ego_pool_t;
+
+/* A thread, with its own buffers, grown on demand (capacities in bytes) */
+typedef struct {
+	_ego_pool_t *pool;
+	pthread_t thread;
+	/* Bit sets: one row of bits per neighbour of the current node, over its neighbours, and one more for candidates */
+	uint64_t *rows;
+	size_t rowsCapacity;
+	uint64_t *candidates;
+	size_t candidatesCapacity;
+	/* Indices (among the neighbours of the current node) of the neighbours of each neighbour, one list after the other */
+	int *matches;
+	size_t matchesCapacity;
+	/* Lists: offset of each list in matches, then a counter, a stamp and a slot of the touched nodes per neighbour */
+	unsigned int *scratch;
+	size_t scratchCapacity;
+	/* Neighbours of a node, when they are not stored as lists */
+	int *adjacents;
+	unsigned long long edgesTraversed;
+} _ego_worker_t;
+
+/**
+ * @brief Get the neighbours of a node (sorted).
+ * @param buffer Array of n ints, filled when neighbours are not stored as lists.
+ * @note This is an internal function.
+ */
+static inline int *_ego_neighbours(graph_t *graph, int v, int *buffer, unsigned int *noOfAdjacents) {
+#ifdef GRAPH_USE_ADJ_MATRIX
+	int w;
+
+	*noOfAdjacents = 0;
+	for(w = 0; w < graph->n; w++) {
+		if(graph_getEdge(graph, v, w))
+			buffer[(*noOfAdjacents)++] = w;
+	}
+
+	return buffer;
+#else
+	return graph_getAdjacents(graph, v, noOfAdjacents);
+#endif
+}
+
+/**
+ * @brief Get the degree of a node.
+ * @note This is an internal function.
+ */
+static unsigned int _ego_degree(graph_t *graph, int v) {
+	unsigned int degree = 0;
+#ifdef GRAPH_USE_ADJ_MATRIX
+	int w;
+
+	for(w = 0; w < graph->n; w++)
+		degree += graph_getEdge(graph, v, w)? 1 : 0;
+#else
+	graph_getAdjacents(graph, v, &degree);
+#endif
+
+	return degree;
+}
+
+/**
+ * @brief Make sure that a buffer of a thread holds at least size bytes (its contents are not kept).
+ * @return 0 on success, -1 if no memory is left.
+ * @note This is an internal function.
+ */
+static int _ego_reserve(void **buffer, size_t *capacity, size_t size) {
+	if(size <= *capacity)
+		return 0;
+
+	/* Some slack, so that nodes of similar degree reuse the buffer */
+	size += size / 2;
+	hugemem_free(*buffer);
+	*buffer = hugemem_alloc(size);
+	*capacity = *buffer? size : 0;
+
+	return *buffer? 0 : -1;
+}
+
+/**
+ * @brief Find the nodes ego[j] of the ego network that are adjacent to a node, in increasing j.
+ * @param matches Array of k ints to receive the indices j found.
+ * @param noOfRead Where the number of adjacency entries read (or pairs looked up) is added.
+ * @return Number of indices found.
+ * @note This is an internal function.
+ */
+static unsigned int _ego_intersect(graph_t *graph, int a, int *ego, unsigned int k, int *matches, unsigned long long *noOfRead) {
+	unsigned int noOfMatches = 0;
+	unsigned int j = 0;
+#ifdef GRAPH_USE_ADJ_MATRIX
+	for(j = 0; j < k; j++) {
+		if(graph_getEdge(graph, a, ego[j]))
+			matches[noOfMatches++] = j;
+	}
+	*noOfRead += k;
+#else
+	unsigned int i = 0;
+	unsigned int lo, hi, mid;
+	unsigned int noOfAdjacents;
+	int *adj = graph_getAdjacents(graph, a, &noOfAdjacents);
+
+	/* Much longer list: binary search each node of the ego network in it */
+	if(noOfAdjacents > (_EGO_SEARCH_RATIO * k)) {
+		for(j = 0; j < k; j++) {
+			lo = 0;
+			hi = noOfAdjacents;
+			while(lo < hi) {
+				mid = lo + ((hi - lo) / 2);
+				if(adj[mid] < ego[j])
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			if((lo < noOfAdjacents) && (adj[lo] == ego[j]))
+				matches[noOfMatches++] = j;
+		}
+		*noOfRead += k;
+
+		return noOfMatches;
+	}
+
+	while((i < noOfAdjacents) && (j < k)) {
+		if(adj[i] < ego[j]) {
+			i++;
+		}
+		else if(adj[i] > ego[j]) {
+			j++;
+		}
+		else {
+			matches[noOfMatches++] = j;
+			i++;
+			j++;
+		}
+	}
+	*noOfRead += noOfAdjacents;
+#endif
+
+	return noOfMatches;
+}
+
+/**
+ * @brief Compute the ego betweenness of a node of degree at most EGO_BITSET_MAX, with bit sets.
+ * @note This is an internal function.
+ */
+static int _ego_bitsets(_ego_worker_t *worker, int *ego, unsigned int k, double *score) {
+	graph_t *graph = worker->pool->graph;
+	uint64_t *rows, *candidates, *row;
+	uint64_t bits;
+	unsigned int i, j, l, w, noOfWords, first, common, noOfPairs, noOfMatches;
+	double sum = 0;
+
+	noOfWords = (k + 63) / 64;
+	if(_ego_reserve((void **) &(worker->rows), &(worker->rowsCapacity), (size_t) k * noOfWords * sizeof(uint64_t)))
+		return -1;
+	if(_ego_reserve((void **) &(worker->candidates), &(worker->candidatesCapacity), noOfWords * sizeof(uint64_t)))
+		return -1;
+	if(_ego_reserve((void **) &(worker->matches), &(worker->matchesCapacity), k * sizeof(int)))
+		return -1;
+	rows = worker->rows;
+	candidates = worker->candidates;
+
+	/* Row i holds the neighbours of v adjacent to its neighbour i */
+	for(i = 0; i < k * noOfWords; i++)
+		rows[i] = 0;
+	for(i = 0; i < k; i++) {
+		row = &rows[i * noOfWords];
+		noOfMatches = _ego_intersect(graph, ego[i], ego, k, worker->matches, &(worker->edgesTraversed));
+		for(l = 0; l < noOfMatches; l++) {
+			j = worker->matches[l];
+			row[j / 64] |= 1ull << (j % 64);
+		}
+	}
+
+	/*
+	 * Paths between non-adjacent neighbours i and j go through v or through one of their common neighbours. Only the
+	 * j > i sharing a neighbour with i (the union of the rows of the neighbours of i, without i and its neighbours)
+	 * need their rows intersected; every other j not adjacent to i adds 1
+	 */
+	for(i = 0; i < k; i++) {
+		row = &rows[i * noOfWords];
+		first = (i + 1) / 64;
+
+		noOfPairs = k - 1 - i;
+		for(l = first; l < noOfWords; l++) {
+			candidates[l] = 0;
+			bits = (l == first)? (row[l] & (~0ull << ((i + 1) % 64))) : row[l];
+			noOfPairs -= __builtin_popcountll(bits);
+		}
+
+		for(l = 0; l < noOfWords; l++) {
+			for(bits = row[l]; bits; bits &= bits - 1) {
+				w = (l * 64) + __builtin_ctzll(bits);
+				for(j = first; j < noOfWords; j++)
+					candidates[j] |= rows[(w * noOfWords) + j];
+			}
+		}
+
+		for(l = first; l < noOfWords; l++) {
+			bits = candidates[l] & ~row[l];
+			if(l == first)
+				bits &= ~0ull << ((i + 1) % 64);
+			for(; bits; bits &= bits - 1) {
+				j = (l * 64) + __builtin_ctzll(bits);
+				common = 0;
+				for(w = 0; w < noOfWords; w++)
+					common += __builtin_popcountll(row[w] & rows[(j * noOfWords) + w]);
+				sum += 1.0 / (1 + common);
+				noOfPairs--;
+			}
+		}
+
+		sum += noOfPairs;
+	}
+
+	*score = sum;
+	return 0;
+}
+
+/**
+ * @brief Compute the ego betweenness of a node of any degree, with sorted lists (memory linear in its ego network).
+ * @note This is an internal function.
+ */
+static int _ego_lists(_ego_worker_t *worker, int *ego, unsigned int k, double *score) {
+	graph_t *graph = worker->pool->graph;
+	unsigned int *offsets, *counts, *stamps, *touched;
+	unsigned int i, j, l, p, w, noOfPairs, noOfTouched;
+	unsigned long long noOfMatches;
+	int *matches;
+	double sum = 0;
+
+	/* A neighbour a has at most min(deg(a), k) neighbours in the ego network */
+#ifdef GRAPH_USE_ADJ_MATRIX
+	noOfMatches = (unsigned long long) k * k;
+#else
+	for(i = 0, noOfMatches = 0; i < k; i++) {
+		w = _ego_degree(graph, ego[i]);
+		noOfMatches += (w < k)? w : k;
+	}
+#endif
+	if(_ego_reserve((void **) &(worker->matches), &(worker->matchesCapacity), (noOfMatches + 1) * sizeof(int)))
+		return -1;
+	if(_ego_reserve((void **) &(worker->scratch), &(worker->scratchCapacity), ((4 * (size_t) k) + 1) * sizeof(unsigned int)))
+		return -1;
+	matches = worker->matches;
+	offsets = worker->scratch;
+	counts = &offsets[k + 1];
+	stamps = &counts[k];
+	touched = &stamps[k];
+
+	/* List i holds the (sorted) indices of the neighbours of v adjacent to its neighbour i */
+	offsets[0] = 0;
+	for(i = 0; i < k; i++) {
+		offsets[i + 1] = offsets[i] + _ego_intersect(graph, ego[i], ego, k, &matches[offsets[i]], &(worker->edgesTraversed));
+		counts[i] = 0;
+		stamps[i] = 0;
+	}
+
+	/*
+	 * Same pairs as with bit sets: the j > i two steps away from i are counted once per common neighbour, through the
+	 * lists of the neighbours of i, and the ones adjacent to i (stamped with i + 1) are left out
+	 */
+	for(i = 0; i < k; i++) {
+		noOfPairs = k - 1 - i;
+		for(p = offsets[i]; p < offsets[i + 1]; p++) {
+			stamps[matches[p]] = i + 1;
+			if(matches[p] > i)
+				noOfPairs--;
+		}
+
+		noOfTouched = 0;
+		for(p = offsets[i]; p < offsets[i + 1]; p++) {
+			w = matches[p];
+			for(l = offsets[w + 1]; (l > offsets[w]) && (matches[l - 1] > i); l--) {
+				j = matches[l - 1];
+				if(stamps[j] == (i + 1))
+					continue;
+				if(!counts[j])
+					touched[noOfTouched++] = j;
+				counts[j]++;
+			}
+		}
+
+		for(l = 0; l < noOfTouched; l++) {
+			j = touched[l];
+			sum += 1.0 / (1 + counts[j]);
+			counts[j] = 0;
+		}
+		sum += noOfPairs - noOfTouched;
+	}
+
+	*score = sum;
+	return 0;
+}
+
+/**
+ * @brief Thread: process chunks of nodes until there are none left.
+ * @note This is an internal function.
+ */
+static void *_ego_work(void *arg) {
+	_ego_worker_t *worker = arg;
+	_ego_pool_t *pool = worker->pool;
+	unsigned int n = pool->graph->n;
+	unsigned int lo, hi, i, k;
+	int v;
+	int *ego;
+	double score;
+	int rv = 0;
+
+	/* Buffers are allocated by the thread using them, which places them on its node */
+#ifdef GRAPH_USE_ADJ_MATRIX
+	worker->adjacents = hugemem_alloc(((size_t) n + 1) * sizeof(int));
+	rv = worker->adjacents? 0 : -1;
+#else
+	worker->adjacents = NULL;
+#endif
+
+	while(!rv && ((lo = __atomic_fetch_add(&(pool->next), EGO_CHUNK_SZ, __ATOMIC_RELAXED)) < n)) {
+		hi = ((n - lo) < EGO_CHUNK_SZ)? n : (lo + EGO_CHUNK_SZ);
+		for(i = lo; (i < hi) && !rv; i++) {
+			v = pool->order[i];
+			ego = _ego_neighbours(pool->graph, v, worker->adjacents, &k);
+			worker->edgesTraversed += k;
+
+			score = 0;
+			if(k < 2)
+				rv = 0;
+			else if(k <= EGO_BITSET_MAX)
+				rv = _ego_bitsets(worker, ego, k, &score);
+			else
+				rv = _ego_lists(worker, ego, k, &score);
+			pool->cb[v] = score;
+		}
+		rv = rv || __atomic_load_n(&(pool->failed), __ATOMIC_RELAXED);
+	}
+	if(rv)
+		__atomic_store_n(&(pool->failed), true, __ATOMIC_RELAXED);
+
+	hugemem_free(worker->adjacents);
+	hugemem_free(worker->scratch);
+	hugemem_free(worker->matches);
+	hugemem_free(worker->candidates);
+	hugemem_free(worker->rows);
+
+	return NULL;
+}
+
+/**
+ * @brief Compare two nodes by degree (stored right before each node), for qsort: highest degrees first.
+ * @note This is an internal function.
+ */
+static int _ego_compareDegrees(const void *a, const void *b) {
+	const unsigned int *da = a;
+	const unsigned int *db = b;
+
+	if(da[0] != db[0])
+		return (da[0] > db[0])? -1 : 1;
+	return (da[1] < db[1])? -1 : ((da[1] > db[1])? 1 : 0);
+}
+
+/**
+ * @brief Compute the ego betweenness of all nodes.
+ */
+int ego_compute(graph_t *graph, double *cb, unsigned int noOfThreads, stats_t *stats) {
+	_ego_pool_t pool;
+	_ego_worker_t *workers;
+	unsigned int n = graph->n;
+	unsigned int i, noOfCreated;
+	unsigned int *pairs;
+	double start = 0;
+
+	if(stats)
+		start = stats_now();
+	if(!noOfThreads)
+		noOfThreads = 1;
+
+	/* Degrees are sorted along with their nodes */
+	pairs = malloc(2 * ((size_t) n + 1) * sizeof(unsigned int));
+	for(i = 0; i < n; i++) {
+		pairs[2 * i] = _ego_degree(graph, i);
+		pairs[2 * i + 1] = i;
+	}
+	if(noOfThreads > 1)
+		qsort(pairs, n, 2 * sizeof(unsigned int), _ego_compareDegrees);
+
+	pool.order = malloc(((size_t) n + 1) * sizeof(unsigned int));
+	for(i = 0; i < n; i++)
+		pool.order[i] = pairs[2 * i + 1];
+	free(pairs);
+	pool.graph = graph;
+	pool.cb = cb;
+	pool.next = 0;
+	pool.failed = false;
+
+	if(stats) {
+		stats->phaseTime[STATS_PHASE_PREPROCESS] += stats_now() - start;
+		start = stats_now();
+	}
+
+	workers = calloc(noOfThreads, sizeof(_ego_worker_t));
+	for(i = 0; i < noOfThreads; i++)
+		workers[i].pool = &pool;
+
+	/* Go on with the threads that could be created (their chunks are taken by the others) */
+	for(noOfCreated = 1; noOfCreated < noOfThreads; noOfCreated++) {
+		if(pthread_create(&(workers[noOfCreated].thread), NULL, _ego_work, &workers[noOfCreated]))
+			break;
+	}
+	_ego_work(&workers[0]);
+	for(i = 1; i < noOfCreated; i++)
+		pthread_join(workers[i].thread, NULL);
+
+	if(stats) {
+		stats->phaseTime[STATS_PHASE_FORWARD] += stats_now() - start;
+		for(i = 0; i < noOfCreated; i++)
+			stats->edgesTraversed += workers[i].edgesTraversed;
+		stats->verticesVisited += n;
+	}
+
+	free(workers);
+	free(pool.order);
+
+	return pool.failed? -1 : 0;
+}
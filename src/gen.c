@@ -0,0 +1,447 @@
+/* ********************************************************************************************* */
+/* * Random graph generator for bitanes2: bitanes2-gen                                        * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with bitanes2.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/common.h"
+#include "netio.h"
+#include "stats.h"
+
+#define MAX_STR_SZ 256
+
+#define USAGE_STR "Usage: %s [OPTION]... MODEL N K\n"\
+	"Generate a random undirected graph with N nodes and average degree K, where MODEL is:\n"\
+	"    er                   Erdos-Renyi G(N, p), with p = K / (N - 1)\n"\
+	"    ba                   Barabasi-Albert, each new node attaching to K / 2 existing nodes (K must be even)\n"\
+	"    rmat                 R-MAT with (a, b, c, d) = (0.57, 0.19, 0.19, 0.05): N * K / 2 edges are drawn,\n"\
+	"                         self-loops are redrawn and repeated edges removed\n"\
+	"The graph is written to MODEL_N_K_II.net (or .bnet), where II is the instance index.\n"\
+	"Options:\n"\
+	"    -s, --seed S         base seed (default 0)\n"\
+	"    -i, --index I        instance index, used in the file name and mixed into the seed (default 0)\n"\
+	"    -o, --output DIR     output folder (default: current folder)\n"\
+	"    -f, --format FMT     output format: text (default, .net file) or bin (.bnet file)\n"\
+	"    -t, --threads N      number of threads (default: number of online CPUs)\n"\
+	"The same model, N, K, seed and index always generate the same file, whatever the number of threads.\n"
+
+/* Random graph models */
+#define MODEL_ER 0
+#define MODEL_BA 1
+#define MODEL_RMAT 2
+
+/* Work is split in chunks of nodes (ER, BA) or edges (R-MAT), each one with its own random stream */
+/* Since the chunk size does not depend on the number of threads, neither does the output */
+#define CHUNK_SZ 4096
+
+/* R-MAT quadrant probabilities (Graph500 defaults) */
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+/* Growable array of edges generated by one chunk */
+typedef struct {
+	unsigned int *edges;
+	unsigned int m;
+	unsigned int capacity;
+} chunk_t;
+
+/* Generator state shared among threads */
+typedef struct {
+	int model;
+	unsigned int n;
+	unsigned int k;
+	uint64_t seed;
+	/* Next chunk to be taken and number of chunks */
+	unsigned int nextChunk;
+	unsigned int noOfChunks;
+	chunk_t *chunks;
+} gen_t;
+
+/**
+ * @brief Step a splitmix64 generator.
+ */
+static inline uint64_t splitmix64(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+	return z ^ (z >> 31);
+}
+
+/**
+ * @brief Hash a seed and an index into a random 64-bit value (counter-based generator).
+ */
+static inline uint64_t hash64(uint64_t seed, uint64_t index) {
+	uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ull);
+
+	return splitmix64(&state);
+}
+
+/**
+ * @brief Convert a random 64-bit value to a double in [0, 1).
+ */
+static inline double toUniform(uint64_t val) {
+	return (val >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Add an edge to a chunk.
+ */
+static inline void putEdge(chunk_t *chunk, unsigned int orig, unsigned int dest) {
+	if(chunk->m == chunk->capacity) {
+		chunk->capacity = chunk->capacity? (2 * chunk->capacity) : CHUNK_SZ;
+		chunk->edges = realloc(chunk->edges, 2 * (size_t) chunk->capacity * sizeof(unsigned int));
+	}
+
+	chunk->edges[2 * chunk->m] = orig;
+	chunk->edges[2 * chunk->m + 1] = dest;
+	(chunk->m)++;
+}
+
+/**
+ * @brief Erdos-Renyi: for each node v in the chunk, connect to each w < v with probability p.
+ * @note Non-edges are skipped with geometric jumps (Batagelj and Brandes, 2005), so that cost is O(edges).
+ */
+static void generateER(gen_t *gen, unsigned int chunkId) {
+	chunk_t *chunk = &(gen->chunks[chunkId]);
+	uint64_t state = hash64(gen->seed, chunkId);
+	double p = gen->k / (double) (gen->n - 1);
+	double logQ = log(1 - p);
+	unsigned int lo = chunkId * CHUNK_SZ;
+	unsigned int hi = (lo + CHUNK_SZ < gen->n)? (lo + CHUNK_SZ) : gen->n;
+	unsigned int v;
+	long w;
+
+	for(v = lo; v < hi; v++) {
+		/* Complete graph */
+		if(p >= 1) {
+			for(w = 0; w < v; w++)
+				putEdge(chunk, w, v);
+			continue;
+		}
+
+		for(w = -1; ; ) {
+			w += 1 + (long) floor(log(1 - toUniform(splitmix64(&state))) / logQ);
+			if(w >= v)
+				break;
+			putEdge(chunk, w, v);
+		}
+	}
+}
+
+/**
+ * @brief Barabasi-Albert: target of edge i (copy model), i.e. a node chosen with probability proportional to its degree.
+ * @note Edge i belongs to node d + i / d, where d = k / 2. Its target is the end of an edge drawn uniformly from
+ *       all ends of the edges of previous nodes (Sanders and Schulz, 2016). Since each draw is a hash of the edge
+ *       index, it can be resolved by any thread without knowing the rest of the graph.
+ */
+static inline unsigned int baTarget(gen_t *gen, uint64_t i) {
+	uint64_t d = gen->k / 2;
+	uint64_t r;
+
+	while(1) {
+		/* First node connects to all initial nodes */
+		if(i < d)
+			return i;
+
+		/* Draw an end among the 2 * (edges before this node): even ends are sources, odd ends are targets */
+		r = hash64(gen->seed, i) % (2 * (i - (i % d)));
+		if(!(r % 2))
+			return d + ((r / 2) / d);
+
+		/* Target of an earlier edge: resolve it */
+		i = r / 2;
+	}
+}
+
+/**
+ * @brief Barabasi-Albert: for each node t in the chunk, attach d = k / 2 edges to previous nodes.
+ */
+static void generateBA(gen_t *gen, unsigned int chunkId) {
+	chunk_t *chunk = &(gen->chunks[chunkId]);
+	unsigned int d = gen->k / 2;
+	unsigned int lo = chunkId * CHUNK_SZ;
+	unsigned int hi = (lo + CHUNK_SZ < gen->n)? (lo + CHUNK_SZ) : gen->n;
+	unsigned int t, j, l;
+	unsigned int first;
+
+	/* Initial nodes have no edges of their own */
+	if(lo < d)
+		lo = d;
+
+	for(t = lo; t < hi; t++) {
+		first = chunk->m;
+
+		for(j = 0; j < d; j++) {
+			unsigned int target = baTarget(gen, ((uint64_t) (t - d)) * d + j);
+
+			/* The same target may be drawn twice for a node: keep it once */
+			for(l = first; l < chunk->m; l++) {
+				if(target == chunk->edges[2 * l])
+					break;
+			}
+			if(l == chunk->m)
+				putEdge(chunk, target, t);
+		}
+	}
+}
+
+/**
+ * @brief R-MAT: draw each edge of the chunk by recursively choosing a quadrant of the adjacency matrix.
+ */
+static void generateRMAT(gen_t *gen, unsigned int chunkId) {
+	chunk_t *chunk = &(gen->chunks[chunkId]);
+	uint64_t total = ((uint64_t) gen->n) * gen->k / 2;
+	uint64_t lo = ((uint64_t) chunkId) * CHUNK_SZ;
+	uint64_t hi = (lo + CHUNK_SZ < total)? (lo + CHUNK_SZ) : total;
+	uint64_t i;
+	unsigned int scale = 0;
+	unsigned int level, orig, dest;
+	double r;
+
+	while((1u << scale) < gen->n)
+		scale++;
+
+	for(i = lo; i < hi; i++) {
+		uint64_t state = hash64(gen->seed, i);
+
+		/* Redraw until both ends exist (n may not be a power of 2) and differ */
+		do {
+			orig = 0;
+			dest = 0;
+			for(level = 0; level < scale; level++) {
+				r = toUniform(splitmix64(&state));
+				orig <<= 1;
+				dest <<= 1;
+				if(r >= RMAT_A + RMAT_B + RMAT_C) {
+					orig |= 1;
+					dest |= 1;
+				}
+				else if(r >= RMAT_A + RMAT_B) {
+					orig |= 1;
+				}
+				else if(r >= RMAT_A) {
+					dest |= 1;
+				}
+			}
+		} while((orig >= gen->n) || (dest >= gen->n) || (orig == dest));
+
+		if(orig < dest)
+			putEdge(chunk, orig, dest);
+		else
+			putEdge(chunk, dest, orig);
+	}
+}
+
+/**
+ * @brief Worker thread: take chunks until none is left.
+ */
+static void *worker(void *arg) {
+	gen_t *gen = arg;
+	unsigned int chunkId;
+
+	while((chunkId = __atomic_fetch_add(&(gen->nextChunk), 1, __ATOMIC_RELAXED)) < gen->noOfChunks) {
+		switch(gen->model) {
+			case MODEL_ER:
+				generateER(gen, chunkId);
+				break;
+			case MODEL_BA:
+				generateBA(gen, chunkId);
+				break;
+			default:
+				generateRMAT(gen, chunkId);
+				break;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Comparison function for qsort (edges as pairs of node ids).
+ */
+static int compareEdges(const void *a, const void *b) {
+	const unsigned int *x = a;
+	const unsigned int *y = b;
+
+	if(x[0] != y[0])
+		return (x[0] > y[0]) - (x[0] < y[0]);
+
+	return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+int main(int argc, char *argv[]) {
+	/* Auxiliary variables */
+	int opt;
+	unsigned int i;
+	char *endPtr;
+	char *modelName;
+	char *outputDir = ".";
+	char *outputFilename = NULL;
+	FILE *outputFile = NULL;
+	int format = NETIO_FORMAT_TEXT;
+	unsigned int noOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned long seed = 0;
+	unsigned int index = 0;
+	pthread_t *threads = NULL;
+	double start;
+	struct option longOpts[] = {
+		{"seed", required_argument, NULL, 's'},
+		{"index", required_argument, NULL, 'i'},
+		{"output", required_argument, NULL, 'o'},
+		{"format", required_argument, NULL, 'f'},
+		{"threads", required_argument, NULL, 't'},
+		{NULL, 0, NULL, 0}
+	};
+	/* Generated graph */
+	gen_t gen;
+	unsigned long total;
+	unsigned int m = 0;
+	unsigned int *edges = NULL;
+
+	memset(&gen, 0, sizeof(gen_t));
+
+	/* Check if command line arguments were passed correctly */
+	while((opt = getopt_long(argc, argv, "s:i:o:f:t:", longOpts, NULL)) != -1) {
+		switch(opt) {
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case 'i':
+				index = strtoul(optarg, NULL, 10);
+				break;
+			case 'o':
+				outputDir = optarg;
+				break;
+			case 'f':
+				if(!strcmp(optarg, "text"))
+					format = NETIO_FORMAT_TEXT;
+				else if(!strcmp(optarg, "bin"))
+					format = NETIO_FORMAT_BIN;
+				else
+					ASSERT_CALL(false, fprintf(stderr, "Error: unknown output format: %s\n", optarg));
+				break;
+			case 't':
+				noOfThreads = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				ASSERT_CALL(false, fprintf(stderr, USAGE_STR, argv[0]));
+		}
+	}
+	ASSERT_CALL((optind + 3) == argc, fprintf(stderr, USAGE_STR, argv[0]));
+	ASSERT_CALL(noOfThreads > 0, fprintf(stderr, "Error: number of threads must be positive\n"));
+
+	modelName = argv[optind];
+	if(!strcmp(modelName, "er"))
+		gen.model = MODEL_ER;
+	else if(!strcmp(modelName, "ba"))
+		gen.model = MODEL_BA;
+	else if(!strcmp(modelName, "rmat"))
+		gen.model = MODEL_RMAT;
+	else
+		ASSERT_CALL(false, fprintf(stderr, "Error: unknown model: %s\n", modelName));
+
+	gen.n = strtoul(argv[optind + 1], &endPtr, 10);
+	ASSERT_CALL(!(*endPtr) && (gen.n > 1), fprintf(stderr, "Error: invalid number of nodes: %s\n", argv[optind + 1]));
+	gen.k = strtoul(argv[optind + 2], &endPtr, 10);
+	ASSERT_CALL(!(*endPtr) && (gen.k > 0), fprintf(stderr, "Error: invalid average degree: %s\n", argv[optind + 2]));
+	ASSERT_CALL((gen.model != MODEL_BA) || (!(gen.k % 2) && (gen.k / 2 < gen.n)), fprintf(stderr, "Error: BA model needs an even K, with K / 2 < N\n"));
+	ASSERT_CALL((gen.model != MODEL_RMAT) || (gen.k < gen.n), fprintf(stderr, "Error: R-MAT model needs K < N\n"));
+	ASSERT_CALL(((unsigned long) gen.n) * gen.k / 2 <= UINT32_MAX, fprintf(stderr, "Error: too many edges\n"));
+
+	/* Each instance index has its own seed */
+	gen.seed = hash64(seed, index);
+
+	outputFilename = malloc(MAX_STR_SZ);
+	snprintf(outputFilename, MAX_STR_SZ, "%s/%s_%u_%u_%02u.%s", outputDir, modelName, gen.n, gen.k, index, (NETIO_FORMAT_BIN == format)? "bnet" : "net");
+	outputFile = fopen(outputFilename, "wb");
+	ASSERT_CALL(outputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+
+	start = stats_now();
+
+	/* Generate all chunks in parallel */
+	total = (MODEL_RMAT == gen.model)? (((unsigned long) gen.n) * gen.k / 2) : gen.n;
+	gen.noOfChunks = (total + CHUNK_SZ - 1) / CHUNK_SZ;
+	gen.chunks = calloc(gen.noOfChunks, sizeof(chunk_t));
+	threads = malloc(noOfThreads * sizeof(pthread_t));
+	for(i = 1; i < noOfThreads; i++)
+		ASSERT_CALL(!pthread_create(&threads[i], NULL, worker, &gen), fprintf(stderr, "Error: could not create thread\n"));
+	worker(&gen);
+	for(i = 1; i < noOfThreads; i++)
+		pthread_join(threads[i], NULL);
+
+	/* Concatenate chunks in order */
+	for(i = 0; i < gen.noOfChunks; i++)
+		m += gen.chunks[i].m;
+	edges = malloc(2 * ((size_t) m + 1) * sizeof(unsigned int));
+	m = 0;
+	for(i = 0; i < gen.noOfChunks; i++) {
+		memcpy(&edges[2 * m], gen.chunks[i].edges, 2 * (size_t) gen.chunks[i].m * sizeof(unsigned int));
+		m += gen.chunks[i].m;
+	}
+
+	/* Only R-MAT may draw the same edge twice */
+	if((MODEL_RMAT == gen.model) && m) {
+		unsigned int j;
+
+		qsort(edges, m, 2 * sizeof(unsigned int), compareEdges);
+		for(i = 1, j = 1; i < m; i++) {
+			if(compareEdges(&edges[2 * i], &edges[2 * (j - 1)])) {
+				edges[2 * j] = edges[2 * i];
+				edges[2 * j + 1] = edges[2 * i + 1];
+				j++;
+			}
+		}
+		m = j;
+	}
+
+	ASSERT_CALL(!netio_write(outputFile, gen.n, m, edges, format), fprintf(stderr, "Error: %s: %s\n", strerror(errno), outputFilename));
+	fprintf(stderr, "%s: %u nodes, %u edges, %.3f s\n", outputFilename, gen.n, m, stats_now() - start);
+
+_err:
+
+	if(edges)
+		free(edges);
+
+	if(gen.chunks) {
+		for(i = 0; i < gen.noOfChunks; i++)
+			free(gen.chunks[i].edges);
+		free(gen.chunks);
+	}
+
+	if(threads)
+		free(threads);
+
+	if(outputFile)
+		fclose(outputFile);
+
+	if(outputFilename)
+		free(outputFilename);
+
+	return EXIT_SUCCESS;
+}
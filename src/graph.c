@@ -19,7 +19,21 @@
 #include "graph.h"
 
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "hugemem.h"
+
+#ifndef GRAPH_USE_ADJ_MATRIX
+/**
+ * @brief Check if the adjacency list of a node lives inside the pool of the graph.
+ * @note This is an internal function.
+ */
+static inline int _graph_isPooled(graph_t *graph, unsigned int orig) {
+	return graph->pool && (graph->adj[orig] >= graph->pool) && (graph->adj[orig] < (graph->pool + graph->poolSz));
+}
+#endif
 
 /**
  * @brief Create a graph with unconnected nodes.
@@ -31,13 +45,29 @@ void graph_create(graph_t **graph, unsigned int n, unsigned int m) {
 		return;
 
 	*graph = malloc(sizeof(graph_t));
+	if(!(*graph))
+		return;
 	(*graph)->n = n;
-	(*graph)->adj = malloc(n * sizeof(int *));
+	(*graph)->pool = NULL;
+	(*graph)->poolSz = 0;
+	(*graph)->adj = hugemem_alloc(n * sizeof(int *));
+	if(!((*graph)->adj)) {
+		graph_destroy(graph);
+		*graph = NULL;
+		return;
+	}
 
 #ifdef GRAPH_USE_ADJ_MATRIX
-	/* Create adjacency matrix for a totally disconnected graph */
+	/* Create adjacency matrix for a totally disconnected graph, all rows in a single block */
+	(*graph)->poolSz = (unsigned long) n * n;
+	(*graph)->pool = hugemem_calloc((*graph)->poolSz? (*graph)->poolSz : 1, sizeof(int));
+	if(!((*graph)->pool)) {
+		graph_destroy(graph);
+		*graph = NULL;
+		return;
+	}
 	for(i = 0; i < n; i++)
-		(*graph)->adj[i] = calloc(n, sizeof(int));
+		(*graph)->adj[i] = &((*graph)->pool[(unsigned long) i * n]);
 #else
 	/* Adjacency lists for each node are allocated on the fly */
 	for(i = 0; i < n; i++)
@@ -49,6 +79,334 @@ void graph_create(graph_t **graph, unsigned int n, unsigned int m) {
 #endif
 }
 
+/* Arguments passed to each thread of the graph builder */
+typedef struct {
+	graph_t *graph;
+	unsigned int *edges;
+	/* Range processed by this thread (edges or nodes, depending on the pass) */
+	unsigned int lo;
+	unsigned int hi;
+	/* Per-node counters (adjacency list only) */
+	unsigned int *degree;
+	/* Results of this thread */
+	unsigned int noOfDuplicates;
+	unsigned int noOfLoops;
+} _graph_builder_t;
+
+/**
+ * @brief Split [0, total) in noOfThreads ranges and run func over each one in its own thread.
+ * @note This is an internal function.
+ */
+static void _graph_parallelFor(unsigned int noOfThreads, unsigned int total, void *(*func)(void *), _graph_builder_t *args) {
+	int i;
+	pthread_t *threads = malloc(noOfThreads * sizeof(pthread_t));
+
+	for(i = 0; i < noOfThreads; i++) {
+		args[i].lo = (unsigned int) ((total * (unsigned long) i) / noOfThreads);
+		args[i].hi = (unsigned int) ((total * (unsigned long) (i + 1)) / noOfThreads);
+	}
+
+	/* No room to keep the thread handles: run every range here */
+	if(!threads) {
+		for(i = 0; i < noOfThreads; i++)
+			func(&args[i]);
+		return;
+	}
+
+	/* Current thread takes the first range, so that a single-threaded build spawns nothing */
+	for(i = 1; i < noOfThreads; i++) {
+		if(pthread_create(&threads[i], NULL, func, &args[i])) {
+			/* Could not spawn: do it here */
+			func(&args[i]);
+			threads[i] = pthread_self();
+		}
+	}
+	func(&args[0]);
+	for(i = 1; i < noOfThreads; i++) {
+		if(!pthread_equal(threads[i], pthread_self()))
+			pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+}
+
+#ifdef GRAPH_USE_ADJ_MATRIX
+/**
+ * @brief Builder pass for adjacency matrix: mark each edge, counting loops and repeated edges.
+ * @note This is an internal function.
+ */
+static void *_graph_markEdges(void *arg) {
+	_graph_builder_t *args = arg;
+	unsigned int i, orig, dest;
+
+	for(i = args->lo; i < args->hi; i++) {
+		orig = args->edges[2 * i];
+		dest = args->edges[2 * i + 1];
+
+		if(orig == dest) {
+			(args->noOfLoops)++;
+			continue;
+		}
+
+		/* The (min, max) element decides which of the repeated edges is the first one */
+		if(orig > dest) {
+			orig = args->edges[2 * i + 1];
+			dest = args->edges[2 * i];
+		}
+		if(__atomic_exchange_n(&(args->graph->adj[orig][dest]), 1, __ATOMIC_RELAXED))
+			(args->noOfDuplicates)++;
+		else
+			args->graph->adj[dest][orig] = 1;
+	}
+
+	return NULL;
+}
+#else
+/**
+ * @brief First builder pass for adjacency list: count the degree of each node, counting loops.
+ * @note This is an internal function.
+ */
+static void *_graph_countDegrees(void *arg) {
+	_graph_builder_t *args = arg;
+	unsigned int i, orig, dest;
+
+	for(i = args->lo; i < args->hi; i++) {
+		orig = args->edges[2 * i];
+		dest = args->edges[2 * i + 1];
+
+		if(orig == dest) {
+			(args->noOfLoops)++;
+		}
+		else {
+			__atomic_fetch_add(&(args->degree[orig]), 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&(args->degree[dest]), 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Second builder pass for adjacency list: put each edge in both adjacency lists.
+ * @note This is an internal function.
+ */
+static void *_graph_fillLists(void *arg) {
+	_graph_builder_t *args = arg;
+	int **adj = args->graph->adj;
+	unsigned int i, orig, dest;
+
+	for(i = args->lo; i < args->hi; i++) {
+		orig = args->edges[2 * i];
+		dest = args->edges[2 * i + 1];
+
+		if(orig != dest) {
+			/* Element [orig][1] is used as the fill cursor of the list */
+			adj[orig][__atomic_fetch_add(&(adj[orig][1]), 1, __ATOMIC_RELAXED) + 2] = dest;
+			adj[dest][__atomic_fetch_add(&(adj[dest][1]), 1, __ATOMIC_RELAXED) + 2] = orig;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Comparison function for qsort.
+ * @note This is an internal function.
+ */
+static int _graph_compare(const void *a, const void *b) {
+	int x = *((const int *) a);
+	int y = *((const int *) b);
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Last builder pass for adjacency list: sort each list and remove repeated nodes.
+ * @note This is an internal function.
+ */
+static void *_graph_sortLists(void *arg) {
+	_graph_builder_t *args = arg;
+	int **adj = args->graph->adj;
+	unsigned int v;
+	int i, j;
+
+	for(v = args->lo; v < args->hi; v++) {
+		if(!adj[v])
+			continue;
+
+		qsort(&(adj[v][2]), adj[v][1], sizeof(int), _graph_compare);
+
+		/* Compact the sorted list in place */
+		for(i = 1, j = 1; i < adj[v][1]; i++) {
+			if(adj[v][i + 2] != adj[v][j + 1])
+				adj[v][(j++) + 2] = adj[v][i + 2];
+		}
+		if(adj[v][1]) {
+			args->noOfDuplicates += adj[v][1] - j;
+			adj[v][1] = j;
+		}
+	}
+
+	return NULL;
+}
+#endif
+
+/**
+ * @brief Create a graph from a whole edge list (two-pass builder).
+ */
+int graph_createFromEdges(graph_t **graph, unsigned int n, unsigned int m, unsigned int *edges, unsigned int noOfThreads, unsigned int *noOfDuplicates, unsigned int *noOfLoops) {
+	int i;
+	_graph_builder_t *args;
+	unsigned int totalDuplicates = 0;
+	unsigned int totalLoops = 0;
+
+	if(!graph)
+		return -1;
+
+	if(!noOfThreads)
+		noOfThreads = 1;
+	args = calloc(noOfThreads, sizeof(_graph_builder_t));
+	if(!args) {
+		*graph = NULL;
+		return -1;
+	}
+
+	graph_create(graph, n, m);
+	if(!(*graph)) {
+		free(args);
+		return -1;
+	}
+	for(i = 0; i < noOfThreads; i++) {
+		args[i].graph = *graph;
+		args[i].edges = edges;
+	}
+
+#ifdef GRAPH_USE_ADJ_MATRIX
+	_graph_parallelFor(noOfThreads, m, _graph_markEdges, args);
+
+	for(i = 0; i < noOfThreads; i++) {
+		totalDuplicates += args[i].noOfDuplicates;
+		totalLoops += args[i].noOfLoops;
+	}
+#else
+	unsigned long offset = 0;
+	unsigned int *degree = calloc(n? n : 1, sizeof(unsigned int));
+
+	if(!degree) {
+		free(args);
+		graph_destroy(graph);
+		*graph = NULL;
+		return -1;
+	}
+
+	/* First pass: degrees */
+	for(i = 0; i < noOfThreads; i++)
+		args[i].degree = degree;
+	_graph_parallelFor(noOfThreads, m, _graph_countDegrees, args);
+	for(i = 0; i < noOfThreads; i++)
+		totalLoops += args[i].noOfLoops;
+
+	/* Allocate all lists at once with their exact sizes, each one keeping the two metadata elements */
+	for(i = 0; i < n; i++)
+		(*graph)->poolSz += degree[i]? (degree[i] + 2) : 0;
+	(*graph)->pool = hugemem_alloc(((*graph)->poolSz? (*graph)->poolSz : 1) * sizeof(int));
+	if(!((*graph)->pool)) {
+		free(degree);
+		free(args);
+		graph_destroy(graph);
+		*graph = NULL;
+		return -1;
+	}
+	for(i = 0; i < n; i++) {
+		if(degree[i]) {
+			(*graph)->adj[i] = &((*graph)->pool[offset]);
+			(*graph)->adj[i][0] = degree[i];
+			(*graph)->adj[i][1] = 0;
+			offset += degree[i] + 2;
+		}
+	}
+
+	/* Second pass: fill */
+	_graph_parallelFor(noOfThreads, m, _graph_fillLists, args);
+
+	/* Sort and remove repeated edges, which appear once on each end */
+	_graph_parallelFor(noOfThreads, n, _graph_sortLists, args);
+	for(i = 0; i < noOfThreads; i++)
+		totalDuplicates += args[i].noOfDuplicates;
+	totalDuplicates /= 2;
+
+	free(degree);
+#endif
+
+	free(args);
+
+	if(noOfDuplicates)
+		*noOfDuplicates = totalDuplicates;
+	if(noOfLoops)
+		*noOfLoops = totalLoops;
+
+	return 0;
+}
+
+/**
+ * @brief Create a copy of a graph.
+ */
+void graph_clone(graph_t **clone, graph_t *graph) {
+	int i;
+
+	if(!clone || !graph)
+		return;
+
+	*clone = malloc(sizeof(graph_t));
+	(*clone)->n = graph->n;
+	(*clone)->adj = hugemem_alloc(graph->n * sizeof(int *));
+
+#ifdef GRAPH_USE_ADJ_MATRIX
+	(*clone)->poolSz = graph->poolSz;
+	(*clone)->pool = hugemem_alloc(((*clone)->poolSz? (*clone)->poolSz : 1) * sizeof(int));
+	memcpy((*clone)->pool, graph->pool, (*clone)->poolSz * sizeof(int));
+	for(i = 0; i < graph->n; i++)
+		(*clone)->adj[i] = &((*clone)->pool[(unsigned long) i * graph->n]);
+#else
+	unsigned long offset = 0;
+
+	(*clone)->chunkSz = graph->chunkSz;
+	(*clone)->poolSz = 0;
+	for(i = 0; i < graph->n; i++)
+		(*clone)->poolSz += graph->adj[i]? (graph->adj[i][1] + 2) : 0;
+	(*clone)->pool = hugemem_alloc(((*clone)->poolSz? (*clone)->poolSz : 1) * sizeof(int));
+
+	/* Lists are packed without spare room: capacity equals the number of adjacents */
+	for(i = 0; i < graph->n; i++) {
+		if(graph->adj[i]) {
+			(*clone)->adj[i] = &((*clone)->pool[offset]);
+			(*clone)->adj[i][0] = graph->adj[i][1];
+			memcpy(&((*clone)->adj[i][1]), &(graph->adj[i][1]), (graph->adj[i][1] + 1) * sizeof(int));
+			offset += graph->adj[i][1] + 2;
+		}
+		else {
+			(*clone)->adj[i] = NULL;
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Estimate the memory taken by a graph built by graph_createFromEdges.
+ */
+unsigned long long graph_estimateMemory(unsigned int n, unsigned int m) {
+	unsigned long long size = sizeof(graph_t) + ((unsigned long long) n * sizeof(int *));
+
+#ifdef GRAPH_USE_ADJ_MATRIX
+	size += (unsigned long long) n * n * sizeof(int);
+#else
+	/* Pool: two metadata elements per node and one element per edge end */
+	size += ((2ull * m) + (2ull * n)) * sizeof(int);
+#endif
+
+	return size;
+}
+
 /**
  * @brief Connect two nodes.
  */
@@ -67,7 +425,16 @@ void graph_putEdge(graph_t *graph, unsigned int orig, unsigned int dest) {
 			if(graph->adj[orig][0] == graph->adj[orig][1]) {
 				/* Increase the size of this list in chunkSz elements */
 				graph->adj[orig][0] += graph->chunkSz;
-				graph->adj[orig] = realloc(graph->adj[orig], (graph->adj[orig][0] + 2) * sizeof(int));
+
+				/* Lists inside the pool were not malloc'ed on their own: move to a new list instead */
+				if(_graph_isPooled(graph, orig)) {
+					int *tmpPointer = malloc((graph->adj[orig][0] + 2) * sizeof(int));
+					memcpy(tmpPointer, graph->adj[orig], (graph->adj[orig][1] + 2) * sizeof(int));
+					graph->adj[orig] = tmpPointer;
+				}
+				else {
+					graph->adj[orig] = realloc(graph->adj[orig], (graph->adj[orig][0] + 2) * sizeof(int));
+				}
 			}
 		}
 		/* No adjacency list created yet */
@@ -131,12 +498,17 @@ int *graph_getAdjacents(graph_t *graph, unsigned int orig, unsigned int *noOfAdj
  * @brief Destroy a graph; free memory.
  */
 void graph_destroy(graph_t **graph) {
-	int i;
-
 	if(graph && *graph) {
-		for(i = 0; i < (*graph)->n; i++)
-			free((*graph)->adj[i]);
-		free((*graph)->adj);
+#ifndef GRAPH_USE_ADJ_MATRIX
+		int i;
+
+		for(i = 0; (*graph)->adj && (i < (*graph)->n); i++) {
+			if(!_graph_isPooled(*graph, i))
+				free((*graph)->adj[i]);
+		}
+#endif
+		hugemem_free((*graph)->pool);
+		hugemem_free((*graph)->adj);
 
 		free(*graph);
 	}
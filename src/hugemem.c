@@ -0,0 +1,281 @@
+/* ********************************************************************************************* */
+/* * Simple huge-page backed allocation: libhugemem                                            * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libhugemem is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libhugemem is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libhugemem.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#define _GNU_SOURCE
+
+#include "hugemem.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+/* Explicit huge pages of HUGEMEM_PAGE_SZ, whatever the default size of the system */
+#define _HUGEMEM_MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+
+/* A block mapped on its own */
+typedef struct {
+	void *addr;
+	/* Size of the mapping, in bytes */
+	size_t size;
+	/* Whether it comes from the hugetlbfs pool (otherwise, transparent huge pages were requested) */
+	bool explicit;
+} _hugemem_region_t;
+
+/* Blocks mapped on their own, so that they can be told apart from heap blocks when freed */
+static pthread_mutex_t _hugemem_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _hugemem_region_t *_hugemem_regions = NULL;
+static unsigned int _hugemem_noOfRegions = 0;
+static unsigned int _hugemem_capacity = 0;
+static int _hugemem_policy = HUGEMEM_AUTO;
+
+/**
+ * @brief Map a block with explicit huge pages.
+ * @param size Reference to the size of the block, rounded up to the size of the mapping.
+ * @return Pointer to the mapping, or NULL if not enough huge pages are reserved.
+ * @note This is an internal function.
+ */
+static void *_hugemem_mapExplicit(size_t *size) {
+	size_t mapSz = (*size + HUGEMEM_PAGE_SZ - 1) & ~(HUGEMEM_PAGE_SZ - 1);
+	void *ptr = mmap(NULL, mapSz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | _HUGEMEM_MAP_HUGE_2MB, -1, 0);
+
+	if(MAP_FAILED == ptr)
+		return NULL;
+
+	*size = mapSz;
+	return ptr;
+}
+
+/**
+ * @brief Map a block aligned to HUGEMEM_PAGE_SZ and ask for transparent huge pages.
+ * @param size Reference to the size of the block, rounded up to the size of the mapping.
+ * @return Pointer to the mapping, or NULL if it failed.
+ * @note This is an internal function.
+ */
+static void *_hugemem_mapTransparent(size_t *size) {
+	size_t pageSz = sysconf(_SC_PAGESIZE);
+	size_t mapSz = (*size + pageSz - 1) & ~(pageSz - 1);
+	uintptr_t raw, aligned;
+	void *ptr;
+
+	/* Map one huge page more and trim both ends, so that the start is aligned */
+	ptr = mmap(NULL, mapSz + HUGEMEM_PAGE_SZ, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(MAP_FAILED == ptr)
+		return NULL;
+
+	raw = (uintptr_t) ptr;
+	aligned = (raw + HUGEMEM_PAGE_SZ - 1) & ~((uintptr_t) HUGEMEM_PAGE_SZ - 1);
+	if(aligned > raw)
+		munmap(ptr, aligned - raw);
+	if(HUGEMEM_PAGE_SZ > aligned - raw)
+		munmap((void *) (aligned + mapSz), HUGEMEM_PAGE_SZ - (aligned - raw));
+
+	/* Refused on kernels without transparent huge pages: regular pages are used then */
+	madvise((void *) aligned, mapSz, MADV_HUGEPAGE);
+
+	*size = mapSz;
+	return (void *) aligned;
+}
+
+/**
+ * @brief Record a block mapped on its own.
+ * @return 0 on success, -1 if no memory is left.
+ * @note This is an internal function.
+ */
+static int _hugemem_register(void *addr, size_t size, bool explicit) {
+	_hugemem_region_t *regions;
+	int rv = 0;
+
+	pthread_mutex_lock(&_hugemem_mutex);
+
+	if(_hugemem_noOfRegions == _hugemem_capacity) {
+		regions = realloc(_hugemem_regions, (_hugemem_capacity? (2 * _hugemem_capacity) : 16) * sizeof(_hugemem_region_t));
+		if(regions) {
+			_hugemem_regions = regions;
+			_hugemem_capacity = _hugemem_capacity? (2 * _hugemem_capacity) : 16;
+		}
+	}
+
+	if(_hugemem_noOfRegions < _hugemem_capacity) {
+		_hugemem_regions[_hugemem_noOfRegions].addr = addr;
+		_hugemem_regions[_hugemem_noOfRegions].size = size;
+		_hugemem_regions[_hugemem_noOfRegions].explicit = explicit;
+		_hugemem_noOfRegions++;
+	}
+	else {
+		rv = -1;
+	}
+
+	pthread_mutex_unlock(&_hugemem_mutex);
+
+	return rv;
+}
+
+/**
+ * @brief Map a block on its own, according to the policy.
+ * @return Pointer to the block, or NULL if it should come from the heap instead.
+ * @note This is an internal function.
+ */
+static void *_hugemem_map(size_t size) {
+	int policy = __atomic_load_n(&_hugemem_policy, __ATOMIC_RELAXED);
+	size_t mapSz = size;
+	bool explicit = false;
+	void *ptr = NULL;
+
+	if((HUGEMEM_NONE == policy) || (size < HUGEMEM_PAGE_SZ))
+		return NULL;
+
+	if(HUGEMEM_AUTO == policy) {
+		ptr = _hugemem_mapExplicit(&mapSz);
+		explicit = (ptr != NULL);
+	}
+	if(!ptr)
+		ptr = _hugemem_mapTransparent(&mapSz);
+
+	if(ptr && _hugemem_register(ptr, mapSz, explicit)) {
+		munmap(ptr, mapSz);
+		ptr = NULL;
+	}
+
+	return ptr;
+}
+
+/**
+ * @brief Set the allocation policy of following allocations (HUGEMEM_AUTO by default).
+ */
+void hugemem_setPolicy(int policy) {
+	__atomic_store_n(&_hugemem_policy, policy, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Allocate a block.
+ */
+void *hugemem_alloc(size_t size) {
+	void *ptr = _hugemem_map(size);
+
+	if(!ptr && posix_memalign(&ptr, HUGEMEM_ALIGN, size? size : 1))
+		return NULL;
+
+	return ptr;
+}
+
+/**
+ * @brief Allocate a block filled with zeros.
+ */
+void *hugemem_calloc(size_t nmemb, size_t size) {
+	void *ptr;
+
+	if(size && (nmemb > SIZE_MAX / size))
+		return NULL;
+
+	/* Mapped blocks are already zeroed; the fallback must not try mapping again */
+	ptr = _hugemem_map(nmemb * size);
+	if(ptr)
+		return ptr;
+
+	if(posix_memalign(&ptr, HUGEMEM_ALIGN, (nmemb && size)? (nmemb * size) : 1))
+		return NULL;
+	memset(ptr, 0, nmemb * size);
+
+	return ptr;
+}
+
+/**
+ * @brief Free a block allocated by hugemem_alloc or hugemem_calloc.
+ */
+void hugemem_free(void *ptr) {
+	unsigned int i;
+	size_t size = 0;
+
+	if(!ptr)
+		return;
+
+	/* Blocks are usually freed in reverse order */
+	pthread_mutex_lock(&_hugemem_mutex);
+	for(i = _hugemem_noOfRegions; i-- > 0;) {
+		if(_hugemem_regions[i].addr == ptr) {
+			size = _hugemem_regions[i].size;
+			_hugemem_regions[i] = _hugemem_regions[--_hugemem_noOfRegions];
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_hugemem_mutex);
+
+	if(size)
+		munmap(ptr, size);
+	else
+		free(ptr);
+}
+
+/**
+ * @brief Get how much of the memory of blocks mapped on their own is backed by huge pages.
+ */
+int hugemem_usage(unsigned long long *total, unsigned long long *huge) {
+	FILE *file;
+	char line[256];
+	unsigned long start, end;
+	unsigned long long kib;
+	unsigned int i;
+	bool counted = false;
+	bool transparent = false;
+
+	*total = 0;
+	*huge = 0;
+
+	pthread_mutex_lock(&_hugemem_mutex);
+
+	for(i = 0; i < _hugemem_noOfRegions; i++) {
+		*total += _hugemem_regions[i].size;
+		if(_hugemem_regions[i].explicit)
+			*huge += _hugemem_regions[i].size;
+		else
+			transparent = true;
+	}
+
+	/* Transparent huge pages are only known per mapping: add those of mappings holding our blocks */
+	file = transparent? fopen("/proc/self/smaps", "r") : NULL;
+	if(file) {
+		while(fgets(line, sizeof(line), file)) {
+			if(2 == sscanf(line, "%lx-%lx ", &start, &end)) {
+				counted = false;
+				for(i = 0; (i < _hugemem_noOfRegions) && !counted; i++) {
+					counted = !(_hugemem_regions[i].explicit) && ((uintptr_t) _hugemem_regions[i].addr < end) &&
+						((uintptr_t) _hugemem_regions[i].addr + _hugemem_regions[i].size > start);
+				}
+			}
+			else if(counted && (1 == sscanf(line, "AnonHugePages: %llu kB", &kib))) {
+				*huge += kib * 1024;
+			}
+		}
+		fclose(file);
+	}
+
+	pthread_mutex_unlock(&_hugemem_mutex);
+
+	if(*huge > *total)
+		*huge = *total;
+
+	return (transparent && !file)? -1 : 0;
+}
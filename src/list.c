@@ -34,48 +34,6 @@
 /* * Type-agnostic list functions (INTERNAL USAGE ONLY)                                        * */
 /* ********************************************************************************************* */
 
-/**
- * @brief ASSIGN macro. According to the list type, it will assign/copy the input value differently.
- * @param type The list type (TYPE_D, TYPE_LF or TYPE_S).
- * @param val The union variable to receive the input.
- * @param dval Integer value to be assigned. It is ignored if type != TYPE_D.
- * @param lfval Double value to be assigned. It is ignored if type != TYPE_LF.
- * @param sval String value to be copied. It is ignored if type != TYPE_S.
- */
-#define ASSIGN(type, val, dval, lfval, sval) {\
-	switch(type) {\
-		case TYPE_LF:\
-			val.lf = lfval;\
-			break;\
-		case TYPE_S:\
-			if(sval) {\
-				val.s = malloc(strnlen(sval, MAX_STR_SZ - 1) + 1);\
-				strcpy(val.s, sval);\
-			}\
-			else {\
-				val.s = NULL;\
-			}\
-			break;\
-		default:\
-			val.d = dval;\
-			break;\
-	}\
-}
-
-/**
- * @brief DEALLOC macro. According to the list type, it will free up resources if necessary.
- * @param type The list type (TYPE_D, TYPE_LF or TYPE_S).
- * @param val The union variable to be deallocated.
- */
-#define DEALLOC(type, val) {\
-	switch(type) {\
-		case TYPE_S:\
-			if(val.s)\
-				free(val.s);\
-			break;\
-	}\
-}
-
 /**
  * @brief Create a list.
  * @note This is an internal function. Use the functions with defined types instead.
@@ -92,257 +50,65 @@ list_t *_list_create(unsigned int type) {
 }
 
 /**
- * @brief Destroy a list; free up memory.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_destroy(list_t **list) {
-	elem_t *tmpPointer = (*list)->head;
-	elem_t *tmpPointerNext;
-
-	/* Iterate through the list and delete everything */
-	while(tmpPointer) {
-		tmpPointerNext = tmpPointer->next;
-		DEALLOC((*list)->type, tmpPointer->val);
-		free(tmpPointer);
-		tmpPointer = tmpPointerNext;
-	}
-
-	free(*list);
-	*list = NULL;
-}
-
-/**
- * @brief Trim a list, leaving it with n elements.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_trim(list_t **list, unsigned int n) {
-	/* Trim if the list has elements */
-	if(n) {
-		elem_t *tmpPointer = (*list)->head;
-		elem_t *tmpPointerNext;
-
-		/* Iterate through the list */
-		int i;
-		for(i = 0; tmpPointer; i++) {
-			tmpPointerNext = tmpPointer->next;
-			/* After passing through n elements, start deleting stuff */
-			if(i >= n) {
-				DEALLOC((*list)->type, tmpPointer->val);
-				free(tmpPointer);
-			}
-			else if((n - 1) == i) {
-				tmpPointer->next = NULL;
-#ifndef LIST_DISABLE_TAIL
-				(*list)->tail = tmpPointer;
-#endif
-			}
-
-			tmpPointer = tmpPointerNext;
-		}
-
-		(*list)->size = n;
-	}
-	else
-		_list_destroy(list);
-} 
-
-/**
- * @brief Insert an element at the end of the list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_pushBack(list_t *list, int dval, double lfval, char *sval) {
-	/* List has elements */
-	if(list->head) {
-#ifndef LIST_DISABLE_TAIL
-		/* With tail pointer, there's no need to iterate through the whole list to pushBack */
-
-		elem_t *tmpPointer = malloc(sizeof(elem_t));
-		tmpPointer->next = NULL;
-		ASSIGN(list->type, tmpPointer->val, dval, lfval, sval);
-
-		list->tail->next = tmpPointer;
-		list->tail = tmpPointer;
-#else
-		elem_t *tmpPointer = list->head;
-
-		/* Iterate 'till the end of the list */
-		while(tmpPointer->next)
-			tmpPointer = tmpPointer->next;
-
-		tmpPointer->next = malloc(sizeof(elem_t));
-		tmpPointer->next->next = NULL;
-		ASSIGN(list->type, tmpPointer->next->val, dval, lfval, sval);
-#endif
-	}
-	/* List has no elements */
-	else {
-		list->head = malloc(sizeof(elem_t));
-		list->head->next = NULL;
-#ifndef LIST_DISABLE_TAIL
-		list->tail = list->head;
-#endif
-		ASSIGN(list->type, list->head->val, dval, lfval, sval);
-	}
-
-	(list->size)++;
-}
-
-/**
- * @brief Discard the first element of the list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_popFront(list_t *list) {
-	if(list->head) {
-		elem_t *tmpPointer = list->head->next;
-		DEALLOC(list->type, list->head->val);
-		free(list->head);
-		list->head = tmpPointer;
-		(list->size)--;
-
-#ifndef LIST_DISABLE_TAIL
-		if(!(list->size))
-			list->tail = NULL;
-#endif
-	}
-}
-
-/**
- * @brief Insert an element at the beginning of the list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_pushFront(list_t *list, int dval, double lfval, char *sval) {
-	elem_t *tmpPointer = list->head;
-
-	list->head = malloc(sizeof(elem_t));
-	list->head->next = tmpPointer;
-	ASSIGN(list->type, list->head->val, dval, lfval, sval);
-
-	(list->size)++;
-
-#ifndef LIST_DISABLE_TAIL
-	if(1 == list->size)
-		list->tail = list->head;
-#endif
-}
-
-/**
- * @brief Retrieves the first element in this list.
+ * @brief Check if this list is empty.
  * @note This is an internal function. Use the functions with defined types instead.
  */
-elem_u _list_front(list_t *list) {
-	return list->head->val;
+bool _list_isEmpty(list_t *list) {
+	return (0 == list->size);
 }
 
 /**
- * @brief Retrieves the last element in this list.
+ * @brief Retrieves the size of this list.
  * @note This is an internal function. Use the functions with defined types instead.
  */
-elem_u _list_back(list_t *list) {
-#ifndef LIST_DISABLE_TAIL
-	/* No need to iterate the whole list if we have a tail pointer */
-	return list->tail->val;
-#else
-	elem_t *tmpPointer = list->head;
-
-	/* Iterate through the whole list */
-	while(tmpPointer->next)
-		tmpPointer = tmpPointer->next;
-
-	return tmpPointer->val;
-#endif
+unsigned int _list_size(list_t *list) {
+	return list->size;
 }
 
-/**
- * @brief Retrieves an element from this list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-elem_u _list_get(list_t *list, unsigned int pos) {
-	elem_t *tmpPointer = list->head;
+/* ********************************************************************************************* */
+/* * Type-specialised list functions (INTERNAL USAGE ONLY)                                     * */
+/* ********************************************************************************************* */
 
-	int i;
-	for(i = 0; i < pos; i++)
-		tmpPointer = tmpPointer->next;
+/* Each inclusion of list_tmpl.h generates a node layout and the _Xlist_* functions for one type */
+/* Since the type is known at compile time, no runtime switch on list->type is needed */
 
-	return tmpPointer->val;
-}
+/* Integers: delem_t, _dlist_* */
+#define LIST_NAME d
+#define LIST_TYPE int
+#define LIST_ASSIGN(dst, src) ((dst) = (src))
+#define LIST_DEALLOC(val)
+#include "list_tmpl.h"
 
-/**
- * @brief Inserts an element in this list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-void _list_insert(list_t *list, unsigned int pos, int dval, double lfval, char *sval) {
-	/* List has elements */
-	if(list->head) {
-		elem_t *tmpCurr = NULL;
-		elem_t *tmpNext = list->head;
-
-		/* Iterate 'till the pos-th position */
-		int i;
-		for(i = 0; i < pos; i++) {
-			tmpCurr = tmpNext;
-			tmpNext = tmpNext->next;
-		}
-
-		/* Malloc a new element, assign it and refresh pointers */
-		elem_t *tmpElem = malloc(sizeof(elem_t));
-		tmpElem->next = tmpNext;
-		ASSIGN(list->type, tmpElem->val, dval, lfval, sval);
-		if(tmpCurr)
-			tmpCurr->next = tmpElem;
-		else
-			list->head = tmpElem;
-
-#ifndef LIST_DISABLE_TAIL
-		if(pos == list->size)
-			list->tail = tmpElem;
-#endif
-	}
-	/* List has no elements */
-	else {
-		list->head = malloc(sizeof(elem_t));
-		list->head->next = NULL;
-#ifndef LIST_DISABLE_TAIL
-		list->tail = list->head;
-#endif
-		ASSIGN(list->type, list->head->val, dval, lfval, sval);
-	}
-
-	(list->size)++;
-}
+/* Doubles: lfelem_t, _lflist_* */
+#define LIST_NAME lf
+#define LIST_TYPE double
+#define LIST_ASSIGN(dst, src) ((dst) = (src))
+#define LIST_DEALLOC(val)
+#include "list_tmpl.h"
 
 /**
- * @brief Swap a position in this list with a new element.
+ * @brief Copy a string to be stored in a string list.
  * @note This is an internal function. Use the functions with defined types instead.
  */
-void _list_swap(list_t *list, unsigned int pos, int dval, double lfval, char *sval) {
-	if(list->head) {
-		elem_t *tmpNext = list->head;
+static inline char *_slist_copy(char *val) {
+	char *copy = NULL;
 
-		int i;
-		for(i = 0; i < pos; i++)
-			tmpNext = tmpNext->next;
-
-		/* Just dealloc and reassign solves this problem */
-		DEALLOC(list->type, tmpNext->val);
-		ASSIGN(list->type, tmpNext->val, dval, lfval, sval);
+	if(val) {
+		size_t len = strnlen(val, MAX_STR_SZ - 1);
+		copy = malloc(len + 1);
+		memcpy(copy, val, len);
+		copy[len] = '\0';
 	}
-}
 
-/**
- * @brief Check if this list is empty.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-bool _list_isEmpty(list_t *list) {
-	return (0 == list->size);
+	return copy;
 }
 
-/**
- * @brief Retrieves the size of this list.
- * @note This is an internal function. Use the functions with defined types instead.
- */
-unsigned int _list_size(list_t *list) {
-	return list->size;
-}
+/* Strings: selem_t, _slist_* */
+#define LIST_NAME s
+#define LIST_TYPE char *
+#define LIST_ASSIGN(dst, src) ((dst) = _slist_copy(src))
+#define LIST_DEALLOC(val) free(val)
+#include "list_tmpl.h"
 
 /* ********************************************************************************************* */
 /* * List functions for integers                                                                * */
@@ -359,70 +125,70 @@ list_t *dlist_create(void) {
  * @brief Destroy a list of integers; free up memory.
  */
 void dlist_destroy(list_t **list) {
-	_list_destroy(list);
+	_dlist_destroy(list);
 }
 
 /**
  * @brief Trim a list of integers, leaving it with n elements.
  */
 void dlist_trim(list_t **list, unsigned int n) {
-	_list_trim(list, n);
+	_dlist_trim(list, n);
 } 
 
 /**
  * @brief Insert an integer at the end of the list.
  */
 void dlist_pushBack(list_t *list, int val) {
-	_list_pushBack(list, val, -1, NULL);
+	_dlist_pushBack(list, val);
 }
 
 /**
  * @brief Discard the first element of the list of integers.
  */
 void dlist_popFront(list_t *list) {
-	_list_popFront(list);
+	_dlist_popFront(list);
 }
 
 /**
  * @brief Insert an integer at the beginning of the list.
  */
 void dlist_pushFront(list_t *list, int val) {
-	_list_pushFront(list, val, -1, NULL);
+	_dlist_pushFront(list, val);
 }
 
 /**
  * @brief Retrieves the first integer in this list.
  */
 int dlist_front(list_t *list) {
-	return _list_front(list).d;
+	return _dlist_front(list);
 }
 
 /**
  * @brief Retrieves the last integer in this list.
  */
 int dlist_back(list_t *list) {
-	return _list_back(list).d;
+	return _dlist_back(list);
 }
 
 /**
  * @brief Retrieves an integer from this list.
  */
 int dlist_get(list_t *list, unsigned int pos) {
-	return _list_get(list, pos).d;
+	return _dlist_get(list, pos);
 }
 
 /**
  * @brief Inserts an integer in this list.
  */
 void dlist_insert(list_t *list, unsigned int pos, int val) {
-	_list_insert(list, pos, val, -1, NULL);
+	_dlist_insert(list, pos, val);
 }
 
 /**
  * @brief Swap a position in this list with a new integer.
  */
 void dlist_swap(list_t *list, unsigned int pos, int val) {
-	_list_swap(list, pos, val, -1, NULL);
+	_dlist_swap(list, pos, val);
 }
 
 /**
@@ -454,70 +220,70 @@ list_t *lflist_create(void) {
  * @brief Similar logic of @f dlist_destroy but for double values.
  */
 void lflist_destroy(list_t **list) {
-	_list_destroy(list);
+	_lflist_destroy(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_trim but for double values.
  */
 void lflist_trim(list_t **list, unsigned int n) {
-	_list_trim(list, n);
+	_lflist_trim(list, n);
 } 
 
 /**
  * @brief Similar logic of @f dlist_pushBack but for double values.
  */
 void lflist_pushBack(list_t *list, double val) {
-	_list_pushBack(list, -1, val, NULL);
+	_lflist_pushBack(list, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_popFront but for double values.
  */
 void lflist_popFront(list_t *list) {
-	_list_popFront(list);
+	_lflist_popFront(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_pushFront but for double values.
  */
 void lflist_pushFront(list_t *list, double val) {
-	_list_pushFront(list, -1, val, NULL);
+	_lflist_pushFront(list, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_front but for double values.
  */
 double lflist_front(list_t *list) {
-	return _list_front(list).lf;
+	return _lflist_front(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_back but for double values.
  */
 double lflist_back(list_t *list) {
-	return _list_back(list).lf;
+	return _lflist_back(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_get but for double values.
  */
 double lflist_get(list_t *list, unsigned int pos) {
-	return _list_get(list, pos).lf;
+	return _lflist_get(list, pos);
 }
 
 /**
  * @brief Similar logic of @f dlist_insert but for double values.
  */
 void lflist_insert(list_t *list, unsigned int pos, double val) {
-	_list_insert(list, pos, -1, val, NULL);
+	_lflist_insert(list, pos, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_swap but for double values.
  */
 void lflist_swap(list_t *list, unsigned int pos, double val) {
-	_list_swap(list, pos, -1, val, NULL);
+	_lflist_swap(list, pos, val);
 }
 
 /**
@@ -549,70 +315,70 @@ list_t *slist_create(void) {
  * @brief Similar logic of @f dlist_destroy but for string values.
  */
 void slist_destroy(list_t **list) {
-	_list_destroy(list);
+	_slist_destroy(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_trim but for string values.
  */
 void slist_trim(list_t **list, unsigned int n) {
-	_list_trim(list, n);
+	_slist_trim(list, n);
 } 
 
 /**
  * @brief Similar logic of @f dlist_pushBack but for string values.
  */
 void slist_pushBack(list_t *list, char *val) {
-	_list_pushBack(list, -1, -1, val);
+	_slist_pushBack(list, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_popFront but for string values.
  */
 void slist_popFront(list_t *list) {
-	_list_popFront(list);
+	_slist_popFront(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_pushFront but for string values.
  */
 void slist_pushFront(list_t *list, char *val) {
-	_list_pushFront(list, -1, -1, val);
+	_slist_pushFront(list, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_front but for string values.
  */
 char *slist_front(list_t *list) {
-	return _list_front(list).s;
+	return _slist_front(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_back but for string values.
  */
 char *slist_back(list_t *list) {
-	return _list_back(list).s;
+	return _slist_back(list);
 }
 
 /**
  * @brief Similar logic of @f dlist_get but for string values.
  */
 char *slist_get(list_t *list, unsigned int pos) {
-	return _list_get(list, pos).s;
+	return _slist_get(list, pos);
 }
 
 /**
  * @brief Similar logic of @f dlist_insert but for string values.
  */
 void slist_insert(list_t *list, unsigned int pos, char *val) {
-	_list_insert(list, pos, -1, -1, val);
+	_slist_insert(list, pos, val);
 }
 
 /**
  * @brief Similar logic of @f dlist_swap but for string values.
  */
 void slist_swap(list_t *list, unsigned int pos, char *val) {
-	_list_swap(list, pos, -1, -1, val);
+	_slist_swap(list, pos, val);
 }
 
 /**
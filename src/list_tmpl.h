@@ -0,0 +1,550 @@
+/* ********************************************************************************************* */
+/* * Simple library for a linked list implementation: liblist                                  * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * liblist is free software: you can redistribute it and/or modify it under the terms of     * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * liblist is distributed in the hope that it will be useful, but WITHOUT ANY                * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with liblist.     * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+/* ********************************************************************************************* */
+/* * Type-specialised list template (INTERNAL USAGE ONLY)                                      * */
+/* ********************************************************************************************* */
+/* * This file is included once per element type by list.c, no include guard on purpose.     * */
+/* * The following macros must be defined before including it (they are undefined at the end): * */
+/* * - LIST_NAME: prefix of the generated names (e.g. d generates delem_t, _dlist_pushBack);   * */
+/* * - LIST_TYPE: element type (e.g. int);                                                     * */
+/* * - LIST_ASSIGN(dst, src): assigns/copies src into the node slot dst;                       * */
+/* * - LIST_DEALLOC(val): frees up resources held by the node slot val, if any.                * */
+/* ********************************************************************************************* */
+
+#ifndef LIST_CAT
+#define LIST_CAT_(a, b) a ## b
+#define LIST_CAT(a, b) LIST_CAT_(a, b)
+#endif
+
+/* Generated names */
+#define LIST_NODE LIST_CAT(LIST_NAME, elem_t)
+#define LIST_FN(fn) LIST_CAT(LIST_CAT(_, LIST_NAME), LIST_CAT(list_, fn))
+
+#ifdef LIST_USE_UNROLLED
+/* Structure of an unrolled list node: a small array of values, the range in use and pointer to next node */
+/* Values in use are val[first] up to val[first + count - 1] */
+typedef struct LIST_NODE {
+	unsigned int first;
+	unsigned int count;
+	LIST_TYPE val[LIST_UNROLL_SZ];
+	struct LIST_NODE *next;
+} LIST_NODE;
+
+/**
+ * @brief Allocate an empty unrolled node.
+ */
+static inline LIST_NODE *LIST_FN(newNode)(unsigned int first) {
+	LIST_NODE *node = malloc(sizeof(LIST_NODE));
+	node->first = first;
+	node->count = 0;
+	node->next = NULL;
+	return node;
+}
+
+/**
+ * @brief Find the node holding the pos-th element. pos is updated to the offset inside that node.
+ */
+static inline LIST_NODE *LIST_FN(seek)(list_t *list, unsigned int *pos) {
+	LIST_NODE *tmpPointer = list->head;
+
+	/* Whole nodes are skipped at once, only the node count is inspected */
+	while(*pos >= tmpPointer->count) {
+		*pos -= tmpPointer->count;
+		tmpPointer = tmpPointer->next;
+	}
+
+	return tmpPointer;
+}
+
+/**
+ * @brief Retrieves the last node of this list.
+ */
+static inline LIST_NODE *LIST_FN(lastNode)(list_t *list) {
+#ifndef LIST_DISABLE_TAIL
+	return list->tail;
+#else
+	LIST_NODE *tmpPointer = list->head;
+
+	/* Iterate through the whole list */
+	while(tmpPointer && tmpPointer->next)
+		tmpPointer = tmpPointer->next;
+
+	return tmpPointer;
+#endif
+}
+
+/**
+ * @brief Destroy a list; free up memory.
+ */
+static inline void LIST_FN(destroy)(list_t **list) {
+	LIST_NODE *tmpPointer = (*list)->head;
+	LIST_NODE *tmpPointerNext;
+	unsigned int i;
+
+	/* Iterate through the list and delete everything */
+	while(tmpPointer) {
+		tmpPointerNext = tmpPointer->next;
+		for(i = tmpPointer->first; i < tmpPointer->first + tmpPointer->count; i++)
+			LIST_DEALLOC(tmpPointer->val[i]);
+		free(tmpPointer);
+		tmpPointer = tmpPointerNext;
+	}
+
+	free(*list);
+	*list = NULL;
+}
+
+/**
+ * @brief Trim a list, leaving it with n elements.
+ */
+static inline void LIST_FN(trim)(list_t **list, unsigned int n) {
+	/* Trim if the list has elements */
+	if(n) {
+		/* Nothing to do if the list is not bigger than n */
+		if(n < (*list)->size) {
+			unsigned int pos = n - 1;
+			LIST_NODE *tmpPointer = LIST_FN(seek)(*list, &pos);
+			LIST_NODE *tmpPointerNext = tmpPointer->next;
+			unsigned int i;
+
+			/* Cut the node holding the n-th element right after it */
+			for(i = tmpPointer->first + pos + 1; i < tmpPointer->first + tmpPointer->count; i++)
+				LIST_DEALLOC(tmpPointer->val[i]);
+			tmpPointer->count = pos + 1;
+			tmpPointer->next = NULL;
+#ifndef LIST_DISABLE_TAIL
+			(*list)->tail = tmpPointer;
+#endif
+
+			/* Delete all nodes after it */
+			while(tmpPointerNext) {
+				tmpPointer = tmpPointerNext->next;
+				for(i = tmpPointerNext->first; i < tmpPointerNext->first + tmpPointerNext->count; i++)
+					LIST_DEALLOC(tmpPointerNext->val[i]);
+				free(tmpPointerNext);
+				tmpPointerNext = tmpPointer;
+			}
+
+			(*list)->size = n;
+		}
+	}
+	else
+		LIST_FN(destroy)(list);
+}
+
+/**
+ * @brief Insert an element at the end of the list.
+ */
+static inline void LIST_FN(pushBack)(list_t *list, LIST_TYPE val) {
+	LIST_NODE *tmpPointer = LIST_FN(lastNode)(list);
+
+	/* Last node is missing or has no free slot at its end: link a new one, filled from the start */
+	if(!tmpPointer || (LIST_UNROLL_SZ == (tmpPointer->first + tmpPointer->count))) {
+		LIST_NODE *tmpElem = LIST_FN(newNode)(0);
+
+		if(tmpPointer)
+			tmpPointer->next = tmpElem;
+		else
+			list->head = tmpElem;
+#ifndef LIST_DISABLE_TAIL
+		list->tail = tmpElem;
+#endif
+		tmpPointer = tmpElem;
+	}
+
+	LIST_ASSIGN(tmpPointer->val[tmpPointer->first + tmpPointer->count], val);
+	(tmpPointer->count)++;
+	(list->size)++;
+}
+
+/**
+ * @brief Discard the first element of the list.
+ */
+static inline void LIST_FN(popFront)(list_t *list) {
+	LIST_NODE *head = list->head;
+
+	if(head) {
+		LIST_DEALLOC(head->val[head->first]);
+		(head->first)++;
+		(head->count)--;
+		(list->size)--;
+
+		/* Head node drained: release it */
+		if(!(head->count)) {
+			list->head = head->next;
+			free(head);
+		}
+
+#ifndef LIST_DISABLE_TAIL
+		if(!(list->size))
+			list->tail = NULL;
+#endif
+	}
+}
+
+/**
+ * @brief Insert an element at the beginning of the list.
+ */
+static inline void LIST_FN(pushFront)(list_t *list, LIST_TYPE val) {
+	LIST_NODE *head = list->head;
+
+	/* Head node is missing or has no free slot before its first element: link a new one, filled from the end */
+	if(!head || !(head->first)) {
+		LIST_NODE *tmpElem = LIST_FN(newNode)(LIST_UNROLL_SZ);
+
+		tmpElem->next = head;
+		list->head = tmpElem;
+#ifndef LIST_DISABLE_TAIL
+		if(!(list->size))
+			list->tail = tmpElem;
+#endif
+		head = tmpElem;
+	}
+
+	(head->first)--;
+	(head->count)++;
+	LIST_ASSIGN(head->val[head->first], val);
+	(list->size)++;
+}
+
+/**
+ * @brief Retrieves the first element in this list.
+ */
+static inline LIST_TYPE LIST_FN(front)(list_t *list) {
+	LIST_NODE *head = list->head;
+
+	return head->val[head->first];
+}
+
+/**
+ * @brief Retrieves the last element in this list.
+ */
+static inline LIST_TYPE LIST_FN(back)(list_t *list) {
+	LIST_NODE *tmpPointer = LIST_FN(lastNode)(list);
+
+	return tmpPointer->val[tmpPointer->first + tmpPointer->count - 1];
+}
+
+/**
+ * @brief Retrieves an element from this list.
+ */
+static inline LIST_TYPE LIST_FN(get)(list_t *list, unsigned int pos) {
+	LIST_NODE *tmpPointer = LIST_FN(seek)(list, &pos);
+
+	return tmpPointer->val[tmpPointer->first + pos];
+}
+
+/**
+ * @brief Inserts an element in this list.
+ */
+static inline void LIST_FN(insert)(list_t *list, unsigned int pos, LIST_TYPE val) {
+	/* Both ends are handled by the push functions */
+	if(pos >= list->size) {
+		LIST_FN(pushBack)(list, val);
+	}
+	else if(!pos) {
+		LIST_FN(pushFront)(list, val);
+	}
+	else {
+		LIST_NODE *tmpPointer = LIST_FN(seek)(list, &pos);
+
+		/* Node is full: move its upper half to a new node right after it */
+		if(LIST_UNROLL_SZ == tmpPointer->count) {
+			unsigned int half = LIST_UNROLL_SZ / 2;
+			LIST_NODE *tmpElem = LIST_FN(newNode)(0);
+
+			memcpy(tmpElem->val, &(tmpPointer->val[half]), (LIST_UNROLL_SZ - half) * sizeof(LIST_TYPE));
+			tmpElem->count = LIST_UNROLL_SZ - half;
+			tmpElem->next = tmpPointer->next;
+			tmpPointer->count = half;
+			tmpPointer->next = tmpElem;
+#ifndef LIST_DISABLE_TAIL
+			if(list->tail == tmpPointer)
+				list->tail = tmpElem;
+#endif
+
+			if(pos > half) {
+				tmpPointer = tmpElem;
+				pos -= half;
+			}
+		}
+
+		/* Open a slot at pos, shifting towards whichever side has free room */
+		if(tmpPointer->first + tmpPointer->count < LIST_UNROLL_SZ) {
+			memmove(&(tmpPointer->val[tmpPointer->first + pos + 1]), &(tmpPointer->val[tmpPointer->first + pos]), (tmpPointer->count - pos) * sizeof(LIST_TYPE));
+		}
+		else {
+			memmove(&(tmpPointer->val[tmpPointer->first - 1]), &(tmpPointer->val[tmpPointer->first]), pos * sizeof(LIST_TYPE));
+			(tmpPointer->first)--;
+		}
+
+		LIST_ASSIGN(tmpPointer->val[tmpPointer->first + pos], val);
+		(tmpPointer->count)++;
+		(list->size)++;
+	}
+}
+
+/**
+ * @brief Swap a position in this list with a new element.
+ */
+static inline void LIST_FN(swap)(list_t *list, unsigned int pos, LIST_TYPE val) {
+	if(list->head) {
+		LIST_NODE *tmpPointer = LIST_FN(seek)(list, &pos);
+
+		/* Just dealloc and reassign solves this problem */
+		LIST_DEALLOC(tmpPointer->val[tmpPointer->first + pos]);
+		LIST_ASSIGN(tmpPointer->val[tmpPointer->first + pos], val);
+	}
+}
+#else
+/* Structure of a list element: the value itself and pointer to next node */
+typedef struct LIST_NODE {
+	LIST_TYPE val;
+	struct LIST_NODE *next;
+} LIST_NODE;
+
+/**
+ * @brief Destroy a list; free up memory.
+ */
+static inline void LIST_FN(destroy)(list_t **list) {
+	LIST_NODE *tmpPointer = (*list)->head;
+	LIST_NODE *tmpPointerNext;
+
+	/* Iterate through the list and delete everything */
+	while(tmpPointer) {
+		tmpPointerNext = tmpPointer->next;
+		LIST_DEALLOC(tmpPointer->val);
+		free(tmpPointer);
+		tmpPointer = tmpPointerNext;
+	}
+
+	free(*list);
+	*list = NULL;
+}
+
+/**
+ * @brief Trim a list, leaving it with n elements.
+ */
+static inline void LIST_FN(trim)(list_t **list, unsigned int n) {
+	/* Trim if the list has elements */
+	if(n) {
+		LIST_NODE *tmpPointer = (*list)->head;
+		LIST_NODE *tmpPointerNext;
+
+		/* Iterate through the list */
+		int i;
+		for(i = 0; tmpPointer; i++) {
+			tmpPointerNext = tmpPointer->next;
+			/* After passing through n elements, start deleting stuff */
+			if(i >= n) {
+				LIST_DEALLOC(tmpPointer->val);
+				free(tmpPointer);
+			}
+			else if((n - 1) == i) {
+				tmpPointer->next = NULL;
+#ifndef LIST_DISABLE_TAIL
+				(*list)->tail = tmpPointer;
+#endif
+			}
+
+			tmpPointer = tmpPointerNext;
+		}
+
+		(*list)->size = n;
+	}
+	else
+		LIST_FN(destroy)(list);
+}
+
+/**
+ * @brief Insert an element at the end of the list.
+ */
+static inline void LIST_FN(pushBack)(list_t *list, LIST_TYPE val) {
+	LIST_NODE *tmpElem = malloc(sizeof(LIST_NODE));
+	tmpElem->next = NULL;
+	LIST_ASSIGN(tmpElem->val, val);
+
+	/* List has elements */
+	if(list->head) {
+#ifndef LIST_DISABLE_TAIL
+		/* With tail pointer, there's no need to iterate through the whole list to pushBack */
+		((LIST_NODE *) list->tail)->next = tmpElem;
+#else
+		LIST_NODE *tmpPointer = list->head;
+
+		/* Iterate 'till the end of the list */
+		while(tmpPointer->next)
+			tmpPointer = tmpPointer->next;
+
+		tmpPointer->next = tmpElem;
+#endif
+	}
+	/* List has no elements */
+	else {
+		list->head = tmpElem;
+	}
+
+#ifndef LIST_DISABLE_TAIL
+	list->tail = tmpElem;
+#endif
+	(list->size)++;
+}
+
+/**
+ * @brief Discard the first element of the list.
+ */
+static inline void LIST_FN(popFront)(list_t *list) {
+	LIST_NODE *head = list->head;
+
+	if(head) {
+		list->head = head->next;
+		LIST_DEALLOC(head->val);
+		free(head);
+		(list->size)--;
+
+#ifndef LIST_DISABLE_TAIL
+		if(!(list->size))
+			list->tail = NULL;
+#endif
+	}
+}
+
+/**
+ * @brief Insert an element at the beginning of the list.
+ */
+static inline void LIST_FN(pushFront)(list_t *list, LIST_TYPE val) {
+	LIST_NODE *tmpElem = malloc(sizeof(LIST_NODE));
+	tmpElem->next = list->head;
+	LIST_ASSIGN(tmpElem->val, val);
+	list->head = tmpElem;
+
+	(list->size)++;
+
+#ifndef LIST_DISABLE_TAIL
+	if(1 == list->size)
+		list->tail = list->head;
+#endif
+}
+
+/**
+ * @brief Retrieves the first element in this list.
+ */
+static inline LIST_TYPE LIST_FN(front)(list_t *list) {
+	return ((LIST_NODE *) list->head)->val;
+}
+
+/**
+ * @brief Retrieves the last element in this list.
+ */
+static inline LIST_TYPE LIST_FN(back)(list_t *list) {
+#ifndef LIST_DISABLE_TAIL
+	/* No need to iterate the whole list if we have a tail pointer */
+	return ((LIST_NODE *) list->tail)->val;
+#else
+	LIST_NODE *tmpPointer = list->head;
+
+	/* Iterate through the whole list */
+	while(tmpPointer->next)
+		tmpPointer = tmpPointer->next;
+
+	return tmpPointer->val;
+#endif
+}
+
+/**
+ * @brief Retrieves an element from this list.
+ */
+static inline LIST_TYPE LIST_FN(get)(list_t *list, unsigned int pos) {
+	LIST_NODE *tmpPointer = list->head;
+
+	int i;
+	for(i = 0; i < pos; i++)
+		tmpPointer = tmpPointer->next;
+
+	return tmpPointer->val;
+}
+
+/**
+ * @brief Inserts an element in this list.
+ */
+static inline void LIST_FN(insert)(list_t *list, unsigned int pos, LIST_TYPE val) {
+	/* Malloc a new element and assign it */
+	LIST_NODE *tmpElem = malloc(sizeof(LIST_NODE));
+	LIST_ASSIGN(tmpElem->val, val);
+
+	/* List has elements */
+	if(list->head) {
+		LIST_NODE *tmpCurr = NULL;
+		LIST_NODE *tmpNext = list->head;
+
+		/* Iterate 'till the pos-th position */
+		int i;
+		for(i = 0; i < pos; i++) {
+			tmpCurr = tmpNext;
+			tmpNext = tmpNext->next;
+		}
+
+		/* Refresh pointers */
+		tmpElem->next = tmpNext;
+		if(tmpCurr)
+			tmpCurr->next = tmpElem;
+		else
+			list->head = tmpElem;
+
+#ifndef LIST_DISABLE_TAIL
+		if(pos == list->size)
+			list->tail = tmpElem;
+#endif
+	}
+	/* List has no elements */
+	else {
+		tmpElem->next = NULL;
+		list->head = tmpElem;
+#ifndef LIST_DISABLE_TAIL
+		list->tail = tmpElem;
+#endif
+	}
+
+	(list->size)++;
+}
+
+/**
+ * @brief Swap a position in this list with a new element.
+ */
+static inline void LIST_FN(swap)(list_t *list, unsigned int pos, LIST_TYPE val) {
+	if(list->head) {
+		LIST_NODE *tmpNext = list->head;
+
+		int i;
+		for(i = 0; i < pos; i++)
+			tmpNext = tmpNext->next;
+
+		/* Just dealloc and reassign solves this problem */
+		LIST_DEALLOC(tmpNext->val);
+		LIST_ASSIGN(tmpNext->val, val);
+	}
+}
+#endif
+
+#undef LIST_FN
+#undef LIST_NODE
+#undef LIST_NAME
+#undef LIST_TYPE
+#undef LIST_ASSIGN
+#undef LIST_DEALLOC
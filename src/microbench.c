@@ -0,0 +1,532 @@
+/* ********************************************************************************************* */
+/* * Microbenchmarks of liblist, libstaq and libgraph primitives: bitanes2-microbench          * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * bitanes2 is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * bitanes2 is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with bitanes2.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/common.h"
+#include "graph.h"
+#include "list.h"
+#include "netio.h"
+#include "perfcnt.h"
+#include "staq.h"
+#include "stats.h"
+
+#define USAGE_STR "Usage: %s [OPTION]... [GRAPHFILE]\n"\
+	"Measure the cost of each list, stack/queue and graph operation, in isolation and in BFS-like mixes.\n"\
+	"Graph operations use GRAPHFILE, or a random graph if none is given.\n"\
+	"Options:\n"\
+	"    -n, --nodes N        number of nodes of the random graph (default 2000)\n"\
+	"    -k, --degree K       average degree of the random graph (default 16)\n"\
+	"    -o, --ops N          number of operations of each list and stack/queue benchmark (default 20000)\n"\
+	"    -b, --bfs N          number of BFS sources of each mixed benchmark (default 16)\n"\
+	"    -r, --reps N         repetitions of each benchmark; the fastest one is reported (default 5)\n"
+
+/* Number of allocation calls (malloc, calloc and realloc) made so far */
+/* The binary is linked with -Wl,--wrap, so that every allocation of the libraries goes through the wrappers below */
+static unsigned long noOfAllocs = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+	noOfAllocs++;
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+	noOfAllocs++;
+	return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+	noOfAllocs++;
+	return __real_realloc(ptr, size);
+}
+
+/* Benchmark context */
+typedef struct {
+	/* Settings */
+	unsigned int noOfOps;
+	unsigned int noOfSources;
+	/* Input graph, as an edge list and as a graph built by graph_createFromEdges */
+	unsigned int n;
+	unsigned int m;
+	unsigned int *edges;
+	graph_t *graph;
+	/* Hardware counters (NULL if not available) */
+	perfcnt_t *perfcnt;
+	/* Measurement of the current repetition, taken between begin() and end() */
+	double start;
+	unsigned long long startCycles;
+	unsigned long startAllocs;
+	unsigned long ops;
+	double time;
+	unsigned long long cycles;
+	unsigned long allocs;
+	/* Sink for values read by benchmarks, so that the compiler does not discard them */
+	unsigned long sink;
+} mb_t;
+
+/**
+ * @brief Start measuring the hot loop of a benchmark.
+ */
+static inline void begin(mb_t *mb) {
+	if(mb->perfcnt)
+		perfcnt_read(mb->perfcnt, PERFCNT_PHASE_FORWARD, PERFCNT_EVENT_CYCLES, &(mb->startCycles));
+	mb->startAllocs = noOfAllocs;
+	perfcnt_start(mb->perfcnt, PERFCNT_PHASE_FORWARD);
+	mb->start = stats_now();
+}
+
+/**
+ * @brief Stop measuring the hot loop of a benchmark, which executed ops operations.
+ */
+static inline void end(mb_t *mb, unsigned long ops) {
+	mb->time = stats_now() - mb->start;
+	perfcnt_stop(mb->perfcnt, PERFCNT_PHASE_FORWARD);
+	mb->allocs = noOfAllocs - mb->startAllocs;
+	mb->ops = ops;
+	mb->cycles = 0;
+	if(mb->perfcnt && !perfcnt_read(mb->perfcnt, PERFCNT_PHASE_FORWARD, PERFCNT_EVENT_CYCLES, &(mb->cycles)))
+		mb->cycles -= mb->startCycles;
+}
+
+/**
+ * @brief dlist_pushBack on an initially empty list.
+ */
+static void benchDlistPushBack(mb_t *mb) {
+	unsigned int i;
+	list_t *list = dlist_create();
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++)
+		dlist_pushBack(list, i);
+	end(mb, mb->noOfOps);
+
+	dlist_destroy(&list);
+}
+
+/**
+ * @brief dlist_pushFront on an initially empty list.
+ */
+static void benchDlistPushFront(mb_t *mb) {
+	unsigned int i;
+	list_t *list = dlist_create();
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++)
+		dlist_pushFront(list, i);
+	end(mb, mb->noOfOps);
+
+	dlist_destroy(&list);
+}
+
+/**
+ * @brief dlist_front + dlist_popFront until a full list is empty.
+ */
+static void benchDlistPopFront(mb_t *mb) {
+	unsigned int i;
+	list_t *list = dlist_create();
+
+	for(i = 0; i < mb->noOfOps; i++)
+		dlist_pushBack(list, i);
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++) {
+		mb->sink += dlist_front(list);
+		dlist_popFront(list);
+	}
+	end(mb, mb->noOfOps);
+
+	dlist_destroy(&list);
+}
+
+/**
+ * @brief dstaq_pushBack on an initially empty stack/queue.
+ */
+static void benchDstaqPushBack(mb_t *mb) {
+	unsigned int i;
+	staq_t *staq = dstaq_create(mb->noOfOps);
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++)
+		dstaq_pushBack(staq, i);
+	end(mb, mb->noOfOps);
+
+	dstaq_destroy(&staq);
+}
+
+/**
+ * @brief dstaq_pushFront on an initially empty stack/queue.
+ */
+static void benchDstaqPushFront(mb_t *mb) {
+	unsigned int i;
+	staq_t *staq = dstaq_create(mb->noOfOps);
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++)
+		dstaq_pushFront(staq, i);
+	end(mb, mb->noOfOps);
+
+	dstaq_destroy(&staq);
+}
+
+/**
+ * @brief dstaq_front + dstaq_popFront until a full stack/queue is empty.
+ */
+static void benchDstaqPopFront(mb_t *mb) {
+	unsigned int i;
+	staq_t *staq = dstaq_create(mb->noOfOps);
+
+	for(i = 0; i < mb->noOfOps; i++)
+		dstaq_pushBack(staq, i);
+
+	begin(mb);
+	for(i = 0; i < mb->noOfOps; i++) {
+		mb->sink += dstaq_front(staq);
+		dstaq_popFront(staq);
+	}
+	end(mb, mb->noOfOps);
+
+	dstaq_destroy(&staq);
+}
+
+/**
+ * @brief graph_putEdge of every edge in both directions (same as the original loader).
+ */
+static void benchGraphPutEdge(mb_t *mb) {
+	unsigned int i;
+	graph_t *graph = NULL;
+
+	graph_create(&graph, mb->n, mb->m);
+
+	begin(mb);
+	for(i = 0; i < mb->m; i++) {
+		graph_putEdge(graph, mb->edges[2 * i], mb->edges[2 * i + 1]);
+		graph_putEdge(graph, mb->edges[2 * i + 1], mb->edges[2 * i]);
+	}
+	end(mb, 2 * (unsigned long) mb->m);
+
+	graph_destroy(&graph);
+}
+
+/**
+ * @brief graph_getEdge of every edge, in file order.
+ */
+static void benchGraphGetEdge(mb_t *mb) {
+	unsigned int i;
+
+	begin(mb);
+	for(i = 0; i < mb->m; i++)
+		mb->sink += graph_getEdge(mb->graph, mb->edges[2 * i], mb->edges[2 * i + 1]);
+	end(mb, mb->m);
+}
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+/**
+ * @brief graph_getAdjacents of every node, reading all neighbours.
+ */
+static void benchGraphGetAdjacents(mb_t *mb) {
+	unsigned int v, i, noOfAdjacents;
+	int *adjacents;
+
+	begin(mb);
+	for(v = 0; v < mb->n; v++) {
+		adjacents = graph_getAdjacents(mb->graph, v, &noOfAdjacents);
+		for(i = 0; i < noOfAdjacents; i++)
+			mb->sink += adjacents[i];
+	}
+	end(mb, mb->n);
+}
+#endif
+
+/**
+ * @brief BFS-like mix with liblist: same queue/stack pattern and neighbour scan as the forward phase of brandes_compute.
+ * @note One operation is one traversed edge.
+ */
+static void benchBFSList(mb_t *mb) {
+	unsigned int s, v, w;
+	unsigned long ops = 0;
+	int *d = malloc(mb->n * sizeof(int));
+	list_t *Q = dlist_create();
+	list_t *S = dlist_create();
+#ifdef GRAPH_USE_GET_ADJACENTS
+	unsigned int i, noOfAdjacents;
+	int *adjacents;
+#endif
+
+	begin(mb);
+	for(s = 0; s < mb->noOfSources; s++) {
+		for(v = 0; v < mb->n; v++)
+			d[v] = -1;
+		d[s % mb->n] = 0;
+		dlist_pushBack(Q, s % mb->n);
+
+		while(!dlist_isEmpty(Q)) {
+			v = dlist_front(Q);
+			dlist_popFront(Q);
+			dlist_pushFront(S, v);
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+			adjacents = graph_getAdjacents(mb->graph, v, &noOfAdjacents);
+			for(i = 0; i < noOfAdjacents; i++) {
+				w = adjacents[i];
+#else
+			for(w = 0; w < mb->n; w++) {
+				if(!graph_getEdge(mb->graph, v, w))
+					continue;
+#endif
+				ops++;
+				if(d[w] < 0) {
+					dlist_pushBack(Q, w);
+					d[w] = d[v] + 1;
+				}
+			}
+		}
+
+		while(!dlist_isEmpty(S))
+			dlist_popFront(S);
+	}
+	end(mb, ops);
+
+	dlist_destroy(&S);
+	dlist_destroy(&Q);
+	free(d);
+}
+
+/**
+ * @brief BFS-like mix with libstaq (preallocated with n elements), otherwise same as benchBFSList.
+ */
+static void benchBFSStaq(mb_t *mb) {
+	unsigned int s, v, w;
+	unsigned long ops = 0;
+	int *d = malloc(mb->n * sizeof(int));
+	staq_t *Q = dstaq_create(mb->n);
+	staq_t *S = dstaq_create(mb->n);
+#ifdef GRAPH_USE_GET_ADJACENTS
+	unsigned int i, noOfAdjacents;
+	int *adjacents;
+#endif
+
+	begin(mb);
+	for(s = 0; s < mb->noOfSources; s++) {
+		for(v = 0; v < mb->n; v++)
+			d[v] = -1;
+		d[s % mb->n] = 0;
+		dstaq_pushBack(Q, s % mb->n);
+
+		while(!dstaq_isEmpty(Q)) {
+			v = dstaq_front(Q);
+			dstaq_popFront(Q);
+			dstaq_pushFront(S, v);
+
+#ifdef GRAPH_USE_GET_ADJACENTS
+			adjacents = graph_getAdjacents(mb->graph, v, &noOfAdjacents);
+			for(i = 0; i < noOfAdjacents; i++) {
+				w = adjacents[i];
+#else
+			for(w = 0; w < mb->n; w++) {
+				if(!graph_getEdge(mb->graph, v, w))
+					continue;
+#endif
+				ops++;
+				if(d[w] < 0) {
+					dstaq_pushBack(Q, w);
+					d[w] = d[v] + 1;
+				}
+			}
+		}
+
+		while(!dstaq_isEmpty(S))
+			dstaq_popFront(S);
+	}
+	end(mb, ops);
+
+	dstaq_destroy(&S);
+	dstaq_destroy(&Q);
+	free(d);
+}
+
+/**
+ * @brief Run a benchmark several times and print its fastest repetition.
+ */
+static void run(mb_t *mb, const char *name, void (*bench)(mb_t *), unsigned int noOfReps) {
+	unsigned int i;
+	double bestTime = 0;
+	unsigned long long bestCycles = 0;
+
+	for(i = 0; i < noOfReps; i++) {
+		bench(mb);
+		if(!i || (mb->time < bestTime))
+			bestTime = mb->time;
+		if(!i || (mb->cycles < bestCycles))
+			bestCycles = mb->cycles;
+	}
+
+	if(!(mb->ops)) {
+		printf("%-24s %12s\n", name, "no ops");
+		return;
+	}
+
+	printf("%-24s %12lu %12.2f", name, mb->ops, 1e9 * bestTime / mb->ops);
+	if(mb->perfcnt)
+		printf(" %12.2f", bestCycles / (double) mb->ops);
+	else
+		printf(" %12s", "-");
+	printf(" %12.4f\n", mb->allocs / (double) mb->ops);
+}
+
+/**
+ * @brief Generate a random graph with n nodes and about n * k / 2 edges (no self-loops; repeated edges are possible).
+ */
+static unsigned int *randomEdges(unsigned int n, unsigned int k, unsigned int *m) {
+	unsigned int i;
+	unsigned int *edges;
+	uint64_t state = 0x853C49E6748FEA9Bull;
+
+	*m = ((unsigned long) n) * k / 2;
+	edges = malloc(2 * ((size_t) *m + 1) * sizeof(unsigned int));
+
+	for(i = 0; i < *m; i++) {
+		/* xorshift64 */
+		do {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			edges[2 * i] = (state >> 32) % n;
+			edges[2 * i + 1] = (state & 0xFFFFFFFFu) % n;
+		} while(edges[2 * i] == edges[2 * i + 1]);
+	}
+
+	return edges;
+}
+
+int main(int argc, char *argv[]) {
+	/* Auxiliary variables */
+	int opt;
+	char *inputFilename = NULL;
+	FILE *inputFile = NULL;
+	unsigned int n = 2000;
+	unsigned int k = 16;
+	unsigned int noOfReps = 5;
+	struct option longOpts[] = {
+		{"nodes", required_argument, NULL, 'n'},
+		{"degree", required_argument, NULL, 'k'},
+		{"ops", required_argument, NULL, 'o'},
+		{"bfs", required_argument, NULL, 'b'},
+		{"reps", required_argument, NULL, 'r'},
+		{NULL, 0, NULL, 0}
+	};
+	perfcnt_t perfcnt;
+	mb_t mb;
+
+	memset(&mb, 0, sizeof(mb_t));
+	mb.noOfOps = 20000;
+	mb.noOfSources = 16;
+
+	/* Check if command line arguments were passed correctly */
+	while((opt = getopt_long(argc, argv, "n:k:o:b:r:", longOpts, NULL)) != -1) {
+		switch(opt) {
+			case 'n':
+				n = strtoul(optarg, NULL, 10);
+				break;
+			case 'k':
+				k = strtoul(optarg, NULL, 10);
+				break;
+			case 'o':
+				mb.noOfOps = strtoul(optarg, NULL, 10);
+				break;
+			case 'b':
+				mb.noOfSources = strtoul(optarg, NULL, 10);
+				break;
+			case 'r':
+				noOfReps = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				ASSERT_CALL(false, fprintf(stderr, USAGE_STR, argv[0]));
+		}
+	}
+	ASSERT_CALL(optind >= (argc - 1), fprintf(stderr, USAGE_STR, argv[0]));
+	ASSERT_CALL((noOfReps > 0) && (mb.noOfOps > 0), fprintf(stderr, USAGE_STR, argv[0]));
+
+	/* Load or generate the graph */
+	if(optind < argc) {
+		inputFilename = argv[optind];
+		inputFile = fopen(inputFilename, "rb");
+		ASSERT_CALL(inputFile, fprintf(stderr, "Error: %s: %s\n", strerror(errno), inputFilename));
+		ASSERT_CALL(!netio_read(inputFile, &(mb.n), &(mb.m), &(mb.edges)), fprintf(stderr, "Error: %s: malformed graph file\n", inputFilename));
+	}
+	else {
+		ASSERT_CALL(n > 1, fprintf(stderr, "Error: the random graph needs at least 2 nodes\n"));
+		mb.n = n;
+		mb.edges = randomEdges(n, k, &(mb.m));
+	}
+	ASSERT_CALL(!graph_createFromEdges(&(mb.graph), mb.n, mb.m, mb.edges, 1, NULL, NULL), fprintf(stderr, "Error: not enough memory for the graph\n"));
+
+	if(perfcnt_open(&perfcnt))
+		mb.perfcnt = &perfcnt;
+	else
+		fprintf(stderr, "Warning: hardware counters not available, cycles/op will not be reported\n");
+
+	printf("Graph: %u nodes, %u edges (%s)\n", mb.n, mb.m, inputFilename? inputFilename : "random");
+	printf("%-24s %12s %12s %12s %12s\n", "benchmark", "ops", "ns/op", "cycles/op", "allocs/op");
+
+	/* Each library in isolation */
+	run(&mb, "dlist_pushBack", benchDlistPushBack, noOfReps);
+	run(&mb, "dlist_pushFront", benchDlistPushFront, noOfReps);
+	run(&mb, "dlist_popFront", benchDlistPopFront, noOfReps);
+	run(&mb, "dstaq_pushBack", benchDstaqPushBack, noOfReps);
+	run(&mb, "dstaq_pushFront", benchDstaqPushFront, noOfReps);
+	run(&mb, "dstaq_popFront", benchDstaqPopFront, noOfReps);
+	run(&mb, "graph_putEdge", benchGraphPutEdge, noOfReps);
+	run(&mb, "graph_getEdge", benchGraphGetEdge, noOfReps);
+#ifdef GRAPH_USE_GET_ADJACENTS
+	run(&mb, "graph_getAdjacents", benchGraphGetAdjacents, noOfReps);
+#endif
+
+	/* BFS-like mixes (ops are traversed edges) */
+	run(&mb, "bfs_list", benchBFSList, noOfReps);
+	run(&mb, "bfs_staq", benchBFSStaq, noOfReps);
+
+	/* Keep the sink alive */
+	if(1 == mb.sink)
+		fprintf(stderr, "\n");
+
+_err:
+
+	if(mb.perfcnt)
+		perfcnt_close(mb.perfcnt);
+
+	if(mb.graph)
+		graph_destroy(&(mb.graph));
+
+	if(mb.edges)
+		free(mb.edges);
+
+	if(inputFile)
+		fclose(inputFile);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/* ********************************************************************************************* */
+/* * Simple library for reading and writing graph files: libnetio                              * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libnetio is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libnetio is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libnetio.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "netio.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Size of the input/output buffer for text files */
+#define BUFFER_SZ 65536
+/* Initial number of node ids allocated when reading edges */
+#define NETIO_CHUNK (1 << 20)
+
+/* Buffered reader for text files */
+typedef struct {
+	FILE *file;
+	char buffer[BUFFER_SZ];
+	size_t pos;
+	size_t size;
+} _netio_reader_t;
+
+/**
+ * @brief Read the next unsigned integer from a text file, skipping whitespace.
+ * @note This is an internal function.
+ * @return 0 on success, 1 on end of file before any digit, -1 on unexpected char.
+ */
+static int _netio_readUInt(_netio_reader_t *reader, unsigned int *val) {
+	int digits = 0;
+	unsigned long acc = 0;
+	char c;
+
+	while(1) {
+		/* Refill buffer */
+		if(reader->pos == reader->size) {
+			reader->size = fread(reader->buffer, 1, BUFFER_SZ, reader->file);
+			reader->pos = 0;
+			if(!(reader->size))
+				break;
+		}
+
+		c = reader->buffer[reader->pos];
+		if((c >= '0') && (c <= '9')) {
+			acc = (acc * 10) + (c - '0');
+			if(acc > UINT32_MAX)
+				return -1;
+			digits++;
+		}
+		else if((' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c)) {
+			if(digits)
+				break;
+		}
+		else {
+			return -1;
+		}
+
+		(reader->pos)++;
+	}
+
+	*val = acc;
+	return digits? 0 : 1;
+}
+
+/**
+ * @brief Grow an edge array so that it holds at least the given number of node ids, up to a total.
+ * @note This is an internal function.
+ * @note The header edge count is not trusted for allocation: the array grows as the ids are actually read, so a
+ *       corrupt header fails with a short read instead of a huge allocation.
+ * @return 0 on success, -1 if allocation failed (the array is freed in this case).
+ */
+static int _netio_grow(unsigned int **edges, size_t *capacity, size_t needed, size_t total) {
+	unsigned int *tmpEdges;
+	size_t newCapacity = *capacity? *capacity : NETIO_CHUNK;
+
+	while(newCapacity < needed)
+		newCapacity *= 2;
+	if(newCapacity > total)
+		newCapacity = total;
+
+	tmpEdges = realloc(*edges, newCapacity * sizeof(unsigned int));
+	if(!tmpEdges) {
+		free(*edges);
+		*edges = NULL;
+		return -1;
+	}
+
+	*edges = tmpEdges;
+	*capacity = newCapacity;
+	return 0;
+}
+
+/**
+ * @brief Read a graph file (text or binary, detected by the magic number).
+ */
+int netio_read(FILE *file, unsigned int *n, unsigned int *m, unsigned int **edges) {
+	size_t i;
+	size_t total;
+	size_t read;
+	size_t capacity = 0;
+	unsigned int *tmpEdges = NULL;
+	netio_header_t header;
+	size_t headerSz = fread(&header, 1, sizeof(netio_header_t), file);
+
+	if((sizeof(netio_header_t) == headerSz) && !memcmp(header.magic, NETIO_MAGIC, 4)) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		header.version = __builtin_bswap32(header.version);
+		header.n = __builtin_bswap32(header.n);
+		header.m = __builtin_bswap32(header.m);
+#endif
+		if(header.version != NETIO_VERSION)
+			return -1;
+
+		/* Read the edges chunk by chunk, so that the allocation follows what the file actually holds */
+		total = 2 * (size_t) header.m;
+		for(i = 0; i < total; i += read) {
+			if(_netio_grow(&tmpEdges, &capacity, i + 1, total))
+				return -1;
+			read = fread(&tmpEdges[i], sizeof(unsigned int), capacity - i, file);
+			if(read != (capacity - i)) {
+				free(tmpEdges);
+				return -1;
+			}
+		}
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		for(i = 0; i < total; i++)
+			tmpEdges[i] = __builtin_bswap32(tmpEdges[i]);
+#endif
+
+		*n = header.n;
+		*m = header.m;
+	}
+	else {
+		_netio_reader_t *reader = malloc(sizeof(_netio_reader_t));
+
+		if(!reader)
+			return -1;
+
+		/* Whatever was read looking for the magic number is the start of the text */
+		reader->file = file;
+		memcpy(reader->buffer, &header, headerSz);
+		reader->pos = 0;
+		reader->size = headerSz;
+
+		if(_netio_readUInt(reader, n) || _netio_readUInt(reader, m)) {
+			free(reader);
+			return -1;
+		}
+
+		total = 2 * (size_t) *m;
+		for(i = 0; i < total; i++) {
+			if((i == capacity) && _netio_grow(&tmpEdges, &capacity, i + 1, total)) {
+				free(reader);
+				return -1;
+			}
+			if(_netio_readUInt(reader, &tmpEdges[i])) {
+				free(tmpEdges);
+				free(reader);
+				return -1;
+			}
+		}
+
+		free(reader);
+	}
+
+	/* Check that all edges connect existing nodes */
+	for(i = 0; i < total; i++) {
+		if(tmpEdges[i] >= *n) {
+			free(tmpEdges);
+			return -1;
+		}
+	}
+
+	*edges = tmpEdges;
+	return 0;
+}
+
+/**
+ * @brief Read a list of node ids from a text file.
+ */
+int netio_readIds(FILE *file, unsigned int n, unsigned int **ids, unsigned int *count) {
+	int rv;
+	unsigned int capacity = 1024;
+	unsigned int val;
+	unsigned int *tmpIds = malloc(capacity * sizeof(unsigned int));
+	_netio_reader_t *reader = malloc(sizeof(_netio_reader_t));
+
+	reader->file = file;
+	reader->pos = 0;
+	reader->size = 0;
+	*count = 0;
+
+	while(!(rv = _netio_readUInt(reader, &val))) {
+		if(val >= n)
+			break;
+
+		if(*count == capacity) {
+			capacity *= 2;
+			tmpIds = realloc(tmpIds, capacity * sizeof(unsigned int));
+		}
+		tmpIds[(*count)++] = val;
+	}
+
+	free(reader);
+
+	/* Anything but a clean end of file is an error */
+	if(rv != 1) {
+		free(tmpIds);
+		return -1;
+	}
+
+	*ids = tmpIds;
+	return 0;
+}
+
+/**
+ * @brief Write the digits of an unsigned integer followed by a separator.
+ * @note This is an internal function.
+ */
+static inline size_t _netio_putUInt(char *str, unsigned int val, char separator) {
+	char tmp[12];
+	size_t i = 0;
+	size_t j;
+
+	do {
+		tmp[i++] = '0' + (val % 10);
+		val /= 10;
+	} while(val);
+
+	for(j = 0; j < i; j++)
+		str[j] = tmp[i - j - 1];
+	str[i] = separator;
+
+	return i + 1;
+}
+
+/**
+ * @brief Write a graph file.
+ */
+int netio_write(FILE *file, unsigned int n, unsigned int m, unsigned int *edges, int format) {
+	size_t i;
+
+	if(NETIO_FORMAT_BIN == format) {
+		netio_header_t header;
+
+		memcpy(header.magic, NETIO_MAGIC, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		header.version = __builtin_bswap32(NETIO_VERSION);
+		header.n = __builtin_bswap32(n);
+		header.m = __builtin_bswap32(m);
+		if(fwrite(&header, sizeof(netio_header_t), 1, file) != 1)
+			return -1;
+		for(i = 0; i < 2 * m; i++) {
+			uint32_t tmp = __builtin_bswap32(edges[i]);
+			if(fwrite(&tmp, sizeof(uint32_t), 1, file) != 1)
+				return -1;
+		}
+#else
+		header.version = NETIO_VERSION;
+		header.n = n;
+		header.m = m;
+		if(fwrite(&header, sizeof(netio_header_t), 1, file) != 1)
+			return -1;
+		if(fwrite(edges, sizeof(unsigned int), 2 * (size_t) m, file) != (2 * (size_t) m))
+			return -1;
+#endif
+	}
+	else {
+		char *buffer = malloc(BUFFER_SZ);
+		size_t used = 0;
+
+		if(!buffer)
+			return -1;
+
+		used += _netio_putUInt(&buffer[used], n, '\n');
+		used += _netio_putUInt(&buffer[used], m, '\n');
+		for(i = 0; i < m; i++) {
+			used += _netio_putUInt(&buffer[used], edges[2 * i], ' ');
+			used += _netio_putUInt(&buffer[used], edges[2 * i + 1], '\n');
+
+			/* Flush when a line might not fit anymore */
+			if(used > (BUFFER_SZ - 32)) {
+				if(fwrite(buffer, 1, used, file) != used) {
+					free(buffer);
+					return -1;
+				}
+				used = 0;
+			}
+		}
+
+		if(used && (fwrite(buffer, 1, used, file) != used)) {
+			free(buffer);
+			return -1;
+		}
+
+		free(buffer);
+	}
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+/* ********************************************************************************************* */
+/* * Simple library for hardware performance counters: libperfcnt                              * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libperfcnt is free software: you can redistribute it and/or modify it under the terms of  * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libperfcnt is distributed in the hope that it will be useful, but WITHOUT ANY             * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libperfcnt.  * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "perfcnt.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/* Names of each event and phase, as printed */
+static const char *_perfcnt_eventNames[PERFCNT_NO_OF_EVENTS] = {
+	"cycles", "instructions", "LLC misses", "branch misses"
+};
+static const char *_perfcnt_phaseNames[PERFCNT_NO_OF_PHASES] = {
+	"forward", "backward"
+};
+
+#ifdef __linux__
+/* Type and config of each event */
+static const struct {
+	uint32_t type;
+	uint64_t config;
+} _perfcnt_events[PERFCNT_NO_OF_EVENTS] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+/**
+ * @brief Open one event for the calling thread (user space only), attached to a group leader (or leading a new group if -1).
+ * @note This is an internal function.
+ */
+static int _perfcnt_openEvent(int event, int leader) {
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(struct perf_event_attr));
+	attr.size = sizeof(struct perf_event_attr);
+	attr.type = _perfcnt_events[event].type;
+	attr.config = _perfcnt_events[event].config;
+	/* Only the leader starts disabled: members follow it */
+	attr.disabled = (-1 == leader);
+	/* Kernel and hypervisor are excluded, so that the default perf_event_paranoid level allows counting */
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif
+
+/**
+ * @brief Open the hardware counters of the calling thread for all phases. All counters start disabled.
+ */
+int perfcnt_open(perfcnt_t *perfcnt) {
+	int i, j;
+
+	perfcnt->noOfAvailable = 0;
+	for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+		perfcnt->leader[i] = -1;
+		for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+			perfcnt->fd[i][j] = -1;
+			perfcnt->added[i][j] = 0;
+		}
+	}
+
+#ifdef __linux__
+	for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+		/* Events that fail to open are left out of the group, the others are still counted */
+		for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+			perfcnt->fd[i][j] = _perfcnt_openEvent(j, perfcnt->leader[i]);
+			if((-1 == perfcnt->leader[i]) && (perfcnt->fd[i][j] != -1))
+				perfcnt->leader[i] = perfcnt->fd[i][j];
+		}
+	}
+
+	/* Only events available on every phase are reported */
+	for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+		for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+			if(-1 == perfcnt->fd[i][j])
+				break;
+		}
+
+		if(PERFCNT_NO_OF_PHASES == i)
+			(perfcnt->noOfAvailable)++;
+	}
+
+	/* Nothing usable: release whatever was opened */
+	if(!(perfcnt->noOfAvailable))
+		perfcnt_close(perfcnt);
+#endif
+
+	return perfcnt->noOfAvailable;
+}
+
+/**
+ * @brief Start counting for a phase.
+ */
+void perfcnt_start(perfcnt_t *perfcnt, int phase) {
+#ifdef __linux__
+	if(perfcnt && (perfcnt->leader[phase] != -1))
+		ioctl(perfcnt->leader[phase], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+/**
+ * @brief Stop counting for a phase.
+ */
+void perfcnt_stop(perfcnt_t *perfcnt, int phase) {
+#ifdef __linux__
+	if(perfcnt && (perfcnt->leader[phase] != -1))
+		ioctl(perfcnt->leader[phase], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+/**
+ * @brief Read the accumulated count of an event in a phase.
+ */
+int perfcnt_read(perfcnt_t *perfcnt, int phase, int event, unsigned long long *count) {
+	/* Value, time enabled and time running */
+	uint64_t values[3];
+
+	if(-1 == perfcnt->fd[phase][event])
+		return -1;
+	if(read(perfcnt->fd[phase][event], values, sizeof(values)) != sizeof(values))
+		return -1;
+
+	/* Counter was multiplexed with others: extrapolate */
+	if(values[2] && (values[2] < values[1]))
+		*count = (unsigned long long) (values[0] * ((double) values[1] / values[2]));
+	else
+		*count = values[0];
+	*count += perfcnt->added[phase][event];
+
+	return 0;
+}
+
+/**
+ * @brief Add the counts of the counters of another thread to these ones.
+ */
+void perfcnt_add(perfcnt_t *perfcnt, perfcnt_t *other) {
+	int i, j;
+	unsigned long long count;
+
+	for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+		for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+			if((perfcnt->fd[i][j] != -1) && !perfcnt_read(other, i, j, &count))
+				perfcnt->added[i][j] += count;
+		}
+	}
+}
+
+/**
+ * @brief Print accumulated counters and IPC of each phase in human-readable form.
+ */
+void perfcnt_print(FILE *file, perfcnt_t *perfcnt) {
+	int i, j;
+	unsigned long long count;
+	unsigned long long cycles, instructions;
+
+	for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+		for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+			if(!perfcnt_read(perfcnt, i, j, &count))
+				fprintf(file, "Perf (%s): %s: %llu\n", _perfcnt_phaseNames[i], _perfcnt_eventNames[j], count);
+			else
+				fprintf(file, "Perf (%s): %s: n/a\n", _perfcnt_phaseNames[i], _perfcnt_eventNames[j]);
+		}
+
+		if(!perfcnt_read(perfcnt, i, PERFCNT_EVENT_CYCLES, &cycles) && !perfcnt_read(perfcnt, i, PERFCNT_EVENT_INSTRUCTIONS, &instructions) && cycles)
+			fprintf(file, "Perf (%s): IPC: %.3f\n", _perfcnt_phaseNames[i], instructions / (double) cycles);
+		else
+			fprintf(file, "Perf (%s): IPC: n/a\n", _perfcnt_phaseNames[i]);
+	}
+}
+
+/**
+ * @brief Close all counters.
+ */
+void perfcnt_close(perfcnt_t *perfcnt) {
+	int i, j;
+
+	for(i = 0; i < PERFCNT_NO_OF_PHASES; i++) {
+		for(j = 0; j < PERFCNT_NO_OF_EVENTS; j++) {
+			if(perfcnt->fd[i][j] != -1)
+				close(perfcnt->fd[i][j]);
+			perfcnt->fd[i][j] = -1;
+		}
+		perfcnt->leader[i] = -1;
+	}
+	perfcnt->noOfAvailable = 0;
+}
@@ -0,0 +1,464 @@
+/* ********************************************************************************************* */
+/* * Simple resident betweenness query server: libserver                                      * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libserver is free software: you can redistribute it and/or modify it under the terms of   * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libserver is distributed in the hope that it will be useful, but WITHOUT ANY              * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libserver.   * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "server.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "brandes.h"
+#include "graph.h"
+#include "hugemem.h"
+#include "netio.h"
+#include "stats.h"
+#include "writer.h"
+
+/* A loaded graph and its betweenness */
+typedef struct {
+	char *name;
+	unsigned int n;
+	unsigned int m;
+	graph_t *graph;
+	double *cb;
+	/* Number of sampled sources of the last computation (0 if exact) */
+	unsigned int noOfSources;
+} _server_graph_t;
+
+/* Server state */
+typedef struct {
+	_server_graph_t *graphs;
+	unsigned int noOfGraphs;
+	unsigned int capacity;
+	/* Working buffers, reused by every computation */
+	brandes_work_t work;
+	unsigned int noOfThreads;
+	int precision;
+	bool shutdown;
+} _server_t;
+
+/* Node and its betweenness, for sorting */
+typedef struct {
+	unsigned int v;
+	double val;
+} _server_score_t;
+
+/**
+ * @brief Find a loaded graph by name.
+ * @note This is an internal function.
+ * @return The graph, or NULL if there is no graph with this name.
+ */
+static _server_graph_t *_server_find(_server_t *server, char *name) {
+	unsigned int i;
+
+	for(i = 0; i < server->noOfGraphs; i++) {
+		if(!strcmp(server->graphs[i].name, name))
+			return &(server->graphs[i]);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Free a loaded graph.
+ * @note This is an internal function.
+ */
+static void _server_free(_server_graph_t *entry) {
+	free(entry->name);
+	graph_destroy(&(entry->graph));
+	hugemem_free(entry->cb);
+}
+
+/**
+ * @brief Write a betweenness value to a client.
+ * @note This is an internal function.
+ */
+static void _server_putValue(FILE *out, double val, int precision) {
+	char str[WRITER_MAX_STR_SZ];
+
+	fwrite(str, 1, writer_format(str, val, precision), out);
+}
+
+/**
+ * @brief (Re)compute the betweenness of a loaded graph, exactly or from noOfSources sampled sources.
+ * @note This is an internal function.
+ * @note Results are computed into a new array, so that the previous ones are kept if memory runs out.
+ * @return Elapsed time in seconds, or a negative value if memory could not be allocated.
+ */
+static double _server_compute(_server_t *server, _server_graph_t *entry, unsigned int noOfSources, unsigned long seed) {
+	double start = stats_now();
+	double elapsed = -1;
+	unsigned int *sources = NULL;
+	double *cb = hugemem_alloc(entry->n * sizeof(double));
+	brandes_opts_t opts;
+
+	brandes_initOpts(&opts);
+	opts.work = &(server->work);
+	opts.noOfThreads = server->noOfThreads;
+
+	if(noOfSources && (noOfSources < entry->n)) {
+		sources = malloc(entry->n * sizeof(unsigned int));
+		if(!sources)
+			goto _end;
+		brandes_permuteSources(sources, entry->n, seed);
+		opts.sources = sources;
+		opts.noOfSources = noOfSources;
+	}
+	else {
+		noOfSources = 0;
+	}
+
+	if(!cb || brandes_compute(entry->graph, cb, &opts))
+		goto _end;
+	hugemem_free(entry->cb);
+	entry->cb = cb;
+	cb = NULL;
+	entry->noOfSources = noOfSources;
+	elapsed = stats_now() - start;
+
+_end:
+
+	hugemem_free(cb);
+	free(sources);
+
+	return elapsed;
+}
+
+/**
+ * @brief Comparison function for qsort (higher betweenness first, then lower node id).
+ * @note This is an internal function.
+ */
+static int _server_compareScores(const void *a, const void *b) {
+	const _server_score_t *x = a;
+	const _server_score_t *y = b;
+
+	if(x->val != y->val)
+		return (x->val < y->val) - (x->val > y->val);
+
+	return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief LOAD NAME FILE
+ * @note This is an internal function.
+ */
+static void _server_load(_server_t *server, char *name, char *filename, FILE *out) {
+	FILE *inputFile;
+	unsigned int n, m;
+	unsigned int *edges = NULL;
+	unsigned int noOfDuplicates, noOfLoops;
+	_server_graph_t entry;
+	_server_graph_t *old;
+	double elapsed;
+	double start = stats_now();
+
+	inputFile = fopen(filename, "rb");
+	if(!inputFile) {
+		fprintf(out, "ERR %s: %s\n", strerror(errno), filename);
+		return;
+	}
+	if(netio_read(inputFile, &n, &m, &edges)) {
+		fclose(inputFile);
+		fprintf(out, "ERR %s: malformed graph file\n", filename);
+		return;
+	}
+	fclose(inputFile);
+
+	entry.name = NULL;
+	entry.n = n;
+	entry.graph = NULL;
+	entry.cb = NULL;
+	if(graph_createFromEdges(&(entry.graph), n, m, edges, server->noOfThreads, &noOfDuplicates, &noOfLoops)) {
+		free(edges);
+		fprintf(out, "ERR %s: not enough memory for the graph\n", filename);
+		return;
+	}
+	free(edges);
+	entry.m = m - noOfDuplicates - noOfLoops;
+	entry.name = strdup(name);
+	if(!(entry.name) || (_server_compute(server, &entry, 0, 0) < 0)) {
+		_server_free(&entry);
+		fprintf(out, "ERR %s: not enough memory for the graph\n", filename);
+		return;
+	}
+	elapsed = stats_now() - start;
+
+	/* Loading again under the same name replaces the graph */
+	old = _server_find(server, name);
+	if(old) {
+		_server_free(old);
+		*old = entry;
+	}
+	else {
+		if(server->noOfGraphs == server->capacity) {
+			unsigned int capacity = server->capacity? (2 * server->capacity) : 8;
+			_server_graph_t *graphs = realloc(server->graphs, capacity * sizeof(_server_graph_t));
+
+			if(!graphs) {
+				_server_free(&entry);
+				fprintf(out, "ERR %s: not enough memory for the graph\n", filename);
+				return;
+			}
+			server->graphs = graphs;
+			server->capacity = capacity;
+		}
+		server->graphs[(server->noOfGraphs)++] = entry;
+	}
+
+	fprintf(out, "OK %s %u %u %.6f\n", name, entry.n, entry.m, elapsed);
+}
+
+/**
+ * @brief TOP NAME K
+ * @note This is an internal function.
+ */
+static void _server_top(_server_t *server, _server_graph_t *entry, unsigned int k, FILE *out) {
+	unsigned int v;
+	_server_score_t *scores = malloc((entry->n + 1) * sizeof(_server_score_t));
+
+	for(v = 0; v < entry->n; v++) {
+		scores[v].v = v;
+		scores[v].val = entry->cb[v];
+	}
+	qsort(scores, entry->n, sizeof(_server_score_t), _server_compareScores);
+
+	if(k > entry->n)
+		k = entry->n;
+	fprintf(out, "OK %u\n", k);
+	for(v = 0; v < k; v++) {
+		fprintf(out, "%u ", scores[v].v);
+		_server_putValue(out, scores[v].val, server->precision);
+		fputc('\n', out);
+	}
+
+	free(scores);
+}
+
+/**
+ * @brief Parse an unsigned integer argument.
+ * @note This is an internal function.
+ * @return 0 on success, -1 if the argument is missing or not a number.
+ */
+static int _server_parseUInt(char *str, unsigned long *val) {
+	char *endPtr;
+
+	if(!str || !(*str) || ('-' == *str))
+		return -1;
+
+	*val = strtoul(str, &endPtr, 10);
+
+	return *endPtr? -1 : 0;
+}
+
+/**
+ * @brief Answer a request line.
+ * @note This is an internal function.
+ */
+static void _server_handle(_server_t *server, char *line, FILE *out) {
+	char *savePtr;
+	char *cmd = strtok_r(line, " \t\r\n", &savePtr);
+	char *arg[3];
+	unsigned long val, seed;
+	unsigned int i;
+	double elapsed;
+	_server_graph_t *entry = NULL;
+
+	if(!cmd)
+		return;
+
+	for(i = 0; i < 3; i++)
+		arg[i] = strtok_r(NULL, " \t\r\n", &savePtr);
+
+	/* Requests that operate on a loaded graph */
+	if(!strcmp(cmd, "SCORE") || !strcmp(cmd, "TOP") || !strcmp(cmd, "RECOMPUTE") || !strcmp(cmd, "UNLOAD")) {
+		if(!arg[0]) {
+			fprintf(out, "ERR missing graph name\n");
+			return;
+		}
+		entry = _server_find(server, arg[0]);
+		if(!entry) {
+			fprintf(out, "ERR unknown graph: %s\n", arg[0]);
+			return;
+		}
+	}
+
+	if(!strcmp(cmd, "LOAD")) {
+		if(!arg[0] || !arg[1])
+			fprintf(out, "ERR usage: LOAD NAME FILE\n");
+		else
+			_server_load(server, arg[0], arg[1], out);
+	}
+	else if(!strcmp(cmd, "SCORE")) {
+		if(_server_parseUInt(arg[1], &val) || (val >= entry->n)) {
+			fprintf(out, "ERR usage: SCORE NAME V, with 0 <= V < %u\n", entry->n);
+		}
+		else {
+			fprintf(out, "OK ");
+			_server_putValue(out, entry->cb[val], server->precision);
+			fputc('\n', out);
+		}
+	}
+	else if(!strcmp(cmd, "TOP")) {
+		if(_server_parseUInt(arg[1], &val))
+			fprintf(out, "ERR usage: TOP NAME K\n");
+		else
+			_server_top(server, entry, (val > entry->n)? entry->n : val, out);
+	}
+	else if(!strcmp(cmd, "RECOMPUTE")) {
+		val = 0;
+		seed = 0;
+		if((arg[1] && _server_parseUInt(arg[1], &val)) || (arg[2] && _server_parseUInt(arg[2], &seed)))
+			fprintf(out, "ERR usage: RECOMPUTE NAME [SAMPLES [SEED]]\n");
+		else if((elapsed = _server_compute(server, entry, (val > entry->n)? entry->n : val, seed)) < 0)
+			fprintf(out, "ERR %s: not enough memory, previous results kept\n", entry->name);
+		else
+			fprintf(out, "OK %s %.6f\n", entry->name, elapsed);
+	}
+	else if(!strcmp(cmd, "UNLOAD")) {
+		_server_free(entry);
+		*entry = server->graphs[--(server->noOfGraphs)];
+		fprintf(out, "OK\n");
+	}
+	else if(!strcmp(cmd, "LIST")) {
+		fprintf(out, "OK %u\n", server->noOfGraphs);
+		for(i = 0; i < server->noOfGraphs; i++)
+			fprintf(out, "%s %u %u %u\n", server->graphs[i].name, server->graphs[i].n, server->graphs[i].m, server->graphs[i].noOfSources? server->graphs[i].noOfSources : server->graphs[i].n);
+	}
+	else if(!strcmp(cmd, "SHUTDOWN")) {
+		server->shutdown = true;
+		fprintf(out, "OK\n");
+	}
+	else {
+		fprintf(out, "ERR unknown request: %s\n", cmd);
+	}
+}
+
+/**
+ * @brief Serve a client until it closes the connection (or asks for shutdown).
+ * @note This is an internal function.
+ */
+static void _server_serve(_server_t *server, int fd) {
+	int outFd = dup(fd);
+	FILE *in = fdopen(fd, "r");
+	FILE *out = (-1 == outFd)? NULL : fdopen(outFd, "w");
+	char *line = NULL;
+	size_t lineSz = 0;
+	ssize_t len;
+
+	if(!in || !out) {
+		if(in)
+			fclose(in);
+		else
+			close(fd);
+		if(out)
+			fclose(out);
+		else if(outFd != -1)
+			close(outFd);
+		return;
+	}
+
+	while(!(server->shutdown) && ((len = getline(&line, &lineSz, in)) != -1)) {
+		if(len >= SERVER_MAX_LINE_SZ)
+			fprintf(out, "ERR request too long\n");
+		else
+			_server_handle(server, line, out);
+
+		/* Answer each request right away: clients may wait for it before sending the next one */
+		fflush(out);
+	}
+
+	free(line);
+	fclose(out);
+	fclose(in);
+}
+
+/**
+ * @brief Listen on a Unix domain socket and answer requests until a SHUTDOWN request arrives.
+ */
+int server_run(char *socketPath, unsigned int noOfThreads, int precision) {
+	int fd, conn;
+	unsigned int i;
+	struct sockaddr_un addr;
+	struct stat st;
+	_server_t server;
+
+	memset(&addr, 0, sizeof(struct sockaddr_un));
+	addr.sun_family = AF_UNIX;
+	if(strlen(socketPath) >= sizeof(addr.sun_path)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+	strcpy(addr.sun_path, socketPath);
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(-1 == fd)
+		return -1;
+
+	/* Replace a stale socket, but not one with a live server behind it */
+	if(!stat(socketPath, &st) && S_ISSOCK(st.st_mode)) {
+		if(!connect(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un))) {
+			close(fd);
+			errno = EADDRINUSE;
+			return -1;
+		}
+		unlink(socketPath);
+	}
+
+	if(bind(fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_un)) || listen(fd, 16)) {
+		close(fd);
+		return -1;
+	}
+
+	/* Clients that leave early must not kill the server */
+	signal(SIGPIPE, SIG_IGN);
+
+	memset(&server, 0, sizeof(_server_t));
+	brandes_initWork(&(server.work));
+	server.noOfThreads = noOfThreads;
+	server.precision = precision;
+
+	fprintf(stderr, "Listening on %s\n", socketPath);
+
+	while(!(server.shutdown)) {
+		conn = accept(fd, NULL, NULL);
+		if(-1 == conn) {
+			if(EINTR == errno)
+				continue;
+			break;
+		}
+
+		_server_serve(&server, conn);
+	}
+
+	for(i = 0; i < server.noOfGraphs; i++)
+		_server_free(&(server.graphs[i]));
+	free(server.graphs);
+	brandes_freeWork(&(server.work));
+
+	close(fd);
+	unlink(socketPath);
+
+	return server.shutdown? 0 : -1;
+}
@@ -0,0 +1,131 @@
+/* ********************************************************************************************* */
+/* * Simple library for run statistics: libstats                                               * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libstats is free software: you can redistribute it and/or modify it under the terms of    * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libstats is distributed in the hope that it will be useful, but WITHOUT ANY               * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libstats.    * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "stats.h"
+
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+/* Names of each phase, as printed */
+static const char *_stats_phaseNames[STATS_NO_OF_PHASES] = {
+	"load", "preprocess", "forward", "backward", "output"
+};
+
+/**
+ * @brief Get current wall time.
+ */
+double stats_now(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+/**
+ * @brief Reset all statistics.
+ */
+void stats_reset(stats_t *stats) {
+	memset(stats, 0, sizeof(stats_t));
+}
+
+/**
+ * @brief Sample the peak resident set size of this process into stats.
+ */
+void stats_sampleRSS(stats_t *stats) {
+	struct rusage usage;
+
+	/* On Linux, ru_maxrss is given in KiB */
+	if(!getrusage(RUSAGE_SELF, &usage))
+		stats->peakRSS = usage.ru_maxrss;
+}
+
+/**
+ * @brief Get the traversed edges per second of the BFS phases (forward and backward).
+ */
+double stats_getTEPS(stats_t *stats) {
+	double bfsTime = stats->phaseTime[STATS_PHASE_FORWARD] + stats->phaseTime[STATS_PHASE_BACKWARD];
+
+	return (bfsTime > 0)? (stats->edgesTraversed / bfsTime) : 0;
+}
+
+/**
+ * @brief Print statistics in human-readable form.
+ */
+void stats_print(FILE *file, stats_t *stats) {
+	int i;
+	double total = 0;
+
+	for(i = 0; i < STATS_NO_OF_PHASES; i++)
+		total += stats->phaseTime[i];
+
+	fprintf(file, "Graph: %u nodes, %u edges\n", stats->n, stats->m);
+	for(i = 0; i < STATS_NO_OF_PHASES; i++)
+		fprintf(file, "Time (%s): %.3f ms (%.1f%%)\n", _stats_phaseNames[i], stats->phaseTime[i] * 1000, total? (100 * stats->phaseTime[i] / total) : 0);
+	fprintf(file, "Time (total): %.3f ms\n", total * 1000);
+	fprintf(file, "Edges traversed: %llu\n", stats->edgesTraversed);
+	fprintf(file, "Vertices visited: %llu\n", stats->verticesVisited);
+	fprintf(file, "Max BFS depth: %u\n", stats->maxDepth);
+	fprintf(file, "Peak RSS: %ld KiB\n", stats->peakRSS);
+	if(stats->localPages + stats->remotePages)
+		fprintf(file, "NUMA placement: %llu local pages, %llu remote pages (%.1f%% local)\n", stats->localPages, stats->remotePages, 100.0 * stats->localPages / (stats->localPages + stats->remotePages));
+	if(stats->largeBytes)
+		fprintf(file, "Huge pages: %.1f MiB of %.1f MiB of large arrays (%.1f%%)\n", stats->hugeBytes / 1048576.0, stats->largeBytes / 1048576.0, 100.0 * stats->hugeBytes / stats->largeBytes);
+	for(i = 0; i < stats->noOfThreads; i++)
+		fprintf(file, "Thread %d: busy %.3f ms, idle %.3f ms (%.1f%% busy)\n", i, stats->busyTime[i] * 1000, stats->idleTime[i] * 1000, (stats->busyTime[i] + stats->idleTime[i] > 0)? (100 * stats->busyTime[i] / (stats->busyTime[i] + stats->idleTime[i])) : 0);
+	if(stats->noOfThreads)
+		fprintf(file, "Steals: %llu\n", stats->noOfSteals);
+	if(stats->backwardKernel)
+		fprintf(file, "Backward kernel: %s\n", stats->backwardKernel);
+	fprintf(file, "TEPS: %.4g\n", stats_getTEPS(stats));
+}
+
+/**
+ * @brief Print statistics as a JSON object.
+ */
+void stats_printJSON(FILE *file, stats_t *stats) {
+	int i;
+
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"n\": %u,\n", stats->n);
+	fprintf(file, "\t\"m\": %u,\n", stats->m);
+	fprintf(file, "\t\"time_s\": {");
+	for(i = 0; i < STATS_NO_OF_PHASES; i++)
+		fprintf(file, "%s\"%s\": %.9f", i? ", " : "", _stats_phaseNames[i], stats->phaseTime[i]);
+	fprintf(file, "},\n");
+	fprintf(file, "\t\"edges_traversed\": %llu,\n", stats->edgesTraversed);
+	fprintf(file, "\t\"vertices_visited\": %llu,\n", stats->verticesVisited);
+	fprintf(file, "\t\"max_bfs_depth\": %u,\n", stats->maxDepth);
+	fprintf(file, "\t\"peak_rss_kib\": %ld,\n", stats->peakRSS);
+	fprintf(file, "\t\"local_pages\": %llu,\n", stats->localPages);
+	fprintf(file, "\t\"remote_pages\": %llu,\n", stats->remotePages);
+	fprintf(file, "\t\"large_bytes\": %llu,\n", stats->largeBytes);
+	fprintf(file, "\t\"huge_page_bytes\": %llu,\n", stats->hugeBytes);
+	fprintf(file, "\t\"threads\": [");
+	for(i = 0; i < stats->noOfThreads; i++)
+		fprintf(file, "%s{\"busy_s\": %.9f, \"idle_s\": %.9f}", i? ", " : "", stats->busyTime[i], stats->idleTime[i]);
+	fprintf(file, "],\n");
+	fprintf(file, "\t\"steals\": %llu,\n", stats->noOfSteals);
+	if(stats->backwardKernel)
+		fprintf(file, "\t\"backward_kernel\": \"%s\",\n", stats->backwardKernel);
+	else
+		fprintf(file, "\t\"backward_kernel\": null,\n");
+	fprintf(file, "\t\"teps\": %.6g\n", stats_getTEPS(stats));
+	fprintf(file, "}\n");
+}
@@ -0,0 +1,635 @@
+/* ********************************************************************************************* */
+/* * Simple library for writing betweenness results: libwriter                                 * */
+/* * Author: André Bannwart Perina                                                             * */
+/* ********************************************************************************************* */
+/* * Copyright (c) 2017 André B. Perina                                                        * */
+/* *                                                                                           * */
+/* * libwriter is free software: you can redistribute it and/or modify it under the terms of   * */
+/* * the GNU General Public License as published by the Free Software Foundation, either       * */
+/* * version 3 of the License, or (at your option) any later version.                          * */
+/* *                                                                                           * */
+/* * libwriter is distributed in the hope that it will be useful, but WITHOUT ANY              * */
+/* * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A           * */
+/* * PARTICULAR PURPOSE.  See the GNU General Public License for more details.                 * */
+/* *                                                                                           * */
+/* * You should have received a copy of the GNU General Public License along with libwriter.   * */
+/* * If not, see <http://www.gnu.org/licenses/>.                                               * */
+/* ********************************************************************************************* */
+
+#include "writer.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Size of the output buffer for text files */
+#define BUFFER_SZ 65536
+/* Largest precision handled without printf */
+#define MAX_FAST_PRECISION 9
+/* Largest scaled value handled without printf (below 2^53, so that the integer part is exact) */
+#define MAX_FAST_SCALED 1e15
+
+/* Decimal exponents of the powers of ten used to find the shortest digits of a double */
+#define MIN_SHORTEST_POW10 -292
+#define MAX_SHORTEST_POW10 324
+/* Shortest text is written in fixed notation for decimal exponents in this range, in scientific notation otherwise */
+#define MIN_FIXED_EXP -4
+#define MAX_FIXED_EXP 16
+
+static const uint64_t _writer_pow10[MAX_FAST_PRECISION + 1] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull
+};
+
+/*
+ * 128-bit significands of the powers of ten from 10^MIN_SHORTEST_POW10 to 10^MAX_SHORTEST_POW10, high half first:
+ * 10^k = beta * 2^r with 2^127 <= beta < 2^128, stored as floor(beta) + 1
+ */
+static const uint64_t _writer_shortestPow10[MAX_SHORTEST_POW10 - MIN_SHORTEST_POW10 + 1][2] = {
+	{0xFF77B1FCBEBCDC4Full, 0x25E8E89C13BB0F7Bull}, {0x9FAACF3DF73609B1ull, 0x77B191618C54E9ADull},
+	{0xC795830D75038C1Dull, 0xD59DF5B9EF6A2418ull}, {0xF97AE3D0D2446F25ull, 0x4B0573286B44AD1Eull},
+	{0x9BECCE62836AC577ull, 0x4EE367F9430AEC33ull}, {0xC2E801FB244576D5ull, 0x229C41F793CDA740ull},
+	{0xF3A20279ED56D48Aull, 0x6B43527578C11110ull}, {0x9845418C345644D6ull, 0x830A13896B78AAAAull},
+	{0xBE5691EF416BD60Cull, 0x23CC986BC656D554ull}, {0xEDEC366B11C6CB8Full, 0x2CBFBE86B7EC8AA9ull},
+	{0x94B3A202EB1C3F39ull, 0x7BF7D71432F3D6AAull}, {0xB9E08A83A5E34F07ull, 0xDAF5CCD93FB0CC54ull},
+	{0xE858AD248F5C22C9ull, 0xD1B3400F8F9CFF69ull}, {0x91376C36D99995BEull, 0x23100809B9C21FA2ull},
+	{0xB58547448FFFFB2Dull, 0xABD40A0C2832A78Bull}, {0xE2E69915B3FFF9F9ull, 0x16C90C8F323F516Dull},
+	{0x8DD01FAD907FFC3Bull, 0xAE3DA7D97F6792E4ull}, {0xB1442798F49FFB4Aull, 0x99CD11CFDF41779Dull},
+	{0xDD95317F31C7FA1Dull, 0x40405643D711D584ull}, {0x8A7D3EEF7F1CFC52ull, 0x482835EA666B2573ull},
+	{0xAD1C8EAB5EE43B66ull, 0xDA3243650005EED0ull}, {0xD863B256369D4A40ull, 0x90BED43E40076A83ull},
+	{0x873E4F75E2224E68ull, 0x5A7744A6E804A292ull}, {0xA90DE3535AAAE202ull, 0x711515D0A205CB37ull},
+	{0xD3515C2831559A83ull, 0x0D5A5B44CA873E04ull}, {0x8412D9991ED58091ull, 0xE858790AFE9486C3ull},
+	{0xA5178FFF668AE0B6ull, 0x626E974DBE39A873ull}, {0xCE5D73FF402D98E3ull, 0xFB0A3D212DC81290ull},
+	{0x80FA687F881C7F8Eull, 0x7CE66634BC9D0B9Aull}, {0xA139029F6A239F72ull, 0x1C1FFFC1EBC44E81ull},
+	{0xC987434744AC874Eull, 0xA327FFB266B56221ull}, {0xFBE9141915D7A922ull, 0x4BF1FF9F0062BAA9ull},
+	{0x9D71AC8FADA6C9B5ull, 0x6F773FC3603DB4AAull}, {0xC4CE17B399107C22ull, 0xCB550FB4384D21D4ull},
+	{0xF6019DA07F549B2Bull, 0x7E2A53A146606A49ull}, {0x99C102844F94E0FBull, 0x2EDA7444CBFC426Eull},
+	{0xC0314325637A1939ull, 0xFA911155FEFB5309ull}, {0xF03D93EEBC589F88ull, 0x793555AB7EBA27CBull},
+	{0x96267C7535B763B5ull, 0x4BC1558B2F3458DFull}, {0xBBB01B9283253CA2ull, 0x9EB1AAEDFB016F17ull},
+	{0xEA9C227723EE8BCBull, 0x465E15A979C1CADDull}, {0x92A1958A7675175Full, 0x0BFACD89EC191ECAull},
+	{0xB749FAED14125D36ull, 0xCEF980EC671F667Cull}, {0xE51C79A85916F484ull, 0x82B7E12780E7401Bull},
+	{0x8F31CC0937AE58D2ull, 0xD1B2ECB8B0908811ull}, {0xB2FE3F0B8599EF07ull, 0x861FA7E6DCB4AA16ull},
+	{0xDFBDCECE67006AC9ull, 0x67A791E093E1D49Bull}, {0x8BD6A141006042BDull, 0xE0C8BB2C5C6D24E1ull},
+	{0xAECC49914078536Dull, 0x58FAE9F773886E19ull}, {0xDA7F5BF590966848ull, 0xAF39A475506A899Full},
+	{0x888F99797A5E012Dull, 0x6D8406C952429604ull}, {0xAAB37FD7D8F58178ull, 0xC8E5087BA6D33B84ull},
+	{0xD5605FCDCF32E1D6ull, 0xFB1E4A9A90880A65ull}, {0x855C3BE0A17FCD26ull, 0x5CF2EEA09A550680ull},
+	{0xA6B34AD8C9DFC06Full, 0xF42FAA48C0EA481Full}, {0xD0601D8EFC57B08Bull, 0xF13B94DAF124DA27ull},
+	{0x823C12795DB6CE57ull, 0x76C53D08D6B70859ull}, {0xA2CB1717B52481EDull, 0x54768C4B0C64CA6Full},
+	{0xCB7DDCDDA26DA268ull, 0xA9942F5DCF7DFD0Aull}, {0xFE5D54150B090B02ull, 0xD3F93B35435D7C4Dull},
+	{0x9EFA548D26E5A6E1ull, 0xC47BC5014A1A6DB0ull}, {0xC6B8E9B0709F109Aull, 0x359AB6419CA1091Cull},
+	{0xF867241C8CC6D4C0ull, 0xC30163D203C94B63ull}, {0x9B407691D7FC44F8ull, 0x79E0DE63425DCF1Eull},
+	{0xC21094364DFB5636ull, 0x985915FC12F542E5ull}, {0xF294B943E17A2BC4ull, 0x3E6F5B7B17B2939Eull},
+	{0x979CF3CA6CEC5B5Aull, 0xA705992CEECF9C43ull}, {0xBD8430BD08277231ull, 0x50C6FF782A838354ull},
+	{0xECE53CEC4A314EBDull, 0xA4F8BF5635246429ull}, {0x940F4613AE5ED136ull, 0x871B7795E136BE9Aull},
+	{0xB913179899F68584ull, 0x28E2557B59846E40ull}, {0xE757DD7EC07426E5ull, 0x331AEADA2FE589D0ull},
+	{0x9096EA6F3848984Full, 0x3FF0D2C85DEF7622ull}, {0xB4BCA50B065ABE63ull, 0x0FED077A756B53AAull},
+	{0xE1EBCE4DC7F16DFBull, 0xD3E8495912C62895ull}, {0x8D3360F09CF6E4BDull, 0x64712DD7ABBBD95Dull},
+	{0xB080392CC4349DECull, 0xBD8D794D96AACFB4ull}, {0xDCA04777F541C567ull, 0xECF0D7A0FC5583A1ull},
+	{0x89E42CAAF9491B60ull, 0xF41686C49DB57245ull}, {0xAC5D37D5B79B6239ull, 0x311C2875C522CED6ull},
+	{0xD77485CB25823AC7ull, 0x7D633293366B828Cull}, {0x86A8D39EF77164BCull, 0xAE5DFF9C02033198ull},
+	{0xA8530886B54DBDEBull, 0xD9F57F830283FDFDull}, {0xD267CAA862A12D66ull, 0xD072DF63C324FD7Cull},
+	{0x8380DEA93DA4BC60ull, 0x4247CB9E59F71E6Eull}, {0xA46116538D0DEB78ull, 0x52D9BE85F074E609ull},
+	{0xCD795BE870516656ull, 0x67902E276C921F8Cull}, {0x806BD9714632DFF6ull, 0x00BA1CD8A3DB53B7ull},
+	{0xA086CFCD97BF97F3ull, 0x80E8A40ECCD228A5ull}, {0xC8A883C0FDAF7DF0ull, 0x6122CD128006B2CEull},
+	{0xFAD2A4B13D1B5D6Cull, 0x796B805720085F82ull}, {0x9CC3A6EEC6311A63ull, 0xCBE3303674053BB1ull},
+	{0xC3F490AA77BD60FCull, 0xBEDBFC4411068A9Dull}, {0xF4F1B4D515ACB93Bull, 0xEE92FB5515482D45ull},
+	{0x991711052D8BF3C5ull, 0x751BDD152D4D1C4Bull}, {0xBF5CD54678EEF0B6ull, 0xD262D45A78A0635Eull},
+	{0xEF340A98172AACE4ull, 0x86FB897116C87C35ull}, {0x9580869F0E7AAC0Eull, 0xD45D35E6AE3D4DA1ull},
+	{0xBAE0A846D2195712ull, 0x8974836059CCA10Aull}, {0xE998D258869FACD7ull, 0x2BD1A438703FC94Cull},
+	{0x91FF83775423CC06ull, 0x7B6306A34627DDD0ull}, {0xB67F6455292CBF08ull, 0x1A3BC84C17B1D543ull},
+	{0xE41F3D6A7377EECAull, 0x20CABA5F1D9E4A94ull}, {0x8E938662882AF53Eull, 0x547EB47B7282EE9Dull},
+	{0xB23867FB2A35B28Dull, 0xE99E619A4F23AA44ull}, {0xDEC681F9F4C31F31ull, 0x6405FA00E2EC94D5ull},
+	{0x8B3C113C38F9F37Eull, 0xDE83BC408DD3DD05ull}, {0xAE0B158B4738705Eull, 0x9624AB50B148D446ull},
+	{0xD98DDAEE19068C76ull, 0x3BADD624DD9B0958ull}, {0x87F8A8D4CFA417C9ull, 0xE54CA5D70A80E5D7ull},
+	{0xA9F6D30A038D1DBCull, 0x5E9FCF4CCD211F4Dull}, {0xD47487CC8470652Bull, 0x7647C32000696720ull},
+	{0x84C8D4DFD2C63F3Bull, 0x29ECD9F40041E074ull}, {0xA5FB0A17C777CF09ull, 0xF468107100525891ull},
+	{0xCF79CC9DB955C2CCull, 0x7182148D4066EEB5ull}, {0x81AC1FE293D599BFull, 0xC6F14CD848405531ull},
+	{0xA21727DB38CB002Full, 0xB8ADA00E5A506A7Dull}, {0xCA9CF1D206FDC03Bull, 0xA6D90811F0E4851Dull},
+	{0xFD442E4688BD304Aull, 0x908F4A166D1DA664ull}, {0x9E4A9CEC15763E2Eull, 0x9A598E4E043287FFull},
+	{0xC5DD44271AD3CDBAull, 0x40EFF1E1853F29FEull}, {0xF7549530E188C128ull, 0xD12BEE59E68EF47Dull},
+	{0x9A94DD3E8CF578B9ull, 0x82BB74F8301958CFull}, {0xC13A148E3032D6E7ull, 0xE36A52363C1FAF02ull},
+	{0xF18899B1BC3F8CA1ull, 0xDC44E6C3CB279AC2ull}, {0x96F5600F15A7B7E5ull, 0x29AB103A5EF8C0BAull},
+	{0xBCB2B812DB11A5DEull, 0x7415D448F6B6F0E8ull}, {0xEBDF661791D60F56ull, 0x111B495B3464AD22ull},
+	{0x936B9FCEBB25C995ull, 0xCAB10DD900BEEC35ull}, {0xB84687C269EF3BFBull, 0x3D5D514F40EEA743ull},
+	{0xE65829B3046B0AFAull, 0x0CB4A5A3112A5113ull}, {0x8FF71A0FE2C2E6DCull, 0x47F0E785EABA72ACull},
+	{0xB3F4E093DB73A093ull, 0x59ED216765690F57ull}, {0xE0F218B8D25088B8ull, 0x306869C13EC3532Dull},
+	{0x8C974F7383725573ull, 0x1E414218C73A13FCull}, {0xAFBD2350644EEACFull, 0xE5D1929EF90898FBull},
+	{0xDBAC6C247D62A583ull, 0xDF45F746B74ABF3Aull}, {0x894BC396CE5DA772ull, 0x6B8BBA8C328EB784ull},
+	{0xAB9EB47C81F5114Full, 0x066EA92F3F326565ull}, {0xD686619BA27255A2ull, 0xC80A537B0EFEFEBEull},
+	{0x8613FD0145877585ull, 0xBD06742CE95F5F37ull}, {0xA798FC4196E952E7ull, 0x2C48113823B73705ull},
+	{0xD17F3B51FCA3A7A0ull, 0xF75A15862CA504C6ull}, {0x82EF85133DE648C4ull, 0x9A984D73DBE722FCull},
+	{0xA3AB66580D5FDAF5ull, 0xC13E60D0D2E0EBBBull}, {0xCC963FEE10B7D1B3ull, 0x318DF905079926A9ull},
+	{0xFFBBCFE994E5C61Full, 0xFDF17746497F7053ull}, {0x9FD561F1FD0F9BD3ull, 0xFEB6EA8BEDEFA634ull},
+	{0xC7CABA6E7C5382C8ull, 0xFE64A52EE96B8FC1ull}, {0xF9BD690A1B68637Bull, 0x3DFDCE7AA3C673B1ull},
+	{0x9C1661A651213E2Dull, 0x06BEA10CA65C084Full}, {0xC31BFA0FE5698DB8ull, 0x486E494FCFF30A63ull},
+	{0xF3E2F893DEC3F126ull, 0x5A89DBA3C3EFCCFBull}, {0x986DDB5C6B3A76B7ull, 0xF89629465A75E01Dull},
+	{0xBE89523386091465ull, 0xF6BBB397F1135824ull}, {0xEE2BA6C0678B597Full, 0x746AA07DED582E2Dull},
+	{0x94DB483840B717EFull, 0xA8C2A44EB4571CDDull}, {0xBA121A4650E4DDEBull, 0x92F34D62616CE414ull},
+	{0xE896A0D7E51E1566ull, 0x77B020BAF9C81D18ull}, {0x915E2486EF32CD60ull, 0x0ACE1474DC1D122Full},
+	{0xB5B5ADA8AAFF80B8ull, 0x0D819992132456BBull}, {0xE3231912D5BF60E6ull, 0x10E1FFF697ED6C6Aull},
+	{0x8DF5EFABC5979C8Full, 0xCA8D3FFA1EF463C2ull}, {0xB1736B96B6FD83B3ull, 0xBD308FF8A6B17CB3ull},
+	{0xDDD0467C64BCE4A0ull, 0xAC7CB3F6D05DDBDFull}, {0x8AA22C0DBEF60EE4ull, 0x6BCDF07A423AA96Cull},
+	{0xAD4AB7112EB3929Dull, 0x86C16C98D2C953C7ull}, {0xD89D64D57A607744ull, 0xE871C7BF077BA8B8ull},
+	{0x87625F056C7C4A8Bull, 0x11471CD764AD4973ull}, {0xA93AF6C6C79B5D2Dull, 0xD598E40D3DD89BD0ull},
+	{0xD389B47879823479ull, 0x4AFF1D108D4EC2C4ull}, {0x843610CB4BF160CBull, 0xCEDF722A585139BBull},
+	{0xA54394FE1EEDB8FEull, 0xC2974EB4EE658829ull}, {0xCE947A3DA6A9273Eull, 0x733D226229FEEA33ull},
+	{0x811CCC668829B887ull, 0x0806357D5A3F5260ull}, {0xA163FF802A3426A8ull, 0xCA07C2DCB0CF26F8ull},
+	{0xC9BCFF6034C13052ull, 0xFC89B393DD02F0B6ull}, {0xFC2C3F3841F17C67ull, 0xBBAC2078D443ACE3ull},
+	{0x9D9BA7832936EDC0ull, 0xD54B944B84AA4C0Eull}, {0xC5029163F384A931ull, 0x0A9E795E65D4DF12ull},
+	{0xF64335BCF065D37Dull, 0x4D4617B5FF4A16D6ull}, {0x99EA0196163FA42Eull, 0x504BCED1BF8E4E46ull},
+	{0xC06481FB9BCF8D39ull, 0xE45EC2862F71E1D7ull}, {0xF07DA27A82C37088ull, 0x5D767327BB4E5A4Dull},
+	{0x964E858C91BA2655ull, 0x3A6A07F8D510F870ull}, {0xBBE226EFB628AFEAull, 0x890489F70A55368Cull},
+	{0xEADAB0ABA3B2DBE5ull, 0x2B45AC74CCEA842Full}, {0x92C8AE6B464FC96Full, 0x3B0B8BC90012929Eull},
+	{0xB77ADA0617E3BBCBull, 0x09CE6EBB40173745ull}, {0xE55990879DDCAABDull, 0xCC420A6A101D0516ull},
+	{0x8F57FA54C2A9EAB6ull, 0x9FA946824A12232Eull}, {0xB32DF8E9F3546564ull, 0x47939822DC96ABFAull},
+	{0xDFF9772470297EBDull, 0x59787E2B93BC56F8ull}, {0x8BFBEA76C619EF36ull, 0x57EB4EDB3C55B65Bull},
+	{0xAEFAE51477A06B03ull, 0xEDE622920B6B23F2ull}, {0xDAB99E59958885C4ull, 0xE95FAB368E45ECEEull},
+	{0x88B402F7FD75539Bull, 0x11DBCB0218EBB415ull}, {0xAAE103B5FCD2A881ull, 0xD652BDC29F26A11Aull},
+	{0xD59944A37C0752A2ull, 0x4BE76D3346F04960ull}, {0x857FCAE62D8493A5ull, 0x6F70A4400C562DDCull},
+	{0xA6DFBD9FB8E5B88Eull, 0xCB4CCD500F6BB953ull}, {0xD097AD07A71F26B2ull, 0x7E2000A41346A7A8ull},
+	{0x825ECC24C873782Full, 0x8ED400668C0C28C9ull}, {0xA2F67F2DFA90563Bull, 0x728900802F0F32FBull},
+	{0xCBB41EF979346BCAull, 0x4F2B40A03AD2FFBAull}, {0xFEA126B7D78186BCull, 0xE2F610C84987BFA9ull},
+	{0x9F24B832E6B0F436ull, 0x0DD9CA7D2DF4D7CAull}, {0xC6EDE63FA05D3143ull, 0x91503D1C79720DBCull},
+	{0xF8A95FCF88747D94ull, 0x75A44C6397CE912Bull}, {0x9B69DBE1B548CE7Cull, 0xC986AFBE3EE11ABBull},
+	{0xC24452DA229B021Bull, 0xFBE85BADCE996169ull}, {0xF2D56790AB41C2A2ull, 0xFAE27299423FB9C4ull},
+	{0x97C560BA6B0919A5ull, 0xDCCD879FC967D41Bull}, {0xBDB6B8E905CB600Full, 0x5400E987BBC1C921ull},
+	{0xED246723473E3813ull, 0x290123E9AAB23B69ull}, {0x9436C0760C86E30Bull, 0xF9A0B6720AAF6522ull},
+	{0xB94470938FA89BCEull, 0xF808E40E8D5B3E6Aull}, {0xE7958CB87392C2C2ull, 0xB60B1D1230B20E05ull},
+	{0x90BD77F3483BB9B9ull, 0xB1C6F22B5E6F48C3ull}, {0xB4ECD5F01A4AA828ull, 0x1E38AEB6360B1AF4ull},
+	{0xE2280B6C20DD5232ull, 0x25C6DA63C38DE1B1ull}, {0x8D590723948A535Full, 0x579C487E5A38AD0Full},
+	{0xB0AF48EC79ACE837ull, 0x2D835A9DF0C6D852ull}, {0xDCDB1B2798182244ull, 0xF8E431456CF88E66ull},
+	{0x8A08F0F8BF0F156Bull, 0x1B8E9ECB641B5900ull}, {0xAC8B2D36EED2DAC5ull, 0xE272467E3D222F40ull},
+	{0xD7ADF884AA879177ull, 0x5B0ED81DCC6ABB10ull}, {0x86CCBB52EA94BAEAull, 0x98E947129FC2B4EAull},
+	{0xA87FEA27A539E9A5ull, 0x3F2398D747B36225ull}, {0xD29FE4B18E88640Eull, 0x8EEC7F0D19A03AAEull},
+	{0x83A3EEEEF9153E89ull, 0x1953CF68300424ADull}, {0xA48CEAAAB75A8E2Bull, 0x5FA8C3423C052DD8ull},
+	{0xCDB02555653131B6ull, 0x3792F412CB06794Eull}, {0x808E17555F3EBF11ull, 0xE2BBD88BBEE40BD1ull},
+	{0xA0B19D2AB70E6ED6ull, 0x5B6ACEAEAE9D0EC5ull}, {0xC8DE047564D20A8Bull, 0xF245825A5A445276ull},
+	{0xFB158592BE068D2Eull, 0xEED6E2F0F0D56713ull}, {0x9CED737BB6C4183Dull, 0x55464DD69685606Cull},
+	{0xC428D05AA4751E4Cull, 0xAA97E14C3C26B887ull}, {0xF53304714D9265DFull, 0xD53DD99F4B3066A9ull},
+	{0x993FE2C6D07B7FABull, 0xE546A8038EFE402Aull}, {0xBF8FDB78849A5F96ull, 0xDE98520472BDD034ull},
+	{0xEF73D256A5C0F77Cull, 0x963E66858F6D4441ull}, {0x95A8637627989AADull, 0xDDE7001379A44AA9ull},
+	{0xBB127C53B17EC159ull, 0x5560C018580D5D53ull}, {0xE9D71B689DDE71AFull, 0xAAB8F01E6E10B4A7ull},
+	{0x9226712162AB070Dull, 0xCAB3961304CA70E9ull}, {0xB6B00D69BB55C8D1ull, 0x3D607B97C5FD0D23ull},
+	{0xE45C10C42A2B3B05ull, 0x8CB89A7DB77C506Bull}, {0x8EB98A7A9A5B04E3ull, 0x77F3608E92ADB243ull},
+	{0xB267ED1940F1C61Cull, 0x55F038B237591ED4ull}, {0xDF01E85F912E37A3ull, 0x6B6C46DEC52F6689ull},
+	{0x8B61313BBABCE2C6ull, 0x2323AC4B3B3DA016ull}, {0xAE397D8AA96C1B77ull, 0xABEC975E0A0D081Bull},
+	{0xD9C7DCED53C72255ull, 0x96E7BD358C904A22ull}, {0x881CEA14545C7575ull, 0x7E50D64177DA2E55ull},
+	{0xAA242499697392D2ull, 0xDDE50BD1D5D0B9EAull}, {0xD4AD2DBFC3D07787ull, 0x955E4EC64B44E865ull},
+	{0x84EC3C97DA624AB4ull, 0xBD5AF13BEF0B113Full}, {0xA6274BBDD0FADD61ull, 0xECB1AD8AEACDD58Full},
+	{0xCFB11EAD453994BAull, 0x67DE18EDA5814AF3ull}, {0x81CEB32C4B43FCF4ull, 0x80EACF948770CED8ull},
+	{0xA2425FF75E14FC31ull, 0xA1258379A94D028Eull}, {0xCAD2F7F5359A3B3Eull, 0x096EE45813A04331ull},
+	{0xFD87B5F28300CA0Dull, 0x8BCA9D6E188853FDull}, {0x9E74D1B791E07E48ull, 0x775EA264CF55347Eull},
+	{0xC612062576589DDAull, 0x95364AFE032A819Eull}, {0xF79687AED3EEC551ull, 0x3A83DDBD83F52205ull},
+	{0x9ABE14CD44753B52ull, 0xC4926A9672793543ull}, {0xC16D9A0095928A27ull, 0x75B7053C0F178294ull},
+	{0xF1C90080BAF72CB1ull, 0x5324C68B12DD6339ull}, {0x971DA05074DA7BEEull, 0xD3F6FC16EBCA5E04ull},
+	{0xBCE5086492111AEAull, 0x88F4BB1CA6BCF585ull}, {0xEC1E4A7DB69561A5ull, 0x2B31E9E3D06C32E6ull},
+	{0x9392EE8E921D5D07ull, 0x3AFF322E62439FD0ull}, {0xB877AA3236A4B449ull, 0x09BEFEB9FAD487C3ull},
+	{0xE69594BEC44DE15Bull, 0x4C2EBE687989A9B4ull}, {0x901D7CF73AB0ACD9ull, 0x0F9D37014BF60A11ull},
+	{0xB424DC35095CD80Full, 0x538484C19EF38C95ull}, {0xE12E13424BB40E13ull, 0x2865A5F206B06FBAull},
+	{0x8CBCCC096F5088CBull, 0xF93F87B7442E45D4ull}, {0xAFEBFF0BCB24AAFEull, 0xF78F69A51539D749ull},
+	{0xDBE6FECEBDEDD5BEull, 0xB573440E5A884D1Cull}, {0x89705F4136B4A597ull, 0x31680A88F8953031ull},
+	{0xABCC77118461CEFCull, 0xFDC20D2B36BA7C3Eull}, {0xD6BF94D5E57A42BCull, 0x3D32907604691B4Dull},
+	{0x8637BD05AF6C69B5ull, 0xA63F9A49C2C1B110ull}, {0xA7C5AC471B478423ull, 0x0FCF80DC33721D54ull},
+	{0xD1B71758E219652Bull, 0xD3C36113404EA4A9ull}, {0x83126E978D4FDF3Bull, 0x645A1CAC083126EAull},
+	{0xA3D70A3D70A3D70Aull, 0x3D70A3D70A3D70A4ull}, {0xCCCCCCCCCCCCCCCCull, 0xCCCCCCCCCCCCCCCDull},
+	{0x8000000000000000ull, 0x0000000000000001ull}, {0xA000000000000000ull, 0x0000000000000001ull},
+	{0xC800000000000000ull, 0x0000000000000001ull}, {0xFA00000000000000ull, 0x0000000000000001ull},
+	{0x9C40000000000000ull, 0x0000000000000001ull}, {0xC350000000000000ull, 0x0000000000000001ull},
+	{0xF424000000000000ull, 0x0000000000000001ull}, {0x9896800000000000ull, 0x0000000000000001ull},
+	{0xBEBC200000000000ull, 0x0000000000000001ull}, {0xEE6B280000000000ull, 0x0000000000000001ull},
+	{0x9502F90000000000ull, 0x0000000000000001ull}, {0xBA43B74000000000ull, 0x0000000000000001ull},
+	{0xE8D4A51000000000ull, 0x0000000000000001ull}, {0x9184E72A00000000ull, 0x0000000000000001ull},
+	{0xB5E620F480000000ull, 0x0000000000000001ull}, {0xE35FA931A0000000ull, 0x0000000000000001ull},
+	{0x8E1BC9BF04000000ull, 0x0000000000000001ull}, {0xB1A2BC2EC5000000ull, 0x0000000000000001ull},
+	{0xDE0B6B3A76400000ull, 0x0000000000000001ull}, {0x8AC7230489E80000ull, 0x0000000000000001ull},
+	{0xAD78EBC5AC620000ull, 0x0000000000000001ull}, {0xD8D726B7177A8000ull, 0x0000000000000001ull},
+	{0x878678326EAC9000ull, 0x0000000000000001ull}, {0xA968163F0A57B400ull, 0x0000000000000001ull},
+	{0xD3C21BCECCEDA100ull, 0x0000000000000001ull}, {0x84595161401484A0ull, 0x0000000000000001ull},
+	{0xA56FA5B99019A5C8ull, 0x0000000000000001ull}, {0xCECB8F27F4200F3Aull, 0x0000000000000001ull},
+	{0x813F3978F8940984ull, 0x4000000000000001ull}, {0xA18F07D736B90BE5ull, 0x5000000000000001ull},
+	{0xC9F2C9CD04674EDEull, 0xA400000000000001ull}, {0xFC6F7C4045812296ull, 0x4D00000000000001ull},
+	{0x9DC5ADA82B70B59Dull, 0xF020000000000001ull}, {0xC5371912364CE305ull, 0x6C28000000000001ull},
+	{0xF684DF56C3E01BC6ull, 0xC732000000000001ull}, {0x9A130B963A6C115Cull, 0x3C7F400000000001ull},
+	{0xC097CE7BC90715B3ull, 0x4B9F100000000001ull}, {0xF0BDC21ABB48DB20ull, 0x1E86D40000000001ull},
+	{0x96769950B50D88F4ull, 0x1314448000000001ull}, {0xBC143FA4E250EB31ull, 0x17D955A000000001ull},
+	{0xEB194F8E1AE525FDull, 0x5DCFAB0800000001ull}, {0x92EFD1B8D0CF37BEull, 0x5AA1CAE500000001ull},
+	{0xB7ABC627050305ADull, 0xF14A3D9E40000001ull}, {0xE596B7B0C643C719ull, 0x6D9CCD05D0000001ull},
+	{0x8F7E32CE7BEA5C6Full, 0xE4820023A2000001ull}, {0xB35DBF821AE4F38Bull, 0xDDA2802C8A800001ull},
+	{0xE0352F62A19E306Eull, 0xD50B2037AD200001ull}, {0x8C213D9DA502DE45ull, 0x4526F422CC340001ull},
+	{0xAF298D050E4395D6ull, 0x9670B12B7F410001ull}, {0xDAF3F04651D47B4Cull, 0x3C0CDD765F114001ull},
+	{0x88D8762BF324CD0Full, 0xA5880A69FB6AC801ull}, {0xAB0E93B6EFEE0053ull, 0x8EEA0D047A457A01ull},
+	{0xD5D238A4ABE98068ull, 0x72A4904598D6D881ull}, {0x85A36366EB71F041ull, 0x47A6DA2B7F864751ull},
+	{0xA70C3C40A64E6C51ull, 0x999090B65F67D925ull}, {0xD0CF4B50CFE20765ull, 0xFFF4B4E3F741CF6Eull},
+	{0x82818F1281ED449Full, 0xBFF8F10E7A8921A5ull}, {0xA321F2D7226895C7ull, 0xAFF72D52192B6A0Eull},
+	{0xCBEA6F8CEB02BB39ull, 0x9BF4F8A69F764491ull}, {0xFEE50B7025C36A08ull, 0x02F236D04753D5B5ull},
+	{0x9F4F2726179A2245ull, 0x01D762422C946591ull}, {0xC722F0EF9D80AAD6ull, 0x424D3AD2B7B97EF6ull},
+	{0xF8EBAD2B84E0D58Bull, 0xD2E0898765A7DEB3ull}, {0x9B934C3B330C8577ull, 0x63CC55F49F88EB30ull},
+	{0xC2781F49FFCFA6D5ull, 0x3CBF6B71C76B25FCull}, {0xF316271C7FC3908Aull, 0x8BEF464E3945EF7Bull},
+	{0x97EDD871CFDA3A56ull, 0x97758BF0E3CBB5ADull}, {0xBDE94E8E43D0C8ECull, 0x3D52EEED1CBEA318ull},
+	{0xED63A231D4C4FB27ull, 0x4CA7AAA863EE4BDEull}, {0x945E455F24FB1CF8ull, 0x8FE8CAA93E74EF6Bull},
+	{0xB975D6B6EE39E436ull, 0xB3E2FD538E122B45ull}, {0xE7D34C64A9C85D44ull, 0x60DBBCA87196B617ull},
+	{0x90E40FBEEA1D3A4Aull, 0xBC8955E946FE31CEull}, {0xB51D13AEA4A488DDull, 0x6BABAB6398BDBE42ull},
+	{0xE264589A4DCDAB14ull, 0xC696963C7EED2DD2ull}, {0x8D7EB76070A08AECull, 0xFC1E1DE5CF543CA3ull},
+	{0xB0DE65388CC8ADA8ull, 0x3B25A55F43294BCCull}, {0xDD15FE86AFFAD912ull, 0x49EF0EB713F39EBFull},
+	{0x8A2DBF142DFCC7ABull, 0x6E3569326C784338ull}, {0xACB92ED9397BF996ull, 0x49C2C37F07965405ull},
+	{0xD7E77A8F87DAF7FBull, 0xDC33745EC97BE907ull}, {0x86F0AC99B4E8DAFDull, 0x69A028BB3DED71A4ull},
+	{0xA8ACD7C0222311BCull, 0xC40832EA0D68CE0Dull}, {0xD2D80DB02AABD62Bull, 0xF50A3FA490C30191ull},
+	{0x83C7088E1AAB65DBull, 0x792667C6DA79E0FBull}, {0xA4B8CAB1A1563F52ull, 0x577001B891185939ull},
+	{0xCDE6FD5E09ABCF26ull, 0xED4C0226B55E6F87ull}, {0x80B05E5AC60B6178ull, 0x544F8158315B05B5ull},
+	{0xA0DC75F1778E39D6ull, 0x696361AE3DB1C722ull}, {0xC913936DD571C84Cull, 0x03BC3A19CD1E38EAull},
+	{0xFB5878494ACE3A5Full, 0x04AB48A04065C724ull}, {0x9D174B2DCEC0E47Bull, 0x62EB0D64283F9C77ull},
+	{0xC45D1DF942711D9Aull, 0x3BA5D0BD324F8395ull}, {0xF5746577930D6500ull, 0xCA8F44EC7EE3647Aull},
+	{0x9968BF6ABBE85F20ull, 0x7E998B13CF4E1ECCull}, {0xBFC2EF456AE276E8ull, 0x9E3FEDD8C321A67Full},
+	{0xEFB3AB16C59B14A2ull, 0xC5CFE94EF3EA101Full}, {0x95D04AEE3B80ECE5ull, 0xBBA1F1D158724A13ull},
+	{0xBB445DA9CA61281Full, 0x2A8A6E45AE8EDC98ull}, {0xEA1575143CF97226ull, 0xF52D09D71A3293BEull},
+	{0x924D692CA61BE758ull, 0x593C2626705F9C57ull}, {0xB6E0C377CFA2E12Eull, 0x6F8B2FB00C77836Dull},
+	{0xE498F455C38B997Aull, 0x0B6DFB9C0F956448ull}, {0x8EDF98B59A373FECull, 0x4724BD4189BD5EADull},
+	{0xB2977EE300C50FE7ull, 0x58EDEC91EC2CB658ull}, {0xDF3D5E9BC0F653E1ull, 0x2F2967B66737E3EEull},
+	{0x8B865B215899F46Cull, 0xBD79E0D20082EE75ull}, {0xAE67F1E9AEC07187ull, 0xECD8590680A3AA12ull},
+	{0xDA01EE641A708DE9ull, 0xE80E6F4820CC9496ull}, {0x884134FE908658B2ull, 0x3109058D147FDCDEull},
+	{0xAA51823E34A7EEDEull, 0xBD4B46F0599FD416ull}, {0xD4E5E2CDC1D1EA96ull, 0x6C9E18AC7007C91Bull},
+	{0x850FADC09923329Eull, 0x03E2CF6BC604DDB1ull}, {0xA6539930BF6BFF45ull, 0x84DB8346B786151Dull},
+	{0xCFE87F7CEF46FF16ull, 0xE612641865679A64ull}, {0x81F14FAE158C5F6Eull, 0x4FCB7E8F3F60C07Full},
+	{0xA26DA3999AEF7749ull, 0xE3BE5E330F38F09Eull}, {0xCB090C8001AB551Cull, 0x5CADF5BFD3072CC6ull},
+	{0xFDCB4FA002162A63ull, 0x73D9732FC7C8F7F7ull}, {0x9E9F11C4014DDA7Eull, 0x2867E7FDDCDD9AFBull},
+	{0xC646D63501A1511Dull, 0xB281E1FD541501B9ull}, {0xF7D88BC24209A565ull, 0x1F225A7CA91A4227ull},
+	{0x9AE757596946075Full, 0x3375788DE9B06959ull}, {0xC1A12D2FC3978937ull, 0x0052D6B1641C83AFull},
+	{0xF209787BB47D6B84ull, 0xC0678C5DBD23A49Bull}, {0x9745EB4D50CE6332ull, 0xF840B7BA963646E1ull},
+	{0xBD176620A501FBFFull, 0xB650E5A93BC3D899ull}, {0xEC5D3FA8CE427AFFull, 0xA3E51F138AB4CEBFull},
+	{0x93BA47C980E98CDFull, 0xC66F336C36B10138ull}, {0xB8A8D9BBE123F017ull, 0xB80B0047445D4185ull},
+	{0xE6D3102AD96CEC1Dull, 0xA60DC059157491E6ull}, {0x9043EA1AC7E41392ull, 0x87C89837AD68DB30ull},
+	{0xB454E4A179DD1877ull, 0x29BABE4598C311FCull}, {0xE16A1DC9D8545E94ull, 0xF4296DD6FEF3D67Bull},
+	{0x8CE2529E2734BB1Dull, 0x1899E4A65F58660Dull}, {0xB01AE745B101E9E4ull, 0x5EC05DCFF72E7F90ull},
+	{0xDC21A1171D42645Dull, 0x76707543F4FA1F74ull}, {0x899504AE72497EBAull, 0x6A06494A791C53A9ull},
+	{0xABFA45DA0EDBDE69ull, 0x0487DB9D17636893ull}, {0xD6F8D7509292D603ull, 0x45A9D2845D3C42B7ull},
+	{0x865B86925B9BC5C2ull, 0x0B8A2392BA45A9B3ull}, {0xA7F26836F282B732ull, 0x8E6CAC7768D7141Full},
+	{0xD1EF0244AF2364FFull, 0x3207D795430CD927ull}, {0x8335616AED761F1Full, 0x7F44E6BD49E807B9ull},
+	{0xA402B9C5A8D3A6E7ull, 0x5F16206C9C6209A7ull}, {0xCD036837130890A1ull, 0x36DBA887C37A8C10ull},
+	{0x802221226BE55A64ull, 0xC2494954DA2C978Aull}, {0xA02AA96B06DEB0FDull, 0xF2DB9BAA10B7BD6Dull},
+	{0xC83553C5C8965D3Dull, 0x6F92829494E5ACC8ull}, {0xFA42A8B73ABBF48Cull, 0xCB772339BA1F17FAull},
+	{0x9C69A97284B578D7ull, 0xFF2A760414536EFCull}, {0xC38413CF25E2D70Dull, 0xFEF5138519684ABBull},
+	{0xF46518C2EF5B8CD1ull, 0x7EB258665FC25D6Aull}, {0x98BF2F79D5993802ull, 0xEF2F773FFBD97A62ull},
+	{0xBEEEFB584AFF8603ull, 0xAAFB550FFACFD8FBull}, {0xEEAABA2E5DBF6784ull, 0x95BA2A53F983CF39ull},
+	{0x952AB45CFA97A0B2ull, 0xDD945A747BF26184ull}, {0xBA756174393D88DFull, 0x94F971119AEEF9E5ull},
+	{0xE912B9D1478CEB17ull, 0x7A37CD5601AAB85Eull}, {0x91ABB422CCB812EEull, 0xAC62E055C10AB33Bull},
+	{0xB616A12B7FE617AAull, 0x577B986B314D600Aull}, {0xE39C49765FDF9D94ull, 0xED5A7E85FDA0B80Cull},
+	{0x8E41ADE9FBEBC27Dull, 0x14588F13BE847308ull}, {0xB1D219647AE6B31Cull, 0x596EB2D8AE258FC9ull},
+	{0xDE469FBD99A05FE3ull, 0x6FCA5F8ED9AEF3BCull}, {0x8AEC23D680043BEEull, 0x25DE7BB9480D5855ull},
+	{0xADA72CCC20054AE9ull, 0xAF561AA79A10AE6Bull}, {0xD910F7FF28069DA4ull, 0x1B2BA1518094DA05ull},
+	{0x87AA9AFF79042286ull, 0x90FB44D2F05D0843ull}, {0xA99541BF57452B28ull, 0x353A1607AC744A54ull},
+	{0xD3FA922F2D1675F2ull, 0x42889B8997915CE9ull}, {0x847C9B5D7C2E09B7ull, 0x69956135FEBADA12ull},
+	{0xA59BC234DB398C25ull, 0x43FAB9837E699096ull}, {0xCF02B2C21207EF2Eull, 0x94F967E45E03F4BCull},
+	{0x8161AFB94B44F57Dull, 0x1D1BE0EEBAC278F6ull}, {0xA1BA1BA79E1632DCull, 0x6462D92A69731733ull},
+	{0xCA28A291859BBF93ull, 0x7D7B8F7503CFDCFFull}, {0xFCB2CB35E702AF78ull, 0x5CDA735244C3D43Full},
+	{0x9DEFBF01B061ADABull, 0x3A0888136AFA64A8ull}, {0xC56BAEC21C7A1916ull, 0x088AAA1845B8FDD1ull},
+	{0xF6C69A72A3989F5Bull, 0x8AAD549E57273D46ull}, {0x9A3C2087A63F6399ull, 0x36AC54E2F678864Cull},
+	{0xC0CB28A98FCF3C7Full, 0x84576A1BB416A7DEull}, {0xF0FDF2D3F3C30B9Full, 0x656D44A2A11C51D6ull},
+	{0x969EB7C47859E743ull, 0x9F644AE5A4B1B326ull}, {0xBC4665B596706114ull, 0x873D5D9F0DDE1FEFull},
+	{0xEB57FF22FC0C7959ull, 0xA90CB506D155A7EBull}, {0x9316FF75DD87CBD8ull, 0x09A7F12442D588F3ull},
+	{0xB7DCBF5354E9BECEull, 0x0C11ED6D538AEB30ull}, {0xE5D3EF282A242E81ull, 0x8F1668C8A86DA5FBull},
+	{0x8FA475791A569D10ull, 0xF96E017D694487BDull}, {0xB38D92D760EC4455ull, 0x37C981DCC395A9ADull},
+	{0xE070F78D3927556Aull, 0x85BBE253F47B1418ull}, {0x8C469AB843B89562ull, 0x93956D7478CCEC8Full},
+	{0xAF58416654A6BABBull, 0x387AC8D1970027B3ull}, {0xDB2E51BFE9D0696Aull, 0x06997B05FCC0319Full},
+	{0x88FCF317F22241E2ull, 0x441FECE3BDF81F04ull}, {0xAB3C2FDDEEAAD25Aull, 0xD527E81CAD7626C4ull},
+	{0xD60B3BD56A5586F1ull, 0x8A71E223D8D3B075ull}, {0x85C7056562757456ull, 0xF6872D5667844E4Aull},
+	{0xA738C6BEBB12D16Cull, 0xB428F8AC016561DCull}, {0xD106F86E69D785C7ull, 0xE13336D701BEBA53ull},
+	{0x82A45B450226B39Cull, 0xECC0024661173474ull}, {0xA34D721642B06084ull, 0x27F002D7F95D0191ull},
+	{0xCC20CE9BD35C78A5ull, 0x31EC038DF7B441F5ull}, {0xFF290242C83396CEull, 0x7E67047175A15272ull},
+	{0x9F79A169BD203E41ull, 0x0F0062C6E984D387ull}, {0xC75809C42C684DD1ull, 0x52C07B78A3E60869ull},
+	{0xF92E0C3537826145ull, 0xA7709A56CCDF8A83ull}, {0x9BBCC7A142B17CCBull, 0x88A66076400BB692ull},
+	{0xC2ABF989935DDBFEull, 0x6ACFF893D00EA436ull}, {0xF356F7EBF83552FEull, 0x0583F6B8C4124D44ull},
+	{0x98165AF37B2153DEull, 0xC3727A337A8B704Bull}, {0xBE1BF1B059E9A8D6ull, 0x744F18C0592E4C5Dull},
+	{0xEDA2EE1C7064130Cull, 0x1162DEF06F79DF74ull}, {0x9485D4D1C63E8BE7ull, 0x8ADDCB5645AC2BA9ull},
+	{0xB9A74A0637CE2EE1ull, 0x6D953E2BD7173693ull}, {0xE8111C87C5C1BA99ull, 0xC8FA8DB6CCDD0438ull},
+	{0x910AB1D4DB9914A0ull, 0x1D9C9892400A22A3ull}, {0xB54D5E4A127F59C8ull, 0x2503BEB6D00CAB4Cull},
+	{0xE2A0B5DC971F303Aull, 0x2E44AE64840FD61Eull}, {0x8DA471A9DE737E24ull, 0x5CEAECFED289E5D3ull},
+	{0xB10D8E1456105DADull, 0x7425A83E872C5F48ull}, {0xDD50F1996B947518ull, 0xD12F124E28F7771Aull},
+	{0x8A5296FFE33CC92Full, 0x82BD6B70D99AAA70ull}, {0xACE73CBFDC0BFB7Bull, 0x636CC64D1001550Cull},
+	{0xD8210BEFD30EFA5Aull, 0x3C47F7E05401AA4Full}, {0x8714A775E3E95C78ull, 0x65ACFAEC34810A72ull},
+	{0xA8D9D1535CE3B396ull, 0x7F1839A741A14D0Eull}, {0xD31045A8341CA07Cull, 0x1EDE48111209A051ull},
+	{0x83EA2B892091E44Dull, 0x934AED0AAB460433ull}, {0xA4E4B66B68B65D60ull, 0xF81DA84D56178540ull},
+	{0xCE1DE40642E3F4B9ull, 0x36251260AB9D668Full}, {0x80D2AE83E9CE78F3ull, 0xC1D72B7C6B42601Aull},
+	{0xA1075A24E4421730ull, 0xB24CF65B8612F820ull}, {0xC94930AE1D529CFCull, 0xDEE033F26797B628ull},
+	{0xFB9B7CD9A4A7443Cull, 0x169840EF017DA3B2ull}, {0x9D412E0806E88AA5ull, 0x8E1F289560EE864Full},
+	{0xC491798A08A2AD4Eull, 0xF1A6F2BAB92A27E3ull}, {0xF5B5D7EC8ACB58A2ull, 0xAE10AF696774B1DCull},
+	{0x9991A6F3D6BF1765ull, 0xACCA6DA1E0A8EF2Aull}, {0xBFF610B0CC6EDD3Full, 0x17FD090A58D32AF4ull},
+	{0xEFF394DCFF8A948Eull, 0xDDFC4B4CEF07F5B1ull}, {0x95F83D0A1FB69CD9ull, 0x4ABDAF101564F98Full},
+	{0xBB764C4CA7A4440Full, 0x9D6D1AD41ABE37F2ull}, {0xEA53DF5FD18D5513ull, 0x84C86189216DC5EEull},
+	{0x92746B9BE2F8552Cull, 0x32FD3CF5B4E49BB5ull}, {0xB7118682DBB66A77ull, 0x3FBC8C33221DC2A2ull},
+	{0xE4D5E82392A40515ull, 0x0FABAF3FEAA5334Bull}, {0x8F05B1163BA6832Dull, 0x29CB4D87F2A7400Full},
+	{0xB2C71D5BCA9023F8ull, 0x743E20E9EF511013ull}, {0xDF78E4B2BD342CF6ull, 0x914DA9246B255417ull},
+	{0x8BAB8EEFB6409C1Aull, 0x1AD089B6C2F7548Full}, {0xAE9672ABA3D0C320ull, 0xA184AC2473B529B2ull},
+	{0xDA3C0F568CC4F3E8ull, 0xC9E5D72D90A2741Full}, {0x8865899617FB1871ull, 0x7E2FA67C7A658893ull},
+	{0xAA7EEBFB9DF9DE8Dull, 0xDDBB901B98FEEAB8ull}, {0xD51EA6FA85785631ull, 0x552A74227F3EA566ull},
+	{0x8533285C936B35DEull, 0xD53A88958F872760ull}, {0xA67FF273B8460356ull, 0x8A892ABAF368F138ull},
+	{0xD01FEF10A657842Cull, 0x2D2B7569B0432D86ull}, {0x8213F56A67F6B29Bull, 0x9C3B29620E29FC74ull},
+	{0xA298F2C501F45F42ull, 0x8349F3BA91B47B90ull}, {0xCB3F2F7642717713ull, 0x241C70A936219A74ull},
+	{0xFE0EFB53D30DD4D7ull, 0xED238CD383AA0111ull}, {0x9EC95D1463E8A506ull, 0xF4363804324A40ABull},
+	{0xC67BB4597CE2CE48ull, 0xB143C6053EDCD0D6ull}, {0xF81AA16FDC1B81DAull, 0xDD94B7868E94050Bull},
+	{0x9B10A4E5E9913128ull, 0xCA7CF2B4191C8327ull}, {0xC1D4CE1F63F57D72ull, 0xFD1C2F611F63A3F1ull},
+	{0xF24A01A73CF2DCCFull, 0xBC633B39673C8CEDull}, {0x976E41088617CA01ull, 0xD5BE0503E085D814ull},
+	{0xBD49D14AA79DBC82ull, 0x4B2D8644D8A74E19ull}, {0xEC9C459D51852BA2ull, 0xDDF8E7D60ED1219Full},
+	{0x93E1AB8252F33B45ull, 0xCABB90E5C942B504ull}, {0xB8DA1662E7B00A17ull, 0x3D6A751F3B936244ull},
+	{0xE7109BFBA19C0C9Dull, 0x0CC512670A783AD5ull}, {0x906A617D450187E2ull, 0x27FB2B80668B24C6ull},
+	{0xB484F9DC9641E9DAull, 0xB1F9F660802DEDF7ull}, {0xE1A63853BBD26451ull, 0x5E7873F8A0396974ull},
+	{0x8D07E33455637EB2ull, 0xDB0B487B6423E1E9ull}, {0xB049DC016ABC5E5Full, 0x91CE1A9A3D2CDA63ull},
+	{0xDC5C5301C56B75F7ull, 0x7641A140CC7810FCull}, {0x89B9B3E11B6329BAull, 0xA9E904C87FCB0A9Eull},
+	{0xAC2820D9623BF429ull, 0x546345FA9FBDCD45ull}, {0xD732290FBACAF133ull, 0xA97C177947AD4096ull},
+	{0x867F59A9D4BED6C0ull, 0x49ED8EABCCCC485Eull}, {0xA81F301449EE8C70ull, 0x5C68F256BFFF5A75ull},
+	{0xD226FC195C6A2F8Cull, 0x73832EEC6FFF3112ull}, {0x83585D8FD9C25DB7ull, 0xC831FD53C5FF7EACull},
+	{0xA42E74F3D032F525ull, 0xBA3E7CA8B77F5E56ull}, {0xCD3A1230C43FB26Full, 0x28CE1BD2E55F35ECull},
+	{0x80444B5E7AA7CF85ull, 0x7980D163CF5B81B4ull}, {0xA0555E361951C366ull, 0xD7E105BCC3326220ull},
+	{0xC86AB5C39FA63440ull, 0x8DD9472BF3FEFAA8ull}, {0xFA856334878FC150ull, 0xB14F98F6F0FEB952ull},
+	{0x9C935E00D4B9D8D2ull, 0x6ED1BF9A569F33D4ull}, {0xC3B8358109E84F07ull, 0x0A862F80EC4700C9ull},
+	{0xF4A642E14C6262C8ull, 0xCD27BB612758C0FBull}, {0x98E7E9CCCFBD7DBDull, 0x8038D51CB897789Dull},
+	{0xBF21E44003ACDD2Cull, 0xE0470A63E6BD56C4ull}, {0xEEEA5D5004981478ull, 0x1858CCFCE06CAC75ull},
+	{0x95527A5202DF0CCBull, 0x0F37801E0C43EBC9ull}, {0xBAA718E68396CFFDull, 0xD30560258F54E6BBull},
+	{0xE950DF20247C83FDull, 0x47C6B82EF32A206Aull}, {0x91D28B7416CDD27Eull, 0x4CDC331D57FA5442ull},
+	{0xB6472E511C81471Dull, 0xE0133FE4ADF8E953ull}, {0xE3D8F9E563A198E5ull, 0x58180FDDD97723A7ull},
+	{0x8E679C2F5E44FF8Full, 0x570F09EAA7EA7649ull}, {0xB201833B35D63F73ull, 0x2CD2CC6551E513DBull},
+	{0xDE81E40A034BCF4Full, 0xF8077F7EA65E58D2ull}, {0x8B112E86420F6191ull, 0xFB04AFAF27FAF783ull},
+	{0xADD57A27D29339F6ull, 0x79C5DB9AF1F9B564ull}, {0xD94AD8B1C7380874ull, 0x18375281AE7822BDull},
+	{0x87CEC76F1C830548ull, 0x8F2293910D0B15B6ull}, {0xA9C2794AE3A3C69Aull, 0xB2EB3875504DDB23ull},
+	{0xD433179D9C8CB841ull, 0x5FA60692A46151ECull}, {0x849FEEC281D7F328ull, 0xDBC7C41BA6BCD334ull},
+	{0xA5C7EA73224DEFF3ull, 0x12B9B522906C0801ull}, {0xCF39E50FEAE16BEFull, 0xD768226B34870A01ull},
+	{0x81842F29F2CCE375ull, 0xE6A1158300D46641ull}, {0xA1E53AF46F801C53ull, 0x60495AE3C1097FD1ull},
+	{0xCA5E89B18B602368ull, 0x385BB19CB14BDFC5ull}, {0xFCF62C1DEE382C42ull, 0x46729E03DD9ED7B6ull},
+	{0x9E19DB92B4E31BA9ull, 0x6C07A2C26A8346D2ull}
+};
+
+/**
+ * @brief Write the digits of an unsigned integer, left-padded with zeros up to minDigits.
+ * @note This is an internal function.
+ */
+static inline int _writer_putDigits(char *str, uint64_t val, int minDigits) {
+	char tmp[24];
+	int i = 0;
+	int j;
+
+	do {
+		tmp[i++] = '0' + (val % 10);
+		val /= 10;
+	} while(val);
+	while(i < minDigits)
+		tmp[i++] = '0';
+
+	for(j = 0; j < i; j++)
+		str[j] = tmp[i - j - 1];
+
+	return i;
+}
+
+/**
+ * @brief Multiply a 128-bit power of ten by cp and keep the upper 64 bits, rounded to odd.
+ * @note This is an internal function.
+ */
+static inline uint64_t _writer_roundToOdd(const uint64_t *g, uint64_t cp) {
+	unsigned __int128 x = (unsigned __int128) g[1] * cp;
+	unsigned __int128 y = (unsigned __int128) g[0] * cp;
+	uint64_t y0 = ((uint64_t) y) + ((uint64_t) (x >> 64));
+	uint64_t y1 = ((uint64_t) (y >> 64)) + (y0 < ((uint64_t) (x >> 64)));
+
+	return y1 | (y0 > 1);
+}
+
+/**
+ * @brief Find the shortest decimal digits d and exponent e such that d * 10^e reads back to a positive finite double
+ *        (closest to it among the shortest, Schubfach algorithm: Giulietti, "The Schubfach way to render doubles").
+ * @param exp Where the decimal exponent e is written.
+ * @return Digits d (at most 17), without trailing zeros.
+ * @note This is an internal function.
+ */
+static uint64_t _writer_shortestDigits(double val, int *exp) {
+	uint64_t bits, c, s, sp, vbl, vb, vbr, lower, upper;
+	int q, k, h;
+	bool even, closer, uIn, wIn;
+	const uint64_t *g;
+
+	memcpy(&bits, &val, sizeof(double));
+	c = bits & ((1ull << 52) - 1);
+	q = (bits >> 52) & 0x7FF;
+
+	/* Value is c * 2^q; its neighbours are halfway to the next doubles (closer below a power of two) */
+	closer = !c && (q > 1);
+	if(q) {
+		c |= 1ull << 52;
+		q -= 1075;
+	}
+	else {
+		q = -1074;
+	}
+	even = !(c & 1);
+
+	/* k = floor(log10(2^q)) (or of 3/4 * 2^q), h = q + floor(log2(10^-k)) + 1, in 1..4 */
+	k = closer? ((q * 1262611 - 524031) >> 22) : ((q * 1262611) >> 22);
+	h = q + (((-k) * 1741647) >> 19) + 1;
+	g = _writer_shortestPow10[-k - MIN_SHORTEST_POW10];
+
+	/* Value and its neighbours scaled by 10^-k, times 4 */
+	vbl = _writer_roundToOdd(g, ((c << 2) - 2 + closer) << h);
+	vb = _writer_roundToOdd(g, (c << 2) << h);
+	vbr = _writer_roundToOdd(g, ((c << 2) + 2) << h);
+	lower = vbl + !even;
+	upper = vbr - !even;
+
+	/* One digit less, if either of its neighbours (but not both) reads back to the value */
+	s = vb >> 2;
+	sp = s / 10;
+	uIn = lower <= (40 * sp);
+	wIn = ((40 * sp) + 40) <= upper;
+	if((s >= 10) && (uIn != wIn)) {
+		s = sp + wIn;
+		k++;
+	}
+	else {
+		/* Otherwise s or s + 1, whichever reads back, else the closest one */
+		uIn = lower <= (4 * s);
+		wIn = ((4 * s) + 4) <= upper;
+		if(uIn != wIn)
+			s += wIn;
+		else
+			s += (vb > ((4 * s) + 2)) || ((vb == ((4 * s) + 2)) && (s & 1));
+	}
+
+	while(s && !(s % 10)) {
+		s /= 10;
+		k++;
+	}
+	*exp = k;
+
+	return s;
+}
+
+/**
+ * @brief Format with the shortest text that reads back to the same double.
+ * @note Decimal exponents from MIN_FIXED_EXP to MAX_FIXED_EXP are written in fixed notation, the others as with %g
+ *       (e.g. 1.5e-07).
+ * @note This is an internal function.
+ */
+static int _writer_formatShortest(char *str, double val) {
+	char digits[24];
+	uint64_t d;
+	int noOfDigits, exp, point, i;
+	int len = 0;
+	double absVal = fabs(val);
+
+	if(!isfinite(val))
+		return snprintf(str, WRITER_MAX_STR_SZ, "%g", val);
+
+	if(signbit(val))
+		str[len++] = '-';
+
+	/* Integral values (the common case for betweenness) are written as they are */
+	if((absVal < MAX_FAST_SCALED) && (floor(absVal) == absVal))
+		return len + _writer_putDigits(&str[len], (uint64_t) absVal, 1);
+
+	d = _writer_shortestDigits(absVal, &exp);
+	noOfDigits = _writer_putDigits(digits, d, 1);
+	/* Value is 0.digits * 10^point */
+	point = noOfDigits + exp;
+
+	if(((point - 1) < MIN_FIXED_EXP) || ((point - 1) > MAX_FIXED_EXP)) {
+		str[len++] = digits[0];
+		if(noOfDigits > 1) {
+			str[len++] = '.';
+			memcpy(&str[len], &digits[1], noOfDigits - 1);
+			len += noOfDigits - 1;
+		}
+		str[len++] = 'e';
+		str[len++] = (point > 0)? '+' : '-';
+		len += _writer_putDigits(&str[len], abs(point - 1), 2);
+	}
+	else if(point <= 0) {
+		str[len++] = '0';
+		str[len++] = '.';
+		for(i = point; i < 0; i++)
+			str[len++] = '0';
+		memcpy(&str[len], digits, noOfDigits);
+		len += noOfDigits;
+	}
+	else if(point >= noOfDigits) {
+		memcpy(&str[len], digits, noOfDigits);
+		len += noOfDigits;
+		for(i = noOfDigits; i < point; i++)
+			str[len++] = '0';
+	}
+	else {
+		memcpy(&str[len], digits, point);
+		len += point;
+		str[len++] = '.';
+		memcpy(&str[len], &digits[point], noOfDigits - point);
+		len += noOfDigits - point;
+	}
+
+	return len;
+}
+
+/**
+ * @brief Format a double as fixed-point text.
+ */
+int writer_format(char *str, double val, int precision) {
+	double absVal, scaled, intPart, frac;
+	uint64_t rounded;
+	int len = 0;
+
+	if(WRITER_PRECISION_SHORTEST == precision)
+		return _writer_formatShortest(str, val);
+
+	if(precision < 0)
+		precision = 0;
+	else if(precision > WRITER_PRECISION_MAX)
+		precision = WRITER_PRECISION_MAX;
+
+	if(!isfinite(val) || (precision > MAX_FAST_PRECISION))
+		return snprintf(str, WRITER_MAX_STR_SZ, "%.*f", precision, val);
+
+	absVal = fabs(val);
+	scaled = absVal * _writer_pow10[precision];
+
+	/* The scaled value carries an error of half an ulp: if it is too close to a tie, let printf decide */
+	intPart = floor(scaled);
+	frac = scaled - intPart;
+	if((scaled >= MAX_FAST_SCALED) || (fabs(frac - 0.5) <= ldexp(scaled, -52)))
+		return snprintf(str, WRITER_MAX_STR_SZ, "%.*f", precision, val);
+	rounded = ((uint64_t) intPart) + (frac > 0.5);
+
+	if(signbit(val))
+		str[len++] = '-';
+	len += _writer_putDigits(&str[len], rounded / _writer_pow10[precision], 1);
+	if(precision) {
+		str[len++] = '.';
+		len += _writer_putDigits(&str[len], rounded % _writer_pow10[precision], precision);
+	}
+
+	return len;
+}
+
+/**
+ * @brief Write columns of values for n nodes to a file.
+ */
+int writer_write(FILE *file, double **columns, unsigned int noOfColumns, unsigned int n, int format, int precision) {
+	unsigned int i, j;
+
+	if(WRITER_FORMAT_BIN == format) {
+		writer_header_t header;
+
+		memcpy(header.magic, WRITER_MAGIC, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		header.version = __builtin_bswap32(WRITER_VERSION);
+		header.n = __builtin_bswap64(n);
+		header.noOfColumns = __builtin_bswap32(noOfColumns);
+#else
+		header.version = WRITER_VERSION;
+		header.n = n;
+		header.noOfColumns = noOfColumns;
+#endif
+		header.reserved = 0;
+		if(fwrite(&header, sizeof(writer_header_t), 1, file) != 1)
+			return -1;
+
+		for(j = 0; j < noOfColumns; j++) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			/* Swap a copy of each value */
+			for(i = 0; i < n; i++) {
+				uint64_t tmp;
+				memcpy(&tmp, &columns[j][i], sizeof(double));
+				tmp = __builtin_bswap64(tmp);
+				if(fwrite(&tmp, sizeof(uint64_t), 1, file) != 1)
+					return -1;
+			}
+#else
+			if(fwrite(columns[j], sizeof(double), n, file) != n)
+				return -1;
+#endif
+		}
+	}
+	else {
+		char *buffer = malloc(BUFFER_SZ);
+		size_t used = 0;
+
+		for(i = 0; i < n; i++) {
+			for(j = 0; j < noOfColumns; j++) {
+				used += writer_format(&buffer[used], columns[j][i], precision);
+				buffer[used++] = ((noOfColumns - 1) == j)? '\n' : ' ';
+
+				/* Flush when a value might not fit anymore */
+				if(used > (BUFFER_SZ - WRITER_MAX_STR_SZ - 1)) {
+					if(fwrite(buffer, 1, used, file) != used) {
+						free(buffer);
+						return -1;
+					}
+					used = 0;
+				}
+			}
+		}
+
+		if(used && (fwrite(buffer, 1, used, file) != used)) {
+			free(buffer);
+			return -1;
+		}
+
+		free(buffer);
+	}
+
+	return 0;
+}